@@ -19,6 +19,10 @@ fi
 # COMPILE
 error=$(mpicc -fopenmp -o PiDecimalsMPI.x sources/common/*.c sources/gmp/*.c sources/gmp/algorithms/*.c sources/mpfr/*.c sources/mpfr/algorithms/*.c -lmpfr -lgmp -lm 2>&1 1>/dev/null)
 
+# COMPILE THE KERNEL BENCHMARK (every source but the main of the program)
+common_sources=$(ls sources/common/*.c | grep -v "sources/common/main.c")
+error+=$(mpicc -fopenmp -o KernelBenchmark.x sources/benchmark/*.c $common_sources sources/gmp/*.c sources/gmp/algorithms/*.c sources/mpfr/*.c sources/mpfr/algorithms/*.c -lmpfr -lgmp -lm 2>&1 1>/dev/null)
+
 # GIVE FEEDBACK ABOUT COMPILATION
 if [[ -z "$error" ]]; then
     echo -n "COMPILATION "
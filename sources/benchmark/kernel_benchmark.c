@@ -0,0 +1,341 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <math.h>
+#include <gmp.h>
+#include <mpfr.h>
+#include <omp.h>
+#include "mpi.h"
+#include "../common/large_buffer.h"
+#include "../gmp/mpi_operations.h"
+#include "../gmp/seeding.h"
+#include "../gmp/radix_conversion.h"
+#include "../gmp/scheduler.h"
+#include "../gmp/algorithms/bbp_blocks_and_cyclic.h"
+#include "../gmp/algorithms/chudnovsky_blocks_and_cyclic.h"
+#include "../mpfr/seeding.h"
+#include "../mpfr/algorithms/bbp_blocks_and_blocks.h"
+#include "../mpfr/algorithms/bellard_blocks_and_cyclic.h"
+#include "../mpfr/algorithms/chudnovsky_blocks_and_blocks.h"
+
+#define MIN_BITS 1024                   // default smallest precision
+#define MAX_BITS 1048576                // default largest precision
+#define BITS_STEP 4                     // ratio between two precisions measured
+#define MEASURE_TIME 0.05               // seconds per kernel and precision
+#define BATCH 8                         // operations between two reads of the clock
+#define TERM 1000                       // term of the series computed by the iterations
+#define MAX_PRECISIONS 32
+
+/*
+ * Runs statement in batches of BATCH times for MEASURE_TIME seconds and stores the
+ * nanoseconds per operation in ns
+ */
+#define TIME_KERNEL(ns, statement) do {                                 \
+        long operations_ = 0;                                           \
+        int batch_;                                                     \
+        double start_ = omp_get_wtime(), elapsed_;                      \
+        do {                                                            \
+            for (batch_ = 0; batch_ < BATCH; batch_++) { statement; }   \
+            operations_ += BATCH;                                       \
+            elapsed_ = omp_get_wtime() - start_;                        \
+        } while (elapsed_ < MEASURE_TIME);                              \
+        (ns) = elapsed_ * 1.e9 / operations_;                           \
+    } while (0)
+
+
+/************************************************************************************
+ * Kernel micro-benchmark                                                           *
+ *                                                                                  *
+ ************************************************************************************
+ * Measures the time of the hot kernels of the algorithms out of the MPI jobs, in   *
+ * one process and one thread, for precisions from min_bits to max_bits (every      *
+ * precision BITS_STEP times the previous one):                                     *
+ *                                                                                  *
+ *   - the BBP, Bellard and Chudnovsky iterations of GMP and MPFR at term TERM      *
+ *   - the update of dep_a of the Chudnovsky algorithms                             *
+ *   - the transport buffers: writing the header and viewing a buffer, packing and  *
+ *     unpacking a P, Q, T triple and the MPI operation add_gmp                     *
+ *   - the decimal conversion of a number of the precision                          *
+ *                                                                                  *
+ * Every kernel reports the nanoseconds per operation at every precision and its    *
+ * scaling exponent: the slope of log(time) against log(bits) between the smallest  *
+ * and the largest precision. The cost model of the non-uniform Chudnovsky          *
+ * scheduler is also fitted at the largest precision, as -calibrate does.           *
+ *                                                                                  *
+ ************************************************************************************/
+
+
+struct kernel {
+    char *name;
+    double (*measure)(mp_bitcnt_t);
+};
+
+
+double bbp_iteration_gmp_ns(mp_bitcnt_t bits){
+    double ns;
+    mpf_t pi, dep_m, quot_a, quot_b, quot_c, quot_d, aux;
+
+    mpf_set_default_prec(bits);
+    mpf_inits(pi, dep_m, quot_a, quot_b, quot_c, quot_d, aux, NULL);
+    seed_bbp_gmp(dep_m, TERM);
+    TIME_KERNEL(ns, bbp_iteration_gmp(pi, TERM, dep_m, quot_a, quot_b, quot_c, quot_d, aux));
+    mpf_clears(pi, dep_m, quot_a, quot_b, quot_c, quot_d, aux, NULL);
+    return ns;
+}
+
+double bbp_iteration_mpfr_ns(mp_bitcnt_t bits){
+    double ns;
+    mpfr_t pi, dep_m, quot_a, quot_b, quot_c, quot_d, aux;
+
+    mpfr_set_default_prec(bits);
+    mpfr_inits2(bits, pi, dep_m, quot_a, quot_b, quot_c, quot_d, aux, NULL);
+    mpfr_set_ui(pi, 0, MPFR_RNDN);
+    seed_bbp_mpfr(dep_m, TERM);
+    TIME_KERNEL(ns, bbp_iteration_mpfr(pi, TERM, dep_m, quot_a, quot_b, quot_c, quot_d, aux));
+    mpfr_clears(pi, dep_m, quot_a, quot_b, quot_c, quot_d, aux, NULL);
+    return ns;
+}
+
+double bellard_iteration_mpfr_ns(mp_bitcnt_t bits){
+    double ns;
+    mpfr_t pi, dep_m, a, b, c, d, e, f, g, aux;
+
+    mpfr_set_default_prec(bits);
+    mpfr_inits2(bits, pi, dep_m, a, b, c, d, e, f, g, aux, NULL);
+    mpfr_set_ui(pi, 0, MPFR_RNDN);
+    seed_bellard_mpfr(dep_m, TERM);
+    TIME_KERNEL(ns, bellard_iteration_mpfr(pi, TERM, dep_m, a, b, c, d, e, f, g, aux, 4 * TERM, 10 * TERM));
+    mpfr_clears(pi, dep_m, a, b, c, d, e, f, g, aux, NULL);
+    return ns;
+}
+
+double chudnovsky_iteration_gmp_ns(mp_bitcnt_t bits){
+    double ns;
+    mpf_t pi, dep_a, dep_b, dep_c, aux;
+
+    mpf_set_default_prec(bits);
+    mpf_inits(pi, dep_a, dep_b, dep_c, aux, NULL);
+    seed_chudnovsky_gmp(dep_a, dep_b, dep_c, TERM);
+    TIME_KERNEL(ns, chudnovsky_iteration_gmp(pi, TERM, dep_a, dep_b, dep_c, aux));
+    mpf_clears(pi, dep_a, dep_b, dep_c, aux, NULL);
+    return ns;
+}
+
+double chudnovsky_iteration_mpfr_ns(mp_bitcnt_t bits){
+    double ns;
+    mpfr_t pi, dep_a, dep_b, dep_c, aux;
+
+    mpfr_set_default_prec(bits);
+    mpfr_inits2(bits, pi, dep_a, dep_b, dep_c, aux, NULL);
+    mpfr_set_ui(pi, 0, MPFR_RNDN);
+    seed_chudnovsky_mpfr(dep_a, dep_b, dep_c, TERM);
+    TIME_KERNEL(ns, chudnovsky_iteration_mpfr(pi, TERM, dep_a, dep_b, dep_c, aux));
+    mpfr_clears(pi, dep_a, dep_b, dep_c, aux, NULL);
+    return ns;
+}
+
+/*
+ * The update of dep_a of the Chudnovsky algorithms, with the term kept at TERM
+ * so every operation works on numbers of the same size
+ */
+double chudnovsky_dep_a_update_gmp_ns(mp_bitcnt_t bits){
+    int factor_a = 12 * TERM;
+    double ns;
+    mpf_t dep_a, dep_b, dep_c, dep_a_dividend, dep_a_divisor, seed;
+
+    mpf_set_default_prec(bits);
+    mpf_inits(dep_a, dep_b, dep_c, dep_a_dividend, dep_a_divisor, seed, NULL);
+    seed_chudnovsky_gmp(seed, dep_b, dep_c, TERM);
+    TIME_KERNEL(ns, {
+        mpf_set(dep_a, seed);
+        mpf_set_ui(dep_a_dividend, factor_a + 10);
+        mpf_mul_ui(dep_a_dividend, dep_a_dividend, factor_a + 6);
+        mpf_mul_ui(dep_a_dividend, dep_a_dividend, factor_a + 2);
+        mpf_mul(dep_a_dividend, dep_a_dividend, dep_a);
+        mpf_set_ui(dep_a_divisor, TERM + 1);
+        mpf_pow_ui(dep_a_divisor, dep_a_divisor, 3);
+        mpf_div(dep_a, dep_a_dividend, dep_a_divisor);
+    });
+    mpf_clears(dep_a, dep_b, dep_c, dep_a_dividend, dep_a_divisor, seed, NULL);
+    return ns;
+}
+
+/*
+ * Fills x with a random number of the default precision between 0 and 1
+ */
+static void random_fraction_gmp(mpf_t x, gmp_randstate_t state){
+    mpf_urandomb(x, state, mpf_get_default_prec());
+}
+
+double transport_view_gmp_ns(mp_bitcnt_t bits){
+    double ns;
+    void *buffer;
+    mpf_t data, view;
+    gmp_randstate_t state;
+
+    mpf_set_default_prec(bits);
+    gmp_randinit_default(state);
+    init_transport_gmp(data);
+    random_fraction_gmp(data, state);
+    TIME_KERNEL(ns, {
+        buffer = transport_buffer_gmp(data);
+        view_transport_gmp(view, buffer);
+    });
+    clear_transport_gmp(data);
+    gmp_randclear(state);
+    return ns;
+}
+
+double pack_unpack_pqt_gmp_ns(mp_bitcnt_t bits){
+    long bytes;
+    double ns;
+    void *buffer;
+    mpz_t P, Q, T, P_unpacked, Q_unpacked, T_unpacked;
+    gmp_randstate_t state;
+
+    gmp_randinit_default(state);
+    mpz_inits(P, Q, T, P_unpacked, Q_unpacked, T_unpacked, NULL);
+    mpz_urandomb(P, state, bits);
+    mpz_urandomb(Q, state, bits);
+    mpz_urandomb(T, state, bits);
+    TIME_KERNEL(ns, {
+        buffer = pack_pqt_gmp(P, Q, T, &bytes);
+        unpack_pqt_gmp(buffer, P_unpacked, Q_unpacked, T_unpacked);
+        free_large_buffer(buffer);
+    });
+    mpz_clears(P, Q, T, P_unpacked, Q_unpacked, T_unpacked, NULL);
+    gmp_randclear(state);
+    return ns;
+}
+
+double add_gmp_ns(mp_bitcnt_t bits){
+    int one = 1;
+    double ns;
+    void *invec, *inoutvec;
+    mpf_t a, b;
+    MPI_Datatype transport_type;
+    gmp_randstate_t state;
+
+    mpf_set_default_prec(bits);
+    gmp_randinit_default(state);
+    init_transport_gmp(a);
+    init_transport_gmp(b);
+    random_fraction_gmp(a, state);
+    random_fraction_gmp(b, state);
+    create_bytes_type(transport_size_gmp(a), &transport_type);
+    invec = transport_buffer_gmp(a);
+    inoutvec = transport_buffer_gmp(b);
+    TIME_KERNEL(ns, add_gmp(invec, inoutvec, &one, &transport_type));
+    MPI_Type_free(&transport_type);
+    clear_transport_gmp(a);
+    clear_transport_gmp(b);
+    gmp_randclear(state);
+    return ns;
+}
+
+double decimal_conversion_gmp_ns(mp_bitcnt_t bits){
+    long num_decimals;
+    double ns;
+    mpf_t x;
+    struct digit_writer writer;
+    gmp_randstate_t state;
+
+    mpf_set_default_prec(bits);
+    gmp_randinit_default(state);
+    mpf_init(x);
+    random_fraction_gmp(x, state);
+    num_decimals = bits * log10(2);
+    writer.fd = -1;
+    writer.reference = NULL;
+    writer.buffer = malloc(num_decimals + 64);
+    TIME_KERNEL(ns, write_decimals_gmp(x, num_decimals, &writer));
+    free(writer.buffer);
+    mpf_clear(x);
+    gmp_randclear(state);
+    return ns;
+}
+
+
+struct kernel kernels[] = {
+    {"bbp_iteration_gmp", bbp_iteration_gmp_ns},
+    {"bbp_iteration_mpfr", bbp_iteration_mpfr_ns},
+    {"bellard_iteration_mpfr", bellard_iteration_mpfr_ns},
+    {"chudnovsky_iteration_gmp", chudnovsky_iteration_gmp_ns},
+    {"chudnovsky_iteration_mpfr", chudnovsky_iteration_mpfr_ns},
+    {"chudnovsky_dep_a_update_gmp", chudnovsky_dep_a_update_gmp_ns},
+    {"transport_view_gmp", transport_view_gmp_ns},
+    {"pack_unpack_pqt_gmp", pack_unpack_pqt_gmp_ns},
+    {"add_gmp", add_gmp_ns},
+    {"decimal_conversion_gmp", decimal_conversion_gmp_ns},
+};
+
+
+int main(int argc, char **argv){
+    int num_kernels, num_precisions, k, p, i;
+    long min_bits, max_bits, bits;
+    bool csv = false;
+    double ns[MAX_PRECISIONS], slope;
+    long precisions[MAX_PRECISIONS];
+    struct cost_model_gmp model;
+
+    MPI_Init(&argc, &argv);
+
+    //Take the range of precisions from params
+    min_bits = MIN_BITS;
+    max_bits = MAX_BITS;
+    for (i = 1, k = 0; i < argc; i++) {
+        if (strcmp(argv[i], "-csv") == 0) csv = true;
+        else if (k == 0 && atol(argv[i]) > 0) { min_bits = atol(argv[i]); k++; }
+        else if (k == 1 && atol(argv[i]) > 0) { max_bits = atol(argv[i]); k++; }
+        else {
+            printf("  Params are not correct. Try with:\n");
+            printf("    %s [min_bits] [max_bits] [-csv] \n\n", argv[0]);
+            MPI_Finalize();
+            exit(-1);
+        }
+    }
+    if (max_bits < min_bits) max_bits = min_bits;
+
+    num_precisions = 0;
+    for (bits = min_bits; bits <= max_bits && num_precisions < MAX_PRECISIONS; bits *= BITS_STEP) {
+        precisions[num_precisions++] = bits;
+    }
+    num_kernels = sizeof(kernels) / sizeof(struct kernel);
+    omp_set_num_threads(1);
+
+    if (!csv) {
+        printf("  %-28s", "Kernel (ns per operation)");
+        for (p = 0; p < num_precisions; p++) printf(" %12ld", precisions[p]);
+        printf("   exponent \n");
+    }
+    for (k = 0; k < num_kernels; k++) {
+        for (p = 0; p < num_precisions; p++) {
+            ns[p] = kernels[k].measure(precisions[p]);
+        }
+        slope = (num_precisions > 1) ? log(ns[num_precisions - 1] / ns[0]) / log((double) precisions[num_precisions - 1] / precisions[0]) : 0;
+        if (csv) {
+            for (p = 0; p < num_precisions; p++) printf("KERNEL;%s;%ld;%f;\n", kernels[k].name, precisions[p], ns[p]);
+            printf("KERNEL-EXPONENT;%s;%f;\n", kernels[k].name, slope);
+        } else {
+            printf("  %-28s", kernels[k].name);
+            for (p = 0; p < num_precisions; p++) printf(" %12.1f", ns[p]);
+            printf("   %8.3f \n", slope);
+        }
+        fflush(stdout);
+    }
+
+    //Cost model of the scheduler fitted at the largest precision
+    mpf_set_default_prec(precisions[num_precisions - 1]);
+    init_cost_model_gmp(&model);
+    calibrate_cost_model_gmp(MPI_COMM_WORLD, &model, 0);
+    if (csv) {
+        printf("COST-MODEL;%ld;%f;%f;%f;\n", precisions[num_precisions - 1], model.fixed, model.scale, model.exponent);
+    } else {
+        printf("\n  Cost model of the scheduler at %ld bits: fixed %f, scale %f, exponent %f \n\n",
+                precisions[num_precisions - 1], model.fixed, model.scale, model.exponent);
+    }
+
+    MPI_Finalize();
+    exit(0);
+}
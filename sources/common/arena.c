@@ -0,0 +1,126 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <gmp.h>
+#include "arena.h"
+
+#define HEADER_SIZE 16                  // keeps the 16 bytes alignment of malloc
+#define MIN_CLASS 5                     // smallest block: 2^5 bytes
+#define NUM_CLASSES 24                  // largest cached block: 2^28 bytes
+#define CACHED_BLOCKS 64                // free blocks kept per class and thread
+#define LARGE_BLOCK NUM_CLASSES         // class of the blocks that are not cached
+
+
+/************************************************************************************
+ * Per-thread pool allocator for the GMP and MPFR numbers                           *
+ *                                                                                  *
+ ************************************************************************************
+ * The limbs of the numbers are allocated in blocks of 2^c bytes. The class c is    *
+ * stored in a header before the block. Every thread keeps a free list per class,   *
+ * so the numbers created and cleared in every parallel region and in every         *
+ * reduction reuse the blocks of the previous ones without calling malloc, and      *
+ * without any lock.                                                                *
+ *                                                                                  *
+ * A block freed by another thread is kept by that thread. At most CACHED_BLOCKS    *
+ * blocks are kept per class and thread, the rest are returned to malloc, so the    *
+ * memory used stays steady. Blocks above 2^(MIN_CLASS + NUM_CLASSES - 1) bytes go  *
+ * directly to malloc.                                                              *
+ *                                                                                  *
+ * MPFR allocates through the GMP memory functions, so it uses the pools too.       *
+ *                                                                                  *
+ ************************************************************************************/
+
+
+struct free_block {
+    struct free_block *next;
+};
+
+struct thread_pool {
+    struct free_block *free_lists[NUM_CLASSES];
+    int num_free[NUM_CLASSES];
+};
+
+static __thread struct thread_pool pool;
+
+
+/*
+ * Class of the blocks that can hold size bytes plus the header
+ */
+static int block_class(size_t size){
+    int c;
+
+    size += HEADER_SIZE - 1;
+    if (size >> (MIN_CLASS + NUM_CLASSES - 1)) return LARGE_BLOCK;
+    c = (size >> MIN_CLASS) ? (int) (sizeof(unsigned long) * 8) - __builtin_clzl(size) - MIN_CLASS : 0;
+    return c;
+}
+
+static void out_of_memory(size_t size){
+    printf("  Not enough memory to allocate %zu bytes \n", size);
+    exit(-1);
+}
+
+void * arena_allocate(size_t size){
+    int c;
+    char *block;
+
+    c = block_class(size);
+    if (c != LARGE_BLOCK && pool.free_lists[c] != NULL) {
+        block = (char *) pool.free_lists[c];
+        pool.free_lists[c] = pool.free_lists[c] -> next;
+        pool.num_free[c]--;
+        return block;
+    }
+
+    block = malloc((c == LARGE_BLOCK) ? size + HEADER_SIZE : (size_t) 1 << (c + MIN_CLASS));
+    if (block == NULL) out_of_memory(size);
+    *((int *) block) = c;
+    return block + HEADER_SIZE;
+}
+
+void arena_free(void *ptr, size_t size){
+    int c;
+    struct free_block *block;
+
+    (void) size;                                        // the size class is kept in the header
+
+    c = *((int *) ((char *) ptr - HEADER_SIZE));
+    if (c == LARGE_BLOCK || pool.num_free[c] >= CACHED_BLOCKS) {
+        free((char *) ptr - HEADER_SIZE);
+        return;
+    }
+    block = (struct free_block *) ptr;
+    block -> next = pool.free_lists[c];
+    pool.free_lists[c] = block;
+    pool.num_free[c]++;
+}
+
+void * arena_reallocate(void *ptr, size_t old_size, size_t new_size){
+    int c;
+    char *block;
+    void *new_ptr;
+
+    c = *((int *) ((char *) ptr - HEADER_SIZE));
+    if (c == LARGE_BLOCK && block_class(new_size) == LARGE_BLOCK) {
+        block = realloc((char *) ptr - HEADER_SIZE, new_size + HEADER_SIZE);
+        if (block == NULL) out_of_memory(new_size);
+        return block + HEADER_SIZE;
+    }
+
+    //The block is kept if the new size is in the same class
+    if (c != LARGE_BLOCK && block_class(new_size) == c) return ptr;
+
+    new_ptr = arena_allocate(new_size);
+    memcpy(new_ptr, ptr, (old_size < new_size) ? old_size : new_size);
+    arena_free(ptr, old_size);
+    return new_ptr;
+}
+
+/*
+ * Makes GMP (and MPFR) allocate through the thread pools.
+ * IMPORTANT: it should be called before any GMP or MPFR number is created.
+ */
+void install_arena_allocator(){
+    mp_set_memory_functions(arena_allocate, arena_reallocate, arena_free);
+}
+
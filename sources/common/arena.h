@@ -0,0 +1,12 @@
+#ifndef ARENA
+#define ARENA
+
+#include <stddef.h>
+
+void * arena_allocate(size_t);
+void * arena_reallocate(void *, size_t, size_t);
+void arena_free(void *, size_t);
+void install_arena_allocator();
+
+#endif
+
@@ -0,0 +1,29 @@
+#ifndef BACKEND
+#define BACKEND
+
+#include <stdbool.h>
+#include "mpi.h"
+#include "planner.h"
+#include "dynamic_scheduler.h"
+
+/*
+ * Operations of a multiple precision library used by the schedules of
+ * common/chudnovsky_schedules.c and common/dynamic_schedules.c. The numbers
+ * are pointers to the numbers of the library (mpf_ptr, mpfr_ptr).
+ */
+struct backend {
+    char *library;
+    void * (*init_number)(long, bool);                          // 0 with precision bits, in a transport buffer if true
+    void (*clear_number)(void *, bool);
+    void (*reduce_threads)(void *, void *);                     // process sum += thread sum
+    void (*reduce_processes)(MPI_Comm, void *, void *, int);    // pi = sum of the process sums in process 0
+    void (*div_ui)(void *, void *, unsigned long);              // x = y / n
+    void (*chudnovsky_terms)(void *, long, long, long, long);   // sum += terms start, start + step, ... < end
+    void * (*start_chudnovsky_constant)(long);                  // starts 426880 sqrt(10005) in background
+    void (*finish_chudnovsky)(void *, void *, int);             // pi = constant / pi
+    void (*dynamic_terms)(enum series, void *, struct dynamic_scheduler *, int, long);  // sum += terms of the chunks of a thread
+    long * (*chudnovsky_schedule)(MPI_Comm, long, int, double *, int, long);    // ranges with the cost of their weights (see gmp/scheduler.c)
+};
+
+#endif
+
@@ -0,0 +1,289 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <omp.h>
+#include "options.h"
+#include "checkpoint.h"
+
+#define CHECKPOINT_MAGIC 0x5049434b50543032L    // "PICKPT02"
+
+
+/************************************************************************************
+ * Checkpoints of the partial sums of the threads                                   *
+ *                                                                                  *
+ ************************************************************************************
+ * The dependencies of every series (dep_a, dep_b, dep_c, dep_m) can be seeded at   *
+ * any iteration (see seeding.c), so the state of a thread is only its partial sum  *
+ * and its next iteration. Every thread of every process saves its state in its     *
+ * own file of the checkpoint directory, pi_<process>_<thread>.ckpt, with a header  *
+ * that identifies the algorithm, the precision and the layout of the run.          *
+ *                                                                                  *
+ * The compute threads only copy their state in a queue. One writer thread per      *
+ * process writes the queue in the background: every file is written to a           *
+ * temporary file, synced and renamed, so the file of a thread is always its last   *
+ * complete state and the states of the threads are independent until their sums    *
+ * are reduced. The queue keeps at most one state per thread: a newer state of a    *
+ * thread that is still queued replaces the older one, so a slow disk skips         *
+ * checkpoints instead of filling the memory. A run started with -resume takes the  *
+ * files whose header matches and continues every thread from its saved iteration.  *
+ * Once pi has been reduced and checked the files of the run are removed, so a      *
+ * later -resume in the same directory computes pi again.                           *
+ *                                                                                  *
+ ************************************************************************************/
+
+
+struct checkpoint_header {
+    long magic;
+    char algorithm[32];
+    int num_procs;
+    int num_threads;
+    long num_iterations;
+    long next_iteration;
+    long precision;
+    size_t state_size;
+};
+
+struct checkpoint_job {
+    char path[4096];
+    struct checkpoint_header header;
+    void *state;
+    struct checkpoint_job *next;
+};
+
+static pthread_mutex_t queue_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t queue_changed = PTHREAD_COND_INITIALIZER;
+static struct checkpoint_job *queue_first = NULL, *queue_last = NULL;
+static bool writer_running = false, writer_stop = false;
+static pthread_t writer;
+
+static struct checkpoint run_checkpoint;                // identity of the checkpoints of the last run
+static int run_proc_id;
+static bool run_checkpointed = false;
+
+
+/*
+ * Writes the job in its file through a temporary file
+ */
+static void write_checkpoint_job(struct checkpoint_job *job){
+    char temporary_path[4112];
+    FILE *file;
+    bool written;
+
+    sprintf(temporary_path, "%s.tmp", job -> path);
+    file = fopen(temporary_path, "wb");
+    if (file == NULL) {
+        printf("  The checkpoint %s can not be written \n", temporary_path);
+        return;
+    }
+    written = fwrite(&job -> header, sizeof(struct checkpoint_header), 1, file) == 1
+                && fwrite(job -> state, 1, job -> header.state_size, file) == job -> header.state_size;
+    written = fflush(file) == 0 && fsync(fileno(file)) == 0 && written;
+    fclose(file);
+    if (!written || rename(temporary_path, job -> path) != 0) {
+        printf("  The checkpoint %s can not be written \n", job -> path);
+    }
+}
+
+/*
+ * Writer thread: writes the jobs of the queue until finish_checkpoints is called
+ */
+static void * checkpoint_writer(void *arg){
+    struct checkpoint_job *job;
+
+    (void) arg;
+
+    pthread_mutex_lock(&queue_lock);
+    while (true) {
+        while (queue_first == NULL && !writer_stop) pthread_cond_wait(&queue_changed, &queue_lock);
+        if (queue_first == NULL) break;
+        job = queue_first;
+        queue_first = job -> next;
+        if (queue_first == NULL) queue_last = NULL;
+
+        pthread_mutex_unlock(&queue_lock);
+        write_checkpoint_job(job);
+        free(job -> state);
+        free(job);
+        pthread_mutex_lock(&queue_lock);
+    }
+    pthread_mutex_unlock(&queue_lock);
+
+    return NULL;
+}
+
+/*
+ * Path of the checkpoint of the thread thread_id of the process proc_id
+ */
+static void checkpoint_path(char *path, size_t size, int proc_id, int thread_id){
+    snprintf(path, size, "%s/pi_%d_%d.ckpt", (options.checkpoint_dir != NULL) ? options.checkpoint_dir : ".", proc_id, thread_id);
+}
+
+/*
+ * Reads the header of file and returns true if it is a checkpoint of the run of checkpoint
+ */
+static bool read_checkpoint_header(FILE *file, struct checkpoint *checkpoint, struct checkpoint_header *header){
+    return fread(header, sizeof(struct checkpoint_header), 1, file) == 1 
+            && header -> magic == CHECKPOINT_MAGIC
+            && strncmp(header -> algorithm, checkpoint -> algorithm, sizeof(header -> algorithm)) == 0
+            && header -> num_procs == checkpoint -> num_procs
+            && header -> num_threads == checkpoint -> num_threads
+            && header -> num_iterations == checkpoint -> num_iterations
+            && header -> precision == checkpoint -> precision;
+}
+
+/*
+ * Inits the checkpoint of the thread thread_id of the process proc_id for the algorithm
+ * computed with num_iterations and precision bits
+ */
+void init_checkpoint(struct checkpoint *checkpoint, char *algorithm, int num_procs, int proc_id, 
+                    int num_threads, int thread_id, long num_iterations, long precision){
+    checkpoint_path(checkpoint -> path, sizeof(checkpoint -> path), proc_id, thread_id);
+    memset(checkpoint -> algorithm, 0, sizeof(checkpoint -> algorithm));
+    strncpy(checkpoint -> algorithm, algorithm, sizeof(checkpoint -> algorithm) - 1);
+    checkpoint -> num_procs = num_procs;
+    checkpoint -> num_threads = num_threads;
+    checkpoint -> num_iterations = num_iterations;
+    checkpoint -> precision = precision;
+    checkpoint -> last_save = omp_get_wtime();
+
+    pthread_mutex_lock(&queue_lock);
+    run_checkpoint = *checkpoint;
+    run_proc_id = proc_id;
+    run_checkpointed = true;
+    pthread_mutex_unlock(&queue_lock);
+}
+
+/*
+ * Returns true if checkpoints are enabled and the last one was saved
+ * options.checkpoint_interval seconds ago
+ */
+bool checkpoint_due(struct checkpoint *checkpoint){
+    return options.checkpoint_dir != NULL 
+            && omp_get_wtime() - checkpoint -> last_save >= options.checkpoint_interval;
+}
+
+/*
+ * Queues a copy of the state (size bytes) of the thread, that continues at next_iteration.
+ * The state is written in the background, and replaces the state of the thread that is
+ * still queued, if any.
+ */
+void save_checkpoint(struct checkpoint *checkpoint, long next_iteration, void *state, size_t size){
+    struct checkpoint_job *job, *queued;
+
+    job = malloc(sizeof(struct checkpoint_job));
+    strcpy(job -> path, checkpoint -> path);
+    memset(&job -> header, 0, sizeof(struct checkpoint_header));
+    job -> header.magic = CHECKPOINT_MAGIC;
+    memcpy(job -> header.algorithm, checkpoint -> algorithm, sizeof(job -> header.algorithm));
+    job -> header.num_procs = checkpoint -> num_procs;
+    job -> header.num_threads = checkpoint -> num_threads;
+    job -> header.num_iterations = checkpoint -> num_iterations;
+    job -> header.next_iteration = next_iteration;
+    job -> header.precision = checkpoint -> precision;
+    job -> header.state_size = size;
+    job -> state = malloc(size);
+    memcpy(job -> state, state, size);
+    job -> next = NULL;
+
+    pthread_mutex_lock(&queue_lock);
+    if (!writer_running) {
+        writer_stop = false;
+        writer_running = pthread_create(&writer, NULL, checkpoint_writer, NULL) == 0;
+    }
+    for (queued = queue_first; queued != NULL && strcmp(queued -> path, job -> path) != 0; queued = queued -> next);
+    if (queued != NULL) {
+        free(queued -> state);
+        queued -> header = job -> header;
+        queued -> state = job -> state;
+        free(job);
+    } else {
+        if (queue_last != NULL) queue_last -> next = job;
+        else queue_first = job;
+        queue_last = job;
+        pthread_cond_signal(&queue_changed);
+    }
+    pthread_mutex_unlock(&queue_lock);
+
+    checkpoint -> last_save = omp_get_wtime();
+}
+
+/*
+ * Reads the saved state of the thread if the run is resumed and the header of its file
+ * matches the run. It returns the state (it should be freed by the caller) and sets
+ * next_iteration and size, or returns NULL.
+ */
+void * load_checkpoint(struct checkpoint *checkpoint, long *next_iteration, size_t *size){
+    FILE *file;
+    void *state;
+    struct checkpoint_header header;
+
+    if (!options.resume) return NULL;
+    file = fopen(checkpoint -> path, "rb");
+    if (file == NULL) return NULL;
+
+    state = NULL;
+    if (read_checkpoint_header(file, checkpoint, &header)) {
+        state = malloc(header.state_size);
+        if (fread(state, 1, header.state_size, file) == header.state_size) {
+            *next_iteration = header.next_iteration;
+            *size = header.state_size;
+        } else {
+            free(state);
+            state = NULL;
+        }
+    }
+    fclose(file);
+
+    return state;
+}
+
+/*
+ * Waits until every queued checkpoint is written and stops the writer thread
+ */
+void finish_checkpoints(){
+    pthread_mutex_lock(&queue_lock);
+    if (!writer_running) {
+        pthread_mutex_unlock(&queue_lock);
+        return;
+    }
+    writer_stop = true;
+    pthread_cond_signal(&queue_changed);
+    pthread_mutex_unlock(&queue_lock);
+
+    pthread_join(writer, NULL);
+    writer_running = false;
+}
+
+/*
+ * Waits until every queued checkpoint is written and removes the checkpoints of the
+ * threads of the last run of the process, once its pi has been reduced and checked.
+ * The files of other runs in the directory are kept.
+ */
+void remove_checkpoints(){
+    int thread_id;
+    char path[4096], temporary_path[4112];
+    bool matches;
+    FILE *file;
+    struct checkpoint_header header;
+
+    finish_checkpoints();
+    if (options.checkpoint_dir == NULL || !run_checkpointed) return;
+
+    for (thread_id = 0; thread_id < run_checkpoint.num_threads; thread_id++) {
+        checkpoint_path(path, sizeof(path), run_proc_id, thread_id);
+        file = fopen(path, "rb");
+        if (file == NULL) continue;
+        matches = read_checkpoint_header(file, &run_checkpoint, &header);
+        fclose(file);
+        if (matches) {
+            unlink(path);
+            snprintf(temporary_path, sizeof(temporary_path), "%s.tmp", path);
+            unlink(temporary_path);
+        }
+    }
+    run_checkpointed = false;
+}
+
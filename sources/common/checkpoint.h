@@ -0,0 +1,25 @@
+#ifndef CHECKPOINT
+#define CHECKPOINT
+
+#include <stdbool.h>
+#include <stddef.h>
+
+struct checkpoint {
+    char path[4096];
+    char algorithm[32];
+    int num_procs;
+    int num_threads;
+    long num_iterations;
+    long precision;
+    double last_save;
+};
+
+void init_checkpoint(struct checkpoint *, char *, int, int, int, int, long, long);
+bool checkpoint_due(struct checkpoint *);
+void save_checkpoint(struct checkpoint *, long, void *, size_t);
+void * load_checkpoint(struct checkpoint *, long *, size_t *);
+void finish_checkpoints();
+void remove_checkpoints();
+
+#endif
+
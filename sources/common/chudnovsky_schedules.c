@@ -0,0 +1,295 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <omp.h>
+#include "mpi.h"
+#include "options.h"
+#include "progress.h"
+#include "backend.h"
+#include "chudnovsky_schedules.h"
+
+#define PROBE_SECONDS 0.05              // minimum time of the probe of every thread
+
+
+/************************************************************************************
+ * Schedules of the Chudnovsky formula for every library                            *
+ *                                                                                  *
+ ************************************************************************************
+ * Chudnovsky formula:                                                              *
+ *     426880 sqrt(10005)                 (6n)! (545140134n + 13591409)             *
+ *    --------------------  = SUMMATORY( ----------------------------- ),  n >=0    *
+ *            pi                            (n!)^3 (3n)! (-640320)^3n               *
+ *                                                                                  *
+ ************************************************************************************
+ * The schedules only decide which terms every thread of every process adds. The    *
+ * terms, the reductions and the last division are operations of the backend of     *
+ * the library (gmp/backend.c, mpfr/backend.c), so every schedule runs with every   *
+ * library and a new library only has to implement struct backend:                  *
+ *                                                                                  *
+ *   snake-like and blocks: the iterations are split in 2P blocks and the process   *
+ *      p computes the blocks p and P + p, so every process has a block of the      *
+ *      first half and one of the second half. The threads split every block in     *
+ *      contiguous pieces.                                                          *
+ *                                                                                  *
+ *   non-uniform and blocks: every thread of every process takes a contiguous       *
+ *      range with the same cost according to the cost model of gmp/scheduler.c.    *
+ *                                                                                  *
+ *   blocks and cyclic: every process takes a contiguous block and its threads      *
+ *      take its terms cyclically, jumping the dependencies num_threads terms.      *
+ *                                                                                  *
+ ************************************************************************************
+ * Weighted processes (-weighted)                                                   *
+ *                                                                                  *
+ * Before the schedule, every process times its own threads adding terms from the   *
+ * middle of the series at the target precision, and the terms per second and the   *
+ * threads of every process are gathered in all of them. The blocks of the          *
+ * processes (and of their threads in the non-uniform schedule, which get the       *
+ * throughput of their process divided by its threads) are then ranges with a cost  *
+ * of the cost model proportional to their throughput, instead of the same number   *
+ * of terms. So the processes of faster nodes, or with more threads, take more      *
+ * terms and all of them finish at the same time. The processes may be started      *
+ * with different numbers of threads (with the MPMD syntax of mpirun).              *
+ *                                                                                  *
+ ************************************************************************************/
+
+
+/*
+ * Terms per second of the num_threads threads of the process working at the same time,
+ * measured adding terms of the middle of the series at precision_bits
+ */
+static double probe_chudnovsky_throughput(struct backend *backend, long num_iterations, int num_threads, long precision_bits){
+    long probed_terms = 0;
+    double start, elapsed;
+
+    start = MPI_Wtime();
+    #pragma omp parallel num_threads(num_threads) reduction(+:probed_terms)
+    {
+        long terms, thread_terms;
+        double thread_start;
+        void *probe_sum;
+
+        probe_sum = backend -> init_number(precision_bits, false);
+        thread_start = MPI_Wtime();
+        thread_terms = 0;
+        for (terms = 1; thread_terms == 0 || MPI_Wtime() - thread_start < PROBE_SECONDS; terms *= 2) {
+            backend -> chudnovsky_terms(probe_sum, num_iterations / 2, num_iterations / 2 + terms, 1, precision_bits);
+            thread_terms += terms;
+        }
+        add_progress(-thread_terms);                    // the probe is not progress of the run
+        backend -> clear_number(probe_sum, false);
+        probed_terms += thread_terms;
+    }
+    elapsed = MPI_Wtime() - start;
+
+    return probed_terms / elapsed;
+}
+
+/*
+ * Probes the throughput of the process and gathers the throughput and the number of
+ * threads of every process in throughputs and threads (arrays of num_procs elements)
+ */
+static void gather_throughputs(struct backend *backend, MPI_Comm comm, int num_procs, long num_iterations, int num_threads,
+                               long precision_bits, double *throughputs, int *threads){
+    double local[2], *all;
+    int proc;
+
+    local[0] = probe_chudnovsky_throughput(backend, num_iterations, num_threads, precision_bits);
+    local[1] = num_threads;
+    all = malloc(2 * num_procs * sizeof(double));
+    MPI_Allgather(local, 2, MPI_DOUBLE, all, 2, MPI_DOUBLE, comm);
+    for (proc = 0; proc < num_procs; proc++) {
+        throughputs[proc] = all[2 * proc];
+        threads[proc] = (int) all[2 * proc + 1];
+    }
+    free(all);
+}
+
+/*
+ * Adds the terms [block_start, block_end) split in contiguous pieces among the threads
+ */
+static void chudnovsky_snake_like_phase(struct backend *backend, void *local_proc_pi, int num_threads, long block_size,
+                                        long block_start, long block_end, long precision_bits){
+    int thread_id;
+    long thread_block_size, thread_block_start, thread_block_end;
+    void *local_thread_pi;
+
+    thread_id = omp_get_thread_num();
+    thread_block_size = (block_size + num_threads - 1) / num_threads;
+    thread_block_start = (thread_id * thread_block_size) + block_start;
+    thread_block_end = thread_block_start + thread_block_size;
+    if (thread_block_end > block_end) thread_block_end = block_end;
+
+    local_thread_pi = backend -> init_number(precision_bits, false);      // private thread pi
+    backend -> chudnovsky_terms(local_thread_pi, thread_block_start, thread_block_end, 1, precision_bits);
+    backend -> reduce_threads(local_proc_pi, local_thread_pi);
+    backend -> clear_number(local_thread_pi, false);
+}
+
+void chudnovsky_snake_like_and_blocks_algorithm(struct backend *backend, MPI_Comm comm, int num_procs, int proc_id, void *pi,
+                                                long num_iterations, int num_threads, long precision_bits){
+    long block_size, first_block_start, first_block_end, second_block_start, second_block_end, *schedule;
+    long first_block_size, second_block_size;
+    double *throughputs, *weights;
+    int *threads, proc;
+    void *local_proc_pi, *constant = NULL;
+
+    if (options.weighted) {
+        //The block p of every half has the weight of the process p
+        throughputs = malloc(num_procs * sizeof(double));
+        threads = malloc(num_procs * sizeof(int));
+        weights = malloc(2 * num_procs * sizeof(double));
+        gather_throughputs(backend, comm, num_procs, num_iterations, num_threads, precision_bits, throughputs, threads);
+        for (proc = 0; proc < 2 * num_procs; proc++) weights[proc] = throughputs[proc % num_procs];
+        schedule = backend -> chudnovsky_schedule(comm, num_iterations, 2 * num_procs, weights, proc_id, precision_bits);
+        first_block_start = schedule[proc_id];
+        first_block_end = schedule[proc_id + 1];
+        second_block_start = schedule[num_procs + proc_id];
+        second_block_end = schedule[num_procs + proc_id + 1];
+        free(schedule);
+        free(weights);
+        free(threads);
+        free(throughputs);
+        first_block_size = first_block_end - first_block_start;
+        second_block_size = second_block_end - second_block_start;
+    } else {
+        block_size = (num_iterations + (num_procs * 2) - 1) / (num_procs * 2);
+        first_block_start = proc_id * block_size;
+        first_block_end = first_block_start + block_size;
+        if (first_block_end > num_iterations) first_block_end = num_iterations;
+        second_block_start = (proc_id + num_procs) * block_size;
+        second_block_end = second_block_start + block_size;
+        if (second_block_end > num_iterations) second_block_end = num_iterations;
+        first_block_size = second_block_size = block_size;
+    }
+
+    local_proc_pi = backend -> init_number(precision_bits, true);
+    if (proc_id == 0) constant = backend -> start_chudnovsky_constant(precision_bits);   // e = D sqrt(E) in parallel
+
+    //Set the number of threads
+    omp_set_num_threads(num_threads);
+
+    //Compute the first block of iterations and then the second
+    #pragma omp parallel
+    {
+        chudnovsky_snake_like_phase(backend, local_proc_pi, num_threads, first_block_size, first_block_start, first_block_end, precision_bits);
+        chudnovsky_snake_like_phase(backend, local_proc_pi, num_threads, second_block_size, second_block_start, second_block_end, precision_bits);
+    }
+
+    //Reduce local_proc_pi in global Pi and do the last operations to get Pi
+    backend -> reduce_processes(comm, pi, local_proc_pi, proc_id);
+    if (proc_id == 0) backend -> finish_chudnovsky(pi, constant, num_threads);
+
+    backend -> clear_number(local_proc_pi, true);
+}
+
+/*
+ * The iterations are distributed in contiguous blocks with the same cost among all the
+ * threads of all the processes. The cost of every iteration comes from the cost model
+ * of gmp/scheduler.c, which may be calibrated in the local hardware with the -calibrate option.
+ */
+void chudnovsky_non_uniform_and_blocks_algorithm(struct backend *backend, MPI_Comm comm, int num_procs, int proc_id, void *pi,
+                                                 long num_iterations, int num_threads, long precision_bits){
+    long *schedule;
+    double *throughputs, *weights = NULL;
+    int *threads, proc, thread, num_workers, first_worker;
+    void *local_proc_pi, *constant = NULL;
+
+    //Compute the blocks of every thread of every process
+    num_workers = num_procs * num_threads;
+    first_worker = proc_id * num_threads;
+    if (options.weighted) {
+        //Every thread has the throughput of its process divided by its threads
+        throughputs = malloc(num_procs * sizeof(double));
+        threads = malloc(num_procs * sizeof(int));
+        gather_throughputs(backend, comm, num_procs, num_iterations, num_threads, precision_bits, throughputs, threads);
+        num_workers = 0;
+        for (proc = 0; proc < num_procs; proc++) {
+            if (proc == proc_id) first_worker = num_workers;
+            num_workers += threads[proc];
+        }
+        weights = malloc(num_workers * sizeof(double));
+        num_workers = 0;
+        for (proc = 0; proc < num_procs; proc++) {
+            for (thread = 0; thread < threads[proc]; thread++) weights[num_workers++] = throughputs[proc] / threads[proc];
+        }
+        free(threads);
+        free(throughputs);
+    }
+    schedule = backend -> chudnovsky_schedule(comm, num_iterations, num_workers, weights, proc_id, precision_bits);
+    free(weights);
+
+    local_proc_pi = backend -> init_number(precision_bits, true);
+    if (proc_id == 0) constant = backend -> start_chudnovsky_constant(precision_bits);   // e = D sqrt(E) in parallel
+
+    //Set the number of threads
+    omp_set_num_threads(num_threads);
+
+    #pragma omp parallel
+    {
+        int thread_id;
+        void *local_thread_pi;
+
+        thread_id = omp_get_thread_num();
+        local_thread_pi = backend -> init_number(precision_bits, false);      // private thread pi
+        backend -> chudnovsky_terms(local_thread_pi, schedule[first_worker + thread_id],
+                                    schedule[first_worker + thread_id + 1], 1, precision_bits);
+        backend -> reduce_threads(local_proc_pi, local_thread_pi);
+        backend -> clear_number(local_thread_pi, false);
+    }
+
+    //Reduce local_proc_pi in global Pi and do the last operations to get Pi
+    backend -> reduce_processes(comm, pi, local_proc_pi, proc_id);
+    if (proc_id == 0) backend -> finish_chudnovsky(pi, constant, num_threads);
+
+    backend -> clear_number(local_proc_pi, true);
+    free(schedule);
+}
+
+void chudnovsky_blocks_and_cyclic_algorithm(struct backend *backend, MPI_Comm comm, int num_procs, int proc_id, void *pi,
+                                            long num_iterations, int num_threads, long precision_bits){
+    long block_size, block_start, block_end, *schedule;
+    double *throughputs;
+    int *threads;
+    void *local_proc_pi, *constant = NULL;
+
+    if (options.weighted) {
+        throughputs = malloc(num_procs * sizeof(double));
+        threads = malloc(num_procs * sizeof(int));
+        gather_throughputs(backend, comm, num_procs, num_iterations, num_threads, precision_bits, throughputs, threads);
+        schedule = backend -> chudnovsky_schedule(comm, num_iterations, num_procs, throughputs, proc_id, precision_bits);
+        block_start = schedule[proc_id];
+        block_end = schedule[proc_id + 1];
+        free(schedule);
+        free(threads);
+        free(throughputs);
+    } else {
+        block_size = (num_iterations + num_procs - 1) / num_procs;
+        block_start = proc_id * block_size;
+        block_end = block_start + block_size;
+        if (block_end > num_iterations) block_end = num_iterations;
+    }
+
+    local_proc_pi = backend -> init_number(precision_bits, true);
+    if (proc_id == 0) constant = backend -> start_chudnovsky_constant(precision_bits);   // e = D sqrt(E) in parallel
+
+    //Set the number of threads
+    omp_set_num_threads(num_threads);
+
+    #pragma omp parallel
+    {
+        int thread_id;
+        void *local_thread_pi;
+
+        thread_id = omp_get_thread_num();
+        local_thread_pi = backend -> init_number(precision_bits, false);      // private thread pi
+        backend -> chudnovsky_terms(local_thread_pi, block_start + thread_id, block_end, num_threads, precision_bits);
+        backend -> reduce_threads(local_proc_pi, local_thread_pi);
+        backend -> clear_number(local_thread_pi, false);
+    }
+
+    //Reduce local_proc_pi in global Pi and do the last operations to get Pi
+    backend -> reduce_processes(comm, pi, local_proc_pi, proc_id);
+    if (proc_id == 0) backend -> finish_chudnovsky(pi, constant, num_threads);
+
+    backend -> clear_number(local_proc_pi, true);
+}
+
@@ -0,0 +1,11 @@
+#ifndef CHUDNOVSKY_SCHEDULES
+#define CHUDNOVSKY_SCHEDULES
+
+#include "backend.h"
+
+void chudnovsky_snake_like_and_blocks_algorithm(struct backend *, MPI_Comm, int, int, void *, long, int, long);
+void chudnovsky_non_uniform_and_blocks_algorithm(struct backend *, MPI_Comm, int, int, void *, long, int, long);
+void chudnovsky_blocks_and_cyclic_algorithm(struct backend *, MPI_Comm, int, int, void *, long, int, long);
+
+#endif
+
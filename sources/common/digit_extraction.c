@@ -0,0 +1,150 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <omp.h>
+#include "mpi.h"
+#include "digit_extraction.h"
+
+#define HEX_DIGITS_PER_DECIMAL 0.830482  // log16(10)
+#define SPOT_MASK ((1ul << (4 * SPOT_HEX_DIGITS)) - 1)
+
+
+/************************************************************************************
+ * Verification by BBP digit extraction                                             *
+ *                                                                                  *
+ ************************************************************************************
+ * The hex digits of pi after the position d are the fraction of 16^d pi:           *
+ *                                                                                  *
+ *   frac(16^d pi) = frac(4 S(1) - 2 S(4) - S(5) - S(6))                            *
+ *                                                                                  *
+ *              d   16^(d-k) mod (8k+j)      inf    16^(d-k)                        *
+ *   S(j) = SUM( ----------------- ) + SUM( -------- )                              *
+ *             k=0       8k+j             k=d+1     8k+j                            *
+ *                                                                                  *
+ * The powers are computed with modular exponentiation in 64 bit words and the      *
+ * fractions are added in long double, so the first SPOT_HEX_DIGITS hex digits are  *
+ * right for positions up to 2^29. The cost is O(d log d) operations in words for   *
+ * every position, independent of the precision of the pi computed.                 *
+ *                                                                                  *
+ * The positions are split cyclically between the processes and every process       *
+ * computes its positions with its threads. They are compared with the bits of the  *
+ * pi computed in process 0.                                                        *
+ *                                                                                  *
+ ************************************************************************************/
+
+
+/*
+ * 16^exponent mod modulus
+ */
+unsigned long power_16_mod(long exponent, unsigned long modulus){
+    unsigned long result, base;
+
+    result = 1 % modulus;
+    base = 16 % modulus;
+    while (exponent > 0) {
+        if (exponent & 1) result = (unsigned __int128) result * base % modulus;
+        base = (unsigned __int128) base * base % modulus;
+        exponent >>= 1;
+    }
+    return result;
+}
+
+/*
+ * Fraction of 16^d S(j)
+ */
+static long double bbp_series_fraction(long d, int j){
+    long k;
+    long double sum, power, term;
+    unsigned long denominator;
+
+    sum = 0;
+    for (k = 0; k <= d; k++) {
+        denominator = 8 * k + j;
+        sum += (long double) power_16_mod(d - k, denominator) / denominator;
+        sum -= (long) sum;
+    }
+    power = 1;
+    for (k = d + 1; ; k++) {
+        power /= 16;
+        term = power / (8 * k + j);
+        if (term < 1e-20L) break;
+        sum += term;
+    }
+    return sum - (long) sum;
+}
+
+/*
+ * The SPOT_HEX_DIGITS hex digits of pi after the first position hex digits
+ */
+unsigned long bbp_hex_digits(long position){
+    long double fraction;
+
+    fraction = 4 * bbp_series_fraction(position, 1) - 2 * bbp_series_fraction(position, 4)
+                - bbp_series_fraction(position, 5) - bbp_series_fraction(position, 6);
+    fraction -= (long) fraction;
+    if (fraction < 0) fraction += 1;
+
+    return (unsigned long) (fraction * (SPOT_MASK + 1)) & SPOT_MASK;
+}
+
+/*
+ * Chooses num_positions random hex positions of a pi of precision decimals.
+ * The last one is always the last position that can be checked.
+ * Every process gets the positions chosen by process 0.
+ */
+void choose_spot_positions(MPI_Comm comm, long *positions, int num_positions, long precision){
+    int i, proc_id;
+    long last_position;
+    unsigned int seed;
+
+    MPI_Comm_rank(comm, &proc_id);
+    last_position = (long) (precision * HEX_DIGITS_PER_DECIMAL) - SPOT_HEX_DIGITS - 1;
+    if (last_position < 0) last_position = 0;
+
+    if (proc_id == 0) {
+        seed = time(NULL);
+        for (i = 0; i < num_positions - 1; i++) {
+            positions[i] = (long) ((double) rand_r(&seed) / RAND_MAX * last_position);
+        }
+        positions[num_positions - 1] = last_position;
+    }
+    MPI_Bcast(positions, num_positions, MPI_LONG, 0, comm);
+}
+
+/*
+ * Computes the hex digits of every position and stores them in the digits of process 0
+ */
+void compute_spot_digits(MPI_Comm comm, long *positions, unsigned long *digits, int num_positions, int num_procs, int proc_id){
+    int i;
+    unsigned long *local_digits;
+
+    local_digits = calloc(num_positions, sizeof(unsigned long));
+
+    #pragma omp parallel for schedule(dynamic, 1)
+    for (i = proc_id; i < num_positions; i += num_procs) {
+        local_digits[i] = bbp_hex_digits(positions[i]);
+    }
+
+    MPI_Reduce(local_digits, digits, num_positions, MPI_UNSIGNED_LONG, MPI_SUM, 0, comm);
+    free(local_digits);
+}
+
+/*
+ * Compares the digits extracted with the digits of pi computed.
+ * It returns precision if all of them are equal, or the decimals before the first position
+ * that is not correct otherwise.
+ */
+long spot_check_decimals(long *positions, unsigned long *digits, unsigned long *computed_digits, int num_positions, long precision){
+    int i;
+    long first_error;
+
+    first_error = -1;
+    for (i = 0; i < num_positions; i++) {
+        if (digits[i] != computed_digits[i] && (first_error < 0 || positions[i] < first_error)) {
+            first_error = positions[i];
+        }
+    }
+
+    return (first_error < 0) ? precision : (long) (first_error / HEX_DIGITS_PER_DECIMAL);
+}
+
@@ -0,0 +1,15 @@
+#ifndef DIGIT_EXTRACTION
+#define DIGIT_EXTRACTION
+
+#include "mpi.h"
+
+#define SPOT_HEX_DIGITS 6               // hex digits compared at every position
+
+unsigned long power_16_mod(long, unsigned long);
+unsigned long bbp_hex_digits(long);
+void choose_spot_positions(MPI_Comm, long *, int, long);
+void compute_spot_digits(MPI_Comm, long *, unsigned long *, int, int, int);
+long spot_check_decimals(long *, unsigned long *, unsigned long *, int, long);
+
+#endif
+
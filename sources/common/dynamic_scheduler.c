@@ -0,0 +1,238 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <omp.h>
+#include "mpi.h"
+#include "options.h"
+#include "dynamic_scheduler.h"
+
+#define PROCESS_CHUNKS_PER_WORKER 8     // process chunks per process when -chunk is not given
+#define THREAD_CHUNKS_PER_THREAD 4      // pieces of a process chunk per thread
+
+
+/************************************************************************************
+ * Dynamic scheduler with work stealing                                             *
+ *                                                                                  *
+ ************************************************************************************
+ * The iterations are handed out in two levels:                                     *
+ *                                                                                  *
+ *   1. Processes: the next free iteration is a counter in an MPI window of         *
+ *      process 0. A process takes process_chunk iterations with an atomic          *
+ *      MPI_Fetch_and_op, so faster processes simply take more chunks.              *
+ *                                                                                  *
+ *   2. Threads: every thread owns a range [next, end) and computes it in pieces    *
+ *      of thread_chunk iterations. A thread whose range is empty steals the        *
+ *      second half of the largest range of the other threads of its process. If    *
+ *      there is nothing to steal it takes a new process chunk.                     *
+ *                                                                                  *
+ * The chunks of a thread are usually consecutive, so the algorithms only need to   *
+ * seed their dependencies when a chunk does not start where the previous ended.    *
+ *                                                                                  *
+ ************************************************************************************
+ * Adaptive termination (-adaptive):                                                *
+ *                                                                                  *
+ * num_iterations is only an upper bound. The algorithms report the exponent of     *
+ * every term relative to the sum (with -block_terms, the first term after every    *
+ * block), and as the ratio of two consecutive terms of every series is below 1/2,  *
+ * the tail after the term n is below it. The first term under 2^-target is the     *
+ * cut-off: no range is given or computed after it. target is the truncation error  *
+ * of the planner, without the bits that it adds for the rounding errors.           *
+ *                                                                                  *
+ * The cut-off of the job is the minimum of a second long of the window of process  *
+ * 0, lowered with MPI_Accumulate(MPI_MIN) and read when a process chunk is taken,  *
+ * so the processes agree on it without waiting for each other. Every iteration     *
+ * before the cut-off is still computed, the chunks are given in order.             *
+ *                                                                                  *
+ ************************************************************************************/
+
+
+/*
+ * Inits the scheduler of num_iterations iterations of a sum whose truncation error
+ * should be below 2^-target_bits (see plan_pi). It is collective: every process should call it with the same num_iterations.
+ * IMPORTANT: MPI should have been initialized with MPI_THREAD_SERIALIZED at least
+ */
+void init_dynamic_scheduler(MPI_Comm comm, struct dynamic_scheduler *scheduler, int num_procs, int proc_id, long num_iterations, int num_threads, long target_bits){
+    int i, thread_level;
+
+    MPI_Query_thread(&thread_level);
+    if (thread_level < MPI_THREAD_SERIALIZED) {
+        if (proc_id == 0) printf("  The MPI library does not support MPI_THREAD_SERIALIZED, needed by the dynamic algorithms. \n\n");
+        MPI_Finalize();
+        exit(-1);
+    }
+
+    scheduler -> num_iterations = num_iterations;
+    scheduler -> cutoff = num_iterations;
+    scheduler -> target_bits = target_bits;
+    scheduler -> num_threads = num_threads;
+    scheduler -> process_chunk = (options.chunk_size > 0) ? options.chunk_size 
+                                 : num_iterations / (num_procs * PROCESS_CHUNKS_PER_WORKER);
+    if (scheduler -> process_chunk < 1) scheduler -> process_chunk = 1;
+    scheduler -> thread_chunk = scheduler -> process_chunk / (num_threads * THREAD_CHUNKS_PER_THREAD);
+    if (scheduler -> thread_chunk < 1) scheduler -> thread_chunk = 1;
+
+    //Create the window with the counter of the next free iteration and the cut-off in process 0
+    MPI_Win_allocate((proc_id == 0) ? 2 * sizeof(long) : 0, sizeof(long), MPI_INFO_NULL, comm, 
+                     &scheduler -> counter, &scheduler -> window);
+    if (proc_id == 0) {
+        scheduler -> counter[0] = 0;
+        scheduler -> counter[1] = num_iterations;
+    }
+    MPI_Barrier(comm);
+    MPI_Win_lock_all(0, scheduler -> window);
+
+    scheduler -> ranges = malloc(sizeof(struct thread_range) * num_threads);
+    for (i = 0; i < num_threads; i++) {
+        scheduler -> ranges[i].next = 0;
+        scheduler -> ranges[i].end = 0;
+        omp_init_lock(&scheduler -> ranges[i].lock);
+    }
+}
+
+/*
+ * End of the range clipped to the cut-off known by the process
+ */
+static long range_end(struct dynamic_scheduler *scheduler, struct thread_range *range){
+    long cutoff;
+
+    #pragma omp atomic read
+    cutoff = scheduler -> cutoff;
+    return (range -> end < cutoff) ? range -> end : cutoff;
+}
+
+/*
+ * Steals the second half of the largest range of the other threads.
+ * It returns false if every range has less than two pieces.
+ */
+bool steal_range(struct dynamic_scheduler *scheduler, int thread_id){
+    int i, victim;
+    long size, largest, middle;
+    struct thread_range *own, *other;
+
+    //Look for the largest range (the sizes may change, they are only a hint)
+    victim = -1;
+    largest = scheduler -> thread_chunk;
+    for (i = 0; i < scheduler -> num_threads; i++) {
+        other = &scheduler -> ranges[i];
+        size = range_end(scheduler, other) - other -> next;
+        if (i != thread_id && size > largest) {
+            largest = size;
+            victim = i;
+        }
+    }
+    if (victim < 0) return false;
+
+    //Lock both ranges in thread order to avoid deadlocks between thieves
+    own = &scheduler -> ranges[thread_id];
+    other = &scheduler -> ranges[victim];
+    omp_set_lock((thread_id < victim) ? &own -> lock : &other -> lock);
+    omp_set_lock((thread_id < victim) ? &other -> lock : &own -> lock);
+    size = range_end(scheduler, other) - other -> next;
+    if (size > scheduler -> thread_chunk && own -> next >= range_end(scheduler, own)) {
+        middle = other -> next + size / 2;
+        own -> next = middle;
+        own -> end = range_end(scheduler, other);
+        other -> end = middle;
+    }
+    omp_unset_lock(&other -> lock);
+    omp_unset_lock(&own -> lock);
+
+    return true;
+}
+
+/*
+ * Takes a new process chunk from the counter of process 0.
+ * It returns false if all the iterations have been given.
+ */
+bool fetch_process_chunk(struct dynamic_scheduler *scheduler, int thread_id){
+    long start, cutoff, end;
+    struct thread_range *own = &scheduler -> ranges[thread_id];
+
+    #pragma omp critical (dynamic_scheduler_mpi)
+    {
+        MPI_Fetch_and_op(&scheduler -> process_chunk, &start, MPI_LONG, 0, 0, MPI_SUM, scheduler -> window);
+        if (options.adaptive) MPI_Fetch_and_op(NULL, &cutoff, MPI_LONG, 0, 1, MPI_NO_OP, scheduler -> window);
+        MPI_Win_flush(0, scheduler -> window);
+        if (options.adaptive && cutoff < scheduler -> cutoff) {
+            #pragma omp atomic write
+            scheduler -> cutoff = cutoff;
+        }
+    }
+    #pragma omp atomic read
+    cutoff = scheduler -> cutoff;
+    end = (start + scheduler -> process_chunk < cutoff) ? start + scheduler -> process_chunk : cutoff;
+    if (start >= end) return false;
+
+    omp_set_lock(&own -> lock);
+    own -> next = start;
+    own -> end = end;
+    omp_unset_lock(&own -> lock);
+
+    return true;
+}
+
+/*
+ * Gives the next iterations [start, end) of the thread thread_id.
+ * It returns false when there are no more iterations for this thread.
+ */
+bool next_chunk(struct dynamic_scheduler *scheduler, int thread_id, long *start, long *end){
+    long limit;
+    struct thread_range *own = &scheduler -> ranges[thread_id];
+
+    while (true) {
+        //Take a piece of the own range
+        omp_set_lock(&own -> lock);
+        limit = range_end(scheduler, own);
+        if (own -> next < limit) {
+            *start = own -> next;
+            *end = (own -> next + scheduler -> thread_chunk < limit) ? own -> next + scheduler -> thread_chunk : limit;
+            own -> next = *end;
+            omp_unset_lock(&own -> lock);
+            return true;
+        }
+        omp_unset_lock(&own -> lock);
+
+        //Steal from other threads or take a new process chunk
+        if (!steal_range(scheduler, thread_id) && !fetch_process_chunk(scheduler, thread_id)) {
+            return false;
+        }
+    }
+}
+
+/*
+ * Reports that the term i of the sum is below 2^exponent relative to the sum.
+ * With -adaptive, the iterations after the first term below the target are not given.
+ */
+void report_term_exponent(struct dynamic_scheduler *scheduler, long i, long exponent){
+    long cutoff;
+
+    if (!options.adaptive || exponent > -scheduler -> target_bits) return;
+    #pragma omp atomic read
+    cutoff = scheduler -> cutoff;
+    if (i + 1 >= cutoff) return;
+
+    #pragma omp critical (dynamic_scheduler_mpi)
+    {
+        if (i + 1 < scheduler -> cutoff) {
+            #pragma omp atomic write
+            scheduler -> cutoff = i + 1;
+            MPI_Accumulate(&scheduler -> cutoff, 1, MPI_LONG, 0, 1, 1, MPI_LONG, MPI_MIN, scheduler -> window);
+            MPI_Win_flush(0, scheduler -> window);
+        }
+    }
+}
+
+/*
+ * Frees the scheduler. It is collective like init_dynamic_scheduler.
+ */
+void free_dynamic_scheduler(struct dynamic_scheduler *scheduler){
+    int i;
+
+    for (i = 0; i < scheduler -> num_threads; i++) {
+        omp_destroy_lock(&scheduler -> ranges[i].lock);
+    }
+    free(scheduler -> ranges);
+
+    MPI_Win_unlock_all(scheduler -> window);
+    MPI_Win_free(&scheduler -> window);
+}
@@ -0,0 +1,31 @@
+#ifndef DYNAMIC_SCHEDULER
+#define DYNAMIC_SCHEDULER
+
+#include <stdbool.h>
+#include <omp.h>
+#include "mpi.h"
+
+struct thread_range {
+    long next;
+    long end;
+    omp_lock_t lock;
+};
+
+struct dynamic_scheduler {
+    MPI_Win window;
+    long *counter;
+    long num_iterations;
+    long cutoff;
+    long target_bits;
+    long process_chunk;
+    long thread_chunk;
+    int num_threads;
+    struct thread_range *ranges;
+};
+
+void init_dynamic_scheduler(MPI_Comm, struct dynamic_scheduler *, int, int, long, int, long);
+bool next_chunk(struct dynamic_scheduler *, int, long *, long *);
+void report_term_exponent(struct dynamic_scheduler *, long, long);
+void free_dynamic_scheduler(struct dynamic_scheduler *);
+
+#endif
@@ -0,0 +1,70 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <omp.h>
+#include "mpi.h"
+#include "planner.h"
+#include "dynamic_scheduler.h"
+#include "backend.h"
+#include "dynamic_schedules.h"
+
+
+/************************************************************************************
+ * Dynamic and stealing schedule of the series for every library                    *
+ *                                                                                  *
+ ************************************************************************************
+ * The processes take chunks of iterations from a counter shared with MPI one-sided *
+ * operations and the threads of a process steal iterations from each other when    *
+ * they run out of work (see common/dynamic_scheduler.c).                           *
+ *                                                                                  *
+ * The schedule is the same for the BBP, Bellard and Chudnovsky series and for      *
+ * every library: the terms of the chunks of a thread, with their dependencies,     *
+ * are added by the backend of the library (dynamic_terms in gmp/backend.c and      *
+ * mpfr/backend.c), which seeds the dependencies only when a chunk does not start   *
+ * where the previous chunk of the thread ended. The last operations are:           *
+ *                                                                                  *
+ *   BBP: none, the sum is pi.                                                      *
+ *   Bellard: the sum is 2^6 pi.                                                    *
+ *   Chudnovsky: pi = 426880 sqrt(10005) / sum, the constant is computed in         *
+ *      the background by process 0 while the terms are added.                      *
+ *                                                                                  *
+ ************************************************************************************/
+
+
+void dynamic_and_stealing_algorithm(struct backend *backend, enum series series, MPI_Comm comm, int num_procs, int proc_id, void *pi,
+                                    long num_iterations, int num_threads, long precision_bits, long target_bits){
+    void *local_proc_pi, *constant = NULL;
+    struct dynamic_scheduler scheduler;
+
+    local_proc_pi = backend -> init_number(precision_bits, true);
+    if (series == CHUDNOVSKY_SERIES && proc_id == 0) constant = backend -> start_chudnovsky_constant(precision_bits);   // e = D sqrt(E) in parallel
+    init_dynamic_scheduler(comm, &scheduler, num_procs, proc_id, num_iterations, num_threads, target_bits);
+
+    //Set the number of threads
+    omp_set_num_threads(num_threads);
+
+    #pragma omp parallel
+    {
+        void *local_thread_pi;
+
+        local_thread_pi = backend -> init_number(precision_bits, false);      // private thread pi
+
+        //First Phase -> Working on the chunks given by the scheduler
+        backend -> dynamic_terms(series, local_thread_pi, &scheduler, omp_get_thread_num(), precision_bits);
+
+        //Second Phase -> Accumulate the result in the global variable
+        backend -> reduce_threads(local_proc_pi, local_thread_pi);
+        backend -> clear_number(local_thread_pi, false);
+    }
+
+    free_dynamic_scheduler(&scheduler);
+
+    //Reduce local_proc_pi in global Pi and do the last operations to get Pi
+    backend -> reduce_processes(comm, pi, local_proc_pi, proc_id);
+    if (proc_id == 0) {
+        if (series == BELLARD_SERIES) backend -> div_ui(pi, pi, 64);
+        if (series == CHUDNOVSKY_SERIES) backend -> finish_chudnovsky(pi, constant, num_threads);
+    }
+
+    backend -> clear_number(local_proc_pi, true);
+}
+
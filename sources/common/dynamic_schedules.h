@@ -0,0 +1,10 @@
+#ifndef DYNAMIC_SCHEDULES
+#define DYNAMIC_SCHEDULES
+
+#include "planner.h"
+#include "backend.h"
+
+void dynamic_and_stealing_algorithm(struct backend *, enum series, MPI_Comm, int, int, void *, long, int, long, long);
+
+#endif
+
@@ -0,0 +1,138 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <glob.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#include "hardware_counters.h"
+
+#define MAX_ENERGY_DOMAINS 16
+
+
+/************************************************************************************
+ * Hardware counters and energy of the node                                         *
+ *                                                                                  *
+ ************************************************************************************
+ * Every thread opens a group of perf events (perf_event_open) that counts only     *
+ * itself in user space: cycles, instructions and last level cache misses. The      *
+ * group is read at once, so the three values cover the same interval.              *
+ *                                                                                  *
+ * The energy is read from the RAPL package domains of the powercap interface       *
+ * (/sys/class/powercap/intel-rapl:N/energy_uj), which count the microjoules of     *
+ * the whole node. They wrap around at max_energy_range_uj.                         *
+ *                                                                                  *
+ ************************************************************************************/
+
+
+static int num_domains = 0;
+static char domain_paths[MAX_ENERGY_DOMAINS][256];
+static double domain_start[MAX_ENERGY_DOMAINS];
+static double domain_range[MAX_ENERGY_DOMAINS];
+
+
+static int perf_event_open(struct perf_event_attr *attr, int group_fd){
+    return syscall(SYS_perf_event_open, attr, 0, -1, group_fd, 0);
+}
+
+/*
+ * Opens the counters of the calling thread and returns the file descriptor of the group,
+ * or -1 if they are not available
+ */
+int open_thread_counters(){
+    int i, fds[NUM_COUNTERS];
+    uint64_t events[NUM_COUNTERS] = {PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CACHE_MISSES};
+    struct perf_event_attr attr;
+
+    for (i = 0; i < NUM_COUNTERS; i++) {
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.config = events[i];
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_GROUP;
+        fds[i] = perf_event_open(&attr, (i == 0) ? -1 : fds[0]);
+        if (fds[i] < 0) {
+            while (--i >= 0) close(fds[i]);
+            return -1;
+        }
+    }
+    return fds[0];
+}
+
+/*
+ * Reads the NUM_COUNTERS counters of the group fd in values
+ */
+void read_thread_counters(int fd, double *values){
+    int i;
+    uint64_t group[NUM_COUNTERS + 1];
+
+    if (fd < 0 || read(fd, group, sizeof(group)) != sizeof(group)) {
+        for (i = 0; i < NUM_COUNTERS; i++) values[i] = 0;
+        return;
+    }
+    for (i = 0; i < NUM_COUNTERS; i++) values[i] = (double) group[i + 1];
+}
+
+/*
+ * Closes the group fd. The other events of the group are closed with it
+ */
+void close_thread_counters(int fd){
+    if (fd >= 0) close(fd);
+}
+
+static double read_domain_file(char *domain, char *name){
+    char path[512];
+    double value = -1;
+    FILE *file;
+
+    snprintf(path, sizeof(path), "%s/%s", domain, name);
+    file = fopen(path, "r");
+    if (file == NULL) return -1;
+    if (fscanf(file, "%lf", &value) != 1) value = -1;
+    fclose(file);
+    return value;
+}
+
+/*
+ * Starts measuring the energy of the package domains of the node
+ */
+void start_node_energy(){
+    size_t i;
+    char *name;
+    glob_t domains;
+
+    num_domains = 0;
+    if (glob("/sys/class/powercap/intel-rapl:*", 0, NULL, &domains) != 0) return;
+    for (i = 0; i < domains.gl_pathc && num_domains < MAX_ENERGY_DOMAINS; i++) {
+        //The subdomains (intel-rapl:N:M) are already counted in their package
+        name = strrchr(domains.gl_pathv[i], '/') + 1;
+        if (strchr(strchr(name, ':') + 1, ':') != NULL) continue;
+        snprintf(domain_paths[num_domains], sizeof(domain_paths[num_domains]), "%s", domains.gl_pathv[i]);
+        domain_start[num_domains] = read_domain_file(domain_paths[num_domains], "energy_uj");
+        domain_range[num_domains] = read_domain_file(domain_paths[num_domains], "max_energy_range_uj");
+        if (domain_start[num_domains] >= 0) num_domains++;
+    }
+    globfree(&domains);
+}
+
+/*
+ * Returns the joules used by the node since start_node_energy, or -1 if they can not be read
+ */
+double stop_node_energy(){
+    int i;
+    double joules, end;
+
+    if (num_domains == 0) return -1;
+    joules = 0;
+    for (i = 0; i < num_domains; i++) {
+        end = read_domain_file(domain_paths[i], "energy_uj");
+        if (end < 0) return -1;
+        if (end < domain_start[i]) end += domain_range[i];
+        joules += (end - domain_start[i]) / 1.e6;
+    }
+    return joules;
+}
+
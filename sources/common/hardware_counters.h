@@ -0,0 +1,13 @@
+#ifndef HARDWARE_COUNTERS
+#define HARDWARE_COUNTERS
+
+#define NUM_COUNTERS 3                  // cycles, instructions and last level cache misses
+
+int open_thread_counters();
+void read_thread_counters(int, double *);
+void close_thread_counters(int);
+void start_node_energy();
+double stop_node_energy();
+
+#endif
+
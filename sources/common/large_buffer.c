@@ -0,0 +1,146 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include "mpi.h"
+#include "large_buffer.h"
+
+#define MMAP_THRESHOLD (64L << 20)      // buffers from 64 MiB are mapped directly
+#define MESSAGE_BYTES (1L << 30)        // bytes of every message of a large buffer
+#define TYPE_BLOCK_BYTES (1 << 20)      // bytes of the blocks of the datatypes of large buffers
+
+
+/************************************************************************************
+ * Page aligned buffers for the packing, transport and conversion of the numbers    *
+ *                                                                                  *
+ ************************************************************************************
+ * With billions of digits every number takes hundreds of MiB, so the buffers used  *
+ * to send or convert them can not live in the stack. They are allocated in the     *
+ * heap aligned to the page size, and the largest ones are mapped directly with     *
+ * mmap, so they are returned to the system as soon as they are freed.              *
+ *                                                                                  *
+ * The size of the buffer and how it was allocated are stored in a header page      *
+ * before the buffer, so it can be freed without knowing its size.                  *
+ *                                                                                  *
+ * The count of an MPI message is an int, so the buffers above 2 GiB are sent in    *
+ * messages of MESSAGE_BYTES bytes after a first message with the size, and the     *
+ * datatypes of the buffers reduced as one element are built from blocks of        *
+ * TYPE_BLOCK_BYTES bytes, so no count of the datatype is above the int range.      *
+ *                                                                                  *
+ ************************************************************************************/
+
+
+struct buffer_header {
+    size_t size;
+    int mapped;
+};
+
+
+static void out_of_memory(size_t size){
+    printf("  Not enough memory to allocate a buffer of %zu bytes \n", size);
+    exit(-1);
+}
+
+/*
+ * Returns a page aligned buffer of size bytes. It should be freed with free_large_buffer
+ */
+void * allocate_large_buffer(size_t size){
+    size_t page_size, total_size;
+    char *block;
+    struct buffer_header *header;
+
+    page_size = sysconf(_SC_PAGESIZE);
+    total_size = page_size + size;
+    if (total_size >= MMAP_THRESHOLD) {
+        block = mmap(NULL, total_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (block == MAP_FAILED) out_of_memory(size);
+    } else if (posix_memalign((void **) &block, page_size, total_size) != 0) {
+        out_of_memory(size);
+    }
+
+    header = (struct buffer_header *) (block + page_size - sizeof(struct buffer_header));
+    header -> size = total_size;
+    header -> mapped = (total_size >= MMAP_THRESHOLD);
+    return block + page_size;
+}
+
+void free_large_buffer(void *buffer){
+    size_t page_size;
+    char *block;
+    struct buffer_header *header;
+
+    if (buffer == NULL) return;
+    page_size = sysconf(_SC_PAGESIZE);
+    block = (char *) buffer - page_size;
+    header = (struct buffer_header *) ((char *) buffer - sizeof(struct buffer_header));
+    if (header -> mapped) munmap(block, header -> size);
+    else free(block);
+}
+
+/*
+ * Sends bytes bytes of buffer to the process destination of comm
+ */
+void send_large_buffer(MPI_Comm comm, void *buffer, long bytes, int destination){
+    long offset, length;
+
+    MPI_Send(&bytes, 1, MPI_LONG, destination, 0, comm);
+    for (offset = 0; offset < bytes; offset += length) {
+        length = (bytes - offset < MESSAGE_BYTES) ? bytes - offset : MESSAGE_BYTES;
+        MPI_Send((char *) buffer + offset, (int) length, MPI_BYTE, destination, 0, comm);
+    }
+}
+
+/*
+ * Receives a buffer sent with send_large_buffer by the process source of comm.
+ * It returns the buffer and sets its size in bytes. The buffer should be freed with free_large_buffer
+ */
+void * receive_large_buffer(MPI_Comm comm, long *bytes, int source){
+    long offset, length;
+    char *buffer;
+
+    MPI_Recv(bytes, 1, MPI_LONG, source, 0, comm, MPI_STATUS_IGNORE);
+    buffer = allocate_large_buffer(*bytes);
+    for (offset = 0; offset < *bytes; offset += length) {
+        length = (*bytes - offset < MESSAGE_BYTES) ? *bytes - offset : MESSAGE_BYTES;
+        MPI_Recv(buffer + offset, (int) length, MPI_BYTE, source, 0, comm, MPI_STATUS_IGNORE);
+    }
+    return buffer;
+}
+
+/*
+ * Creates and commits in type a contiguous datatype of bytes bytes
+ */
+void create_bytes_type(size_t bytes, MPI_Datatype *type){
+    int lengths[2] = {1, 1};
+    size_t blocks;
+    MPI_Aint displacements[2];
+    MPI_Datatype block_type, types[2];
+
+    if (bytes <= TYPE_BLOCK_BYTES) {
+        MPI_Type_contiguous((int) bytes, MPI_BYTE, type);
+        MPI_Type_commit(type);
+        return;
+    }
+
+    //blocks of TYPE_BLOCK_BYTES bytes followed by the rest of the bytes
+    blocks = bytes / TYPE_BLOCK_BYTES;
+    MPI_Type_contiguous(TYPE_BLOCK_BYTES, MPI_BYTE, &block_type);
+    MPI_Type_contiguous((int) blocks, block_type, &types[0]);
+    MPI_Type_contiguous((int) (bytes - blocks * TYPE_BLOCK_BYTES), MPI_BYTE, &types[1]);
+    displacements[0] = 0;
+    displacements[1] = (MPI_Aint) (blocks * TYPE_BLOCK_BYTES);
+    MPI_Type_create_struct(2, lengths, displacements, types, type);
+    MPI_Type_commit(type);
+
+    MPI_Type_free(&block_type);
+    MPI_Type_free(&types[0]);
+    MPI_Type_free(&types[1]);
+}
+
+/*
+ * Bytes of physical memory of the node
+ */
+size_t physical_memory(){
+    return (size_t) sysconf(_SC_PHYS_PAGES) * sysconf(_SC_PAGESIZE);
+}
+
@@ -0,0 +1,15 @@
+#ifndef LARGE_BUFFER
+#define LARGE_BUFFER
+
+#include <stddef.h>
+#include "mpi.h"
+
+void * allocate_large_buffer(size_t);
+void free_large_buffer(void *);
+void send_large_buffer(MPI_Comm, void *, long, int);
+void * receive_large_buffer(MPI_Comm, long *, int);
+void create_bytes_type(size_t, MPI_Datatype *);
+size_t physical_memory();
+
+#endif
+
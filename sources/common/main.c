@@ -4,6 +4,12 @@
 #include <stdbool.h>
 #include "mpi.h"
 #include "printer.h"
+#include "options.h"
+#include "arena.h"
+#include "placement.h"
+#include "checkpoint.h"
+#include "sweep.h"
+#include "planner.h"
 #include "../gmp/pi_calculator.h"
 #include "../mpfr/pi_calculator.h"
 
@@ -11,45 +17,56 @@
 
 int incorrect_params(char* exec_name){
     printf("  Number of params are not correct. Try with:\n");
-    printf("    mpirun -np num_procs %s library algorithm precision num_threads [-csv] \n", exec_name);
+    printf("    mpirun -np num_procs %s library algorithm precision num_threads [-csv] [options] \n", exec_name);
+    printf("  The four params can be comma separated lists to run a sweep of all their combinations. \n");
     printf("\n");
+    print_options_help();
 }
 
 int main(int argc, char **argv){    
-    int num_procs, proc_id;
-    bool print_in_csv_format; 
+    int num_procs, proc_id, thread_level;
+    bool print_in_csv_format, correct_params; 
 
-    //Init MPI
-    MPI_Init(&argc, &argv);
+    //The options are read first because -progress needs another MPI thread level
+    correct_params = (argc >= 5 && parse_options(argc, argv, 5));
+
+    //Init MPI (the dynamic algorithms call MPI from one thread at a time, and the
+    //progress thread calls it at the same time as the compute threads)
+    MPI_Init_thread(&argc, &argv, (options.progress_interval > 0) ? MPI_THREAD_MULTIPLE : MPI_THREAD_SERIALIZED, &thread_level);
     MPI_Comm_size(MPI_COMM_WORLD, &num_procs);
     MPI_Comm_rank(MPI_COMM_WORLD, &proc_id); 
 
     //Check the number of parameters are correct
 
-    if (argc == 6 && strcmp(argv[5], "-csv") == 0) {
-        print_in_csv_format = true;    
-    } 
-    else if (argc == 5) {
-        if (proc_id == 0) { print_title(); } 
-        print_in_csv_format = false;
-    }
-    else {
+    if (!correct_params) {
         incorrect_params(argv[0]);
         exit(-1);
     }
+    print_in_csv_format = options.csv;
+    if (options.arena) install_arena_allocator();
+    if (!print_in_csv_format && proc_id == 0) { print_title(); }
+
+    //Lists of params, warmups or repetitions run a sweep of all the points in this job
+    if (sweep_requested(argv + 1)) {
+        run_sweep(num_procs, proc_id, argv + 1);
+        finish_checkpoints();
+        MPI_Finalize();
+        exit(0);
+    }
 
     //Take operation, precision and number of threads from params
     char *library = argv[1];
     int algorithm = atoi(argv[2]);    
-    int precision = atoi(argv[3]);
+    long precision = parse_precision(argv[3]);
     int num_threads = (atoi(argv[4]) <= 0) ? 1 : atoi(argv[4]);
+    if (options.bind_threads) place_threads(num_threads);
 
 
     if (strcmp(library, "GMP") == 0) {
-        calculate_pi_gmp(num_procs, proc_id, algorithm, precision, num_threads, print_in_csv_format);
+        calculate_pi_gmp(MPI_COMM_WORLD, num_procs, proc_id, algorithm, precision, num_threads, print_in_csv_format, NULL);
     } 
     else if (strcmp(library, "MPFR") == 0) {
-        calculate_pi_mpfr(num_procs, proc_id, algorithm, precision, num_threads, print_in_csv_format);
+        calculate_pi_mpfr(MPI_COMM_WORLD, num_procs, proc_id, algorithm, precision, num_threads, print_in_csv_format, NULL);
     } 
     else 
     {
@@ -60,6 +77,7 @@ int main(int argc, char **argv){
         exit(-1);
     }    
 
+    finish_checkpoints();
     MPI_Finalize();
 
     exit(0);
@@ -0,0 +1,75 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "mpi.h"
+#include "node_reduction.h"
+
+
+/************************************************************************************
+ * Two level reduction of the transport buffers                                     *
+ *                                                                                  *
+ ************************************************************************************
+ * 1. The processes of the same node (MPI_COMM_TYPE_SHARED) copy their buffer to    *
+ *    a slot of a shared memory window and add the slots of the other processes     *
+ *    directly through a binary tree, without sending any message.                  *
+ *                                                                                  *
+ * 2. Only the sum of every node, kept in the slot of the node leader, takes part   *
+ *    in the MPI_Reduce between nodes, so the traffic between nodes is divided by   *
+ *    the number of processes per node.                                             *
+ *                                                                                  *
+ * Process 0 is always the leader of its node and the root of the reduction between *
+ * nodes, so the result is left in its recbuffer as with MPI_Reduce.                *
+ *                                                                                  *
+ ************************************************************************************/
+
+
+/*
+ * Reduces the sendbuffer of every process with the operation add_op (and its function add)
+ * and stores the result in the recbuffer of process 0.
+ * Both buffers hold one element of transport_type.
+ */
+void node_reduce(MPI_Comm comm, void *sendbuffer, void *recbuffer, MPI_Datatype transport_type, MPI_Op add_op, MPI_User_function *add){
+    int proc_id, node_rank, node_size, step, one;
+    MPI_Count packet_size;
+    int disp_unit;
+    char *slot, *other_slot;
+    MPI_Aint slot_size;
+    MPI_Comm node_comm, leader_comm;
+    MPI_Win window;
+
+    MPI_Comm_rank(comm, &proc_id);
+    MPI_Type_size_x(transport_type, &packet_size);
+    MPI_Comm_split_type(comm, MPI_COMM_TYPE_SHARED, proc_id, MPI_INFO_NULL, &node_comm);
+    MPI_Comm_rank(node_comm, &node_rank);
+    MPI_Comm_size(node_comm, &node_size);
+
+    //First level -> Add the buffers of the node in shared memory
+    MPI_Win_allocate_shared((MPI_Aint) packet_size, 1, MPI_INFO_NULL, node_comm, &slot, &window);
+    MPI_Win_lock_all(MPI_MODE_NOCHECK, window);
+    memcpy(slot, sendbuffer, packet_size);
+    MPI_Win_sync(window);
+    MPI_Barrier(node_comm);
+
+    one = 1;
+    for (step = 1; step < node_size; step *= 2) {
+        if (node_rank % (2 * step) == 0 && node_rank + step < node_size) {
+            MPI_Win_shared_query(window, node_rank + step, &slot_size, &disp_unit, &other_slot);
+            add(other_slot, slot, &one, &transport_type);
+        }
+        MPI_Win_sync(window);
+        MPI_Barrier(node_comm);
+        MPI_Win_sync(window);
+    }
+
+    //Second level -> Reduce the sums of the nodes between the leaders
+    MPI_Comm_split(comm, (node_rank == 0) ? 0 : MPI_UNDEFINED, proc_id, &leader_comm);
+    if (leader_comm != MPI_COMM_NULL) {
+        MPI_Reduce(slot, recbuffer, 1, transport_type, add_op, 0, leader_comm);
+        MPI_Comm_free(&leader_comm);
+    }
+
+    MPI_Win_unlock_all(window);
+    MPI_Win_free(&window);
+    MPI_Comm_free(&node_comm);
+}
+
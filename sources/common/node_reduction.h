@@ -0,0 +1,9 @@
+#ifndef NODE_REDUCTION
+#define NODE_REDUCTION
+
+#include "mpi.h"
+
+void node_reduce(MPI_Comm, void *, void *, MPI_Datatype, MPI_Op, MPI_User_function *);
+
+#endif
+
@@ -0,0 +1,209 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <errno.h>
+#include "options.h"
+
+
+/*
+ * Optional params of the program. They are given after the positional params
+ * as -name or -name=value and they are the same for every process.
+ */
+struct options options = {
+    .csv = false,
+    .reduce_segments = 0,
+    .decreasing_precision = false,
+    .calibrate = false,
+    .chunk_size = 0,
+    .block_terms = 1,
+    .arena = false,
+    .bind_threads = false,
+    .node_reduce = false,
+    .output_file = NULL,
+    .spot_checks = 0,
+    .hex_start = 0,
+    .checkpoint_dir = NULL,
+    .checkpoint_interval = 600,
+    .resume = false,
+    .phase_times = false,
+    .phase_report = NULL,
+    .counters = false,
+    .warmups = 0,
+    .repetitions = 1,
+    .groups = 1,
+    .spill_dir = NULL,
+    .spill_chunk = 262144,
+    .dump_file = NULL,
+    .cache_dir = NULL,
+    .adaptive = false,
+    .progress_interval = 0,
+    .progress_file = NULL,
+    .weighted = false,
+};
+
+
+/*
+ * Returns the value of the option arg if it is -name=value, or NULL otherwise
+ */
+static char * option_value(char *arg, char *name){
+    int length = strlen(name);
+    if (strncmp(arg, name, length) == 0 && arg[length] == '=') return arg + length + 1;
+    return NULL;
+}
+
+/*
+ * Reads the options stored in argv from the position first.
+ * It returns false if some option is not known or its value is not correct.
+ */
+bool parse_options(int argc, char **argv, int first){
+    int i;
+    char *value, *end;
+
+    for (i = first; i < argc; i++) {
+        if (strcmp(argv[i], "-csv") == 0) {
+            options.csv = true;
+        }
+        else if ((value = option_value(argv[i], "-segments")) != NULL) {
+            options.reduce_segments = atoi(value);
+            if (options.reduce_segments <= 0) return false;
+        }
+        else if (strcmp(argv[i], "-decreasing_precision") == 0) {
+            options.decreasing_precision = true;
+        }
+        else if (strcmp(argv[i], "-calibrate") == 0) {
+            options.calibrate = true;
+        }
+        else if ((value = option_value(argv[i], "-chunk")) != NULL) {
+            options.chunk_size = atoi(value);
+            if (options.chunk_size <= 0) return false;
+        }
+        else if (strcmp(argv[i], "-arena") == 0) {
+            options.arena = true;
+        }
+        else if (strcmp(argv[i], "-bind") == 0) {
+            options.bind_threads = true;
+        }
+        else if (strcmp(argv[i], "-node_reduce") == 0) {
+            options.node_reduce = true;
+        }
+        else if ((value = option_value(argv[i], "-block_terms")) != NULL) {
+            options.block_terms = atoi(value);
+            if (options.block_terms <= 0) return false;
+        }
+        else if ((value = option_value(argv[i], "-output")) != NULL) {
+            options.output_file = value;
+            if (*value == '\0') return false;
+        }
+        else if ((value = option_value(argv[i], "-spot_check")) != NULL) {
+            options.spot_checks = atoi(value);
+            if (options.spot_checks <= 0) return false;
+        }
+        else if ((value = option_value(argv[i], "-hex_start")) != NULL) {
+            errno = 0;
+            options.hex_start = strtol(value, &end, 10);
+            if (errno != 0 || *end != '\0' || options.hex_start < 0) return false;
+        }
+        else if ((value = option_value(argv[i], "-checkpoint")) != NULL) {
+            options.checkpoint_dir = value;
+            if (*value == '\0') return false;
+        }
+        else if ((value = option_value(argv[i], "-checkpoint_interval")) != NULL) {
+            options.checkpoint_interval = atof(value);
+            if (options.checkpoint_interval <= 0) return false;
+        }
+        else if (strcmp(argv[i], "-resume") == 0) {
+            options.resume = true;
+        }
+        else if (strcmp(argv[i], "-phases") == 0) {
+            options.phase_times = true;
+        }
+        else if ((value = option_value(argv[i], "-phases")) != NULL) {
+            options.phase_times = true;
+            options.phase_report = value;
+            if (*value == '\0') return false;
+        }
+        else if (strcmp(argv[i], "-counters") == 0) {
+            options.counters = true;
+        }
+        else if ((value = option_value(argv[i], "-warmups")) != NULL) {
+            options.warmups = atoi(value);
+            if (options.warmups < 0) return false;
+        }
+        else if ((value = option_value(argv[i], "-repetitions")) != NULL) {
+            options.repetitions = atoi(value);
+            if (options.repetitions <= 0) return false;
+        }
+        else if ((value = option_value(argv[i], "-groups")) != NULL) {
+            options.groups = atoi(value);
+            if (options.groups <= 0) return false;
+        }
+        else if ((value = option_value(argv[i], "-spill")) != NULL) {
+            options.spill_dir = value;
+            if (*value == '\0') return false;
+        }
+        else if ((value = option_value(argv[i], "-spill_chunk")) != NULL) {
+            options.spill_chunk = atoi(value);
+            if (options.spill_chunk <= 0) return false;
+        }
+        else if ((value = option_value(argv[i], "-dump")) != NULL) {
+            options.dump_file = value;
+            if (*value == '\0') return false;
+        }
+        else if ((value = option_value(argv[i], "-cache")) != NULL) {
+            options.cache_dir = value;
+            if (*value == '\0') return false;
+        }
+        else if (strcmp(argv[i], "-adaptive") == 0) {
+            options.adaptive = true;
+        }
+        else if ((value = option_value(argv[i], "-progress")) != NULL) {
+            options.progress_interval = atof(value);
+            if (options.progress_interval <= 0) return false;
+        }
+        else if ((value = option_value(argv[i], "-progress_file")) != NULL) {
+            options.progress_file = value;
+            if (*value == '\0') return false;
+        }
+        else if (strcmp(argv[i], "-weighted") == 0) {
+            options.weighted = true;
+        }
+        else {
+            return false;
+        }
+    }
+    return true;
+}
+
+void print_options_help(){
+    printf("  Options: \n");
+    printf("      -csv -> Show the results in csv format \n");
+    printf("      -segments=N -> Reduce the partial sums of the processes in N pipelined segments \n");
+    printf("      -decreasing_precision -> Compute every term of the series with the precision it needs \n");
+    printf("      -calibrate -> Fit the cost model of the scheduler to the local hardware \n");
+    printf("      -chunk=N -> Iterations taken at once by every process in the dynamic algorithms \n");
+    printf("      -block_terms=K -> Add the Chudnovsky terms in exact rational blocks of K terms \n");
+    printf("      -arena -> Allocate the GMP and MPFR numbers from per-thread pools \n");
+    printf("      -bind -> Bind the threads to the CPUs of the process ordered by NUMA node \n");
+    printf("      -node_reduce -> Add the partial sums of the processes of a node in shared memory \n");
+    printf("      -output=FILE -> Write the decimals of pi computed in FILE \n");
+    printf("      -spot_check=N -> Check N hex digits positions with BBP digit extraction instead of the reference file \n");
+    printf("      -hex_start=P -> Position of the first hex digit computed by the digit extraction algorithm \n");
+    printf("      -checkpoint=DIR -> Save the partial sums of the threads in DIR in the background \n");
+    printf("      -checkpoint_interval=S -> Seconds between two checkpoints of a thread (600 by default) \n");
+    printf("      -resume -> Continue from the checkpoints of DIR saved by the same run \n");
+    printf("      -phases[=FILE] -> Time the phases of every thread and process, and write them in the json FILE \n");
+    printf("      -counters -> Read the cycles, instructions and cache misses of every process and the energy of every node \n");
+    printf("      -warmups=W -> Runs of every point of a sweep that are not measured (0 by default) \n");
+    printf("      -repetitions=N -> Measured runs of every point of a sweep (1 by default) \n");
+    printf("      -groups=G -> Split the processes in G groups that run the points of a sweep at the same time \n");
+    printf("      -spill=DIR -> Keep the largest binary splitting numbers in files of DIR while they are multiplied \n");
+    printf("      -spill_chunk=K -> KiB of the chunks of the products of the spilled numbers (262144 by default) \n");
+    printf("      -dump=FILE -> Write the binary result (library limbs) in FILE \n");
+    printf("      -cache=DIR -> Reuse the results stored in DIR with the same or more precision and store the new ones \n");
+    printf("      -adaptive -> Stop the dynamic algorithms at the first term below the target precision \n");
+    printf("      -progress=S -> Report the iterations per second, time left and lag of the processes every S seconds \n");
+    printf("      -progress_file=FILE -> Also write the progress reports in FILE in the Prometheus text format \n");
+    printf("      -weighted -> Give the processes Chudnovsky blocks proportional to the throughput of a probe of their threads \n");
+    printf("\n");
+}
@@ -0,0 +1,43 @@
+#ifndef OPTIONS
+#define OPTIONS
+
+#include <stdbool.h>
+
+struct options {
+    bool csv;
+    int reduce_segments;
+    bool decreasing_precision;
+    bool calibrate;
+    int chunk_size;
+    int block_terms;
+    bool arena;
+    bool bind_threads;
+    bool node_reduce;
+    char *output_file;
+    int spot_checks;
+    long hex_start;
+    char *checkpoint_dir;
+    double checkpoint_interval;
+    bool resume;
+    bool phase_times;
+    char *phase_report;
+    bool counters;
+    int warmups;
+    int repetitions;
+    int groups;
+    char *spill_dir;
+    int spill_chunk;
+    char *dump_file;
+    char *cache_dir;
+    bool adaptive;
+    double progress_interval;
+    char *progress_file;
+    bool weighted;
+};
+
+extern struct options options;
+
+bool parse_options(int, char **, int);
+void print_options_help();
+
+#endif
@@ -0,0 +1,333 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <time.h>
+#include <omp.h>
+#include "mpi.h"
+#include "options.h"
+#include "hardware_counters.h"
+#include "phase_timer.h"
+
+#define VALUES_PER_PHASE (3 + NUM_COUNTERS)   // wall time, cpu time, number of marks and counters
+#define THREAD_VALUES (NUM_PHASES * VALUES_PER_PHASE + 1)
+
+
+/************************************************************************************
+ * Phase timing of every thread of every process                                    *
+ *                                                                                  *
+ ************************************************************************************
+ * Every thread keeps the wall and cpu time of its last mark. mark_phase(phase)     *
+ * adds the time since the last mark to phase, so a phase is the time between the   *
+ * mark of the previous phase and its own mark:                                     *
+ *                                                                                  *
+ *   SEED_PHASE           start of the computation -> before the First Phase        *
+ *   SUM_PHASE            First Phase -> reduce_threads                             *
+ *   THREAD_REDUCE_PHASE  reduce_threads (and the wait for the other threads)       *
+ *   PROC_REDUCE_PHASE    reduction of the processes                                *
+ *   FINAL_PHASE          last operations of the algorithm                          *
+ *                                                                                  *
+ * A phase without marks in an algorithm is added to the next marked phase. A mark  *
+ * is two clock reads, and nothing is done without the -phases option. The times    *
+ * of all the threads are gathered in process 0 to get the minimum, mean and        *
+ * maximum of every phase and its imbalance (maximum / mean).                       *
+ *                                                                                  *
+ * With the -counters option every mark also reads the hardware counters of the     *
+ * thread (see common/hardware_counters.c), and the first process of every node     *
+ * measures the energy of the node between init_phase_times and gather_phase_times. *
+ *                                                                                  *
+ ************************************************************************************/
+
+
+struct thread_times {
+    double last_wall;
+    double last_cpu;
+    double last_counters[NUM_COUNTERS];
+    int counters_fd;
+    double times[NUM_PHASES][VALUES_PER_PHASE];
+    char padding[64];                                   // no false sharing between threads
+};
+
+struct phase_summary {
+    double min;
+    double mean;
+    double max;
+    double cpu_mean;
+    double imbalance;
+};
+
+static const char *phase_names[NUM_PHASES] = {"seed", "sum", "thread_reduce", "proc_reduce", "final"};
+
+static struct thread_times *thread_times = NULL;
+static int timed_threads = 0;
+static int timed_procs = 0;
+static int all_threads = 0;                             // threads of every process in all_times
+static double *all_times = NULL;                        // process 0: times of every thread of every process
+static double *all_joules = NULL;                       // process 0: energy measured by every process
+static bool energy_leader = false;
+static struct phase_summary summaries[NUM_PHASES];
+
+
+static double wall_clock(){
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec / 1.e9;
+}
+
+static double cpu_clock(){
+    struct timespec now;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &now);
+    return now.tv_sec + now.tv_nsec / 1.e9;
+}
+
+/*
+ * Starts the clocks of the num_threads threads of the process
+ */
+void init_phase_times(MPI_Comm comm, int num_threads){
+    int proc_id, node_rank;
+    MPI_Comm node_comm;
+
+    if (!options.phase_times && !options.counters) return;
+
+    //The times of a previous run of the same job are discarded
+    free(thread_times);
+    free(all_times);
+    free(all_joules);
+    all_times = all_joules = NULL;
+
+    timed_threads = num_threads;
+    thread_times = calloc(num_threads, sizeof(struct thread_times));
+
+    //The first process of every node measures its energy
+    if (options.counters) {
+        MPI_Comm_rank(comm, &proc_id);
+        MPI_Comm_split_type(comm, MPI_COMM_TYPE_SHARED, proc_id, MPI_INFO_NULL, &node_comm);
+        MPI_Comm_rank(node_comm, &node_rank);
+        MPI_Comm_free(&node_comm);
+        energy_leader = (node_rank == 0);
+        if (energy_leader) start_node_energy();
+    }
+
+    #pragma omp parallel num_threads(num_threads)
+    {
+        int thread_id = omp_get_thread_num();
+        thread_times[thread_id].counters_fd = (options.counters) ? open_thread_counters() : -1;
+        read_thread_counters(thread_times[thread_id].counters_fd, thread_times[thread_id].last_counters);
+        thread_times[thread_id].last_wall = wall_clock();
+        thread_times[thread_id].last_cpu = cpu_clock();
+    }
+}
+
+/*
+ * Adds the time since the last mark of the calling thread to phase.
+ * Nested parallel regions (the parallel products) are not marked.
+ */
+void mark_phase(enum phase phase){
+    int thread_id, i;
+    double wall, cpu, counters[NUM_COUNTERS];
+    struct thread_times *times;
+
+    if (thread_times == NULL || omp_get_level() > 1) return;
+    thread_id = omp_get_thread_num();
+    if (thread_id >= timed_threads) return;
+
+    wall = wall_clock();
+    cpu = cpu_clock();
+    times = &thread_times[thread_id];
+    times -> times[phase][0] += wall - times -> last_wall;
+    times -> times[phase][1] += cpu - times -> last_cpu;
+    times -> times[phase][2] += 1;
+    times -> last_wall = wall;
+    times -> last_cpu = cpu;
+    if (times -> counters_fd >= 0) {
+        read_thread_counters(times -> counters_fd, counters);
+        for (i = 0; i < NUM_COUNTERS; i++) {
+            times -> times[phase][3 + i] += counters[i] - times -> last_counters[i];
+            times -> last_counters[i] = counters[i];
+        }
+    }
+}
+
+/*
+ * Gathers the times of every thread in process 0 and computes the summary of every phase
+ */
+void gather_phase_times(MPI_Comm comm, int num_procs, int proc_id){
+    int i, thread, phase, count;
+    double *local_times, *slot, joules;
+    struct phase_summary *summary;
+
+    if (thread_times == NULL) return;
+
+    //The processes may have different threads (-weighted): all of them send the slots of
+    //the largest number of threads, and the slots of the missing threads have no marks
+    MPI_Allreduce(&timed_threads, &all_threads, 1, MPI_INT, MPI_MAX, comm);
+
+    //The last value of every thread tells if its counters were available (-1 if there is no thread)
+    local_times = calloc(all_threads * THREAD_VALUES, sizeof(double));
+    for (thread = timed_threads; thread < all_threads; thread++) local_times[(thread + 1) * THREAD_VALUES - 1] = -1;
+    for (thread = 0; thread < timed_threads; thread++) {
+        for (phase = 0; phase < NUM_PHASES; phase++) {
+            for (i = 0; i < VALUES_PER_PHASE; i++) {
+                local_times[thread * THREAD_VALUES + phase * VALUES_PER_PHASE + i] = thread_times[thread].times[phase][i];
+            }
+        }
+        local_times[(thread + 1) * THREAD_VALUES - 1] = (thread_times[thread].counters_fd >= 0);
+        close_thread_counters(thread_times[thread].counters_fd);
+    }
+    joules = (energy_leader) ? stop_node_energy() : -1;      // the energy of the node is only measured by its first process
+
+    timed_procs = num_procs;
+    if (proc_id == 0) {
+        all_times = malloc(num_procs * all_threads * THREAD_VALUES * sizeof(double));
+        all_joules = malloc(num_procs * sizeof(double));
+    }
+    MPI_Gather(local_times, all_threads * THREAD_VALUES, MPI_DOUBLE, all_times, all_threads * THREAD_VALUES, MPI_DOUBLE, 0, comm);
+    MPI_Gather(&joules, 1, MPI_DOUBLE, all_joules, 1, MPI_DOUBLE, 0, comm);
+    free(local_times);
+    if (proc_id != 0) return;
+
+    //Only the threads that marked a phase are taken into account for it
+    for (phase = 0; phase < NUM_PHASES; phase++) {
+        summary = &summaries[phase];
+        summary -> min = summary -> mean = summary -> max = summary -> cpu_mean = summary -> imbalance = 0;
+        count = 0;
+        for (thread = 0; thread < num_procs * all_threads; thread++) {
+            slot = all_times + thread * THREAD_VALUES + phase * VALUES_PER_PHASE;
+            if (slot[2] == 0) continue;
+            if (count == 0 || slot[0] < summary -> min) summary -> min = slot[0];
+            if (count == 0 || slot[0] > summary -> max) summary -> max = slot[0];
+            summary -> mean += slot[0];
+            summary -> cpu_mean += slot[1];
+            count++;
+        }
+        if (count == 0) continue;
+        summary -> mean /= count;
+        summary -> cpu_mean /= count;
+        summary -> imbalance = (summary -> mean > 0) ? summary -> max / summary -> mean : 1;
+    }
+}
+
+/*
+ * Adds the counters of every thread and phase of the process proc in totals.
+ * It returns false if the counters of some thread were not available.
+ */
+static bool process_counters(int proc, double *totals){
+    int thread, phase, i;
+    double *slot;
+
+    for (i = 0; i < NUM_COUNTERS; i++) totals[i] = 0;
+    for (thread = proc * all_threads; thread < (proc + 1) * all_threads; thread++) {
+        slot = all_times + thread * THREAD_VALUES;
+        if (slot[THREAD_VALUES - 1] < 0) continue;
+        if (slot[THREAD_VALUES - 1] == 0) return false;
+        for (phase = 0; phase < NUM_PHASES; phase++) {
+            for (i = 0; i < NUM_COUNTERS; i++) totals[i] += slot[phase * VALUES_PER_PHASE + 3 + i];
+        }
+    }
+    return true;
+}
+
+/*
+ * Prints the summary of every phase and the counters of every process (process 0)
+ */
+void print_phase_times(){
+    int phase, proc;
+    double totals[NUM_COUNTERS];
+
+    if (all_times == NULL) return;
+    if (options.phase_times) {
+        printf("  Phase times (min / mean / max wall seconds, mean cpu seconds, imbalance): \n");
+        for (phase = 0; phase < NUM_PHASES; phase++) {
+            printf("      %-14s %f / %f / %f, %f, %.3f \n", phase_names[phase], summaries[phase].min, summaries[phase].mean, 
+                    summaries[phase].max, summaries[phase].cpu_mean, summaries[phase].imbalance);
+        }
+    }
+    if (options.counters) {
+        printf("  Hardware counters (cycles, instructions, IPC, LLC misses, joules of the node): \n");
+        for (proc = 0; proc < timed_procs; proc++) {
+            if (process_counters(proc, totals)) {
+                printf("      process %d: %.0f, %.0f, %.3f, %.0f, ", proc, totals[0], totals[1], 
+                        (totals[0] > 0) ? totals[1] / totals[0] : 0, totals[2]);
+            } else {
+                printf("      process %d: not available, ", proc);
+            }
+            if (all_joules[proc] < 0) printf("not available \n");
+            else printf("%f \n", all_joules[proc]);
+        }
+    }
+}
+
+/*
+ * Prints the summary of every phase as csv fields: min;mean;max;cpu_mean;imbalance; and the
+ * counters of every process as cycles;instructions;llc_misses;joules; (process 0)
+ */
+void print_phase_times_csv(){
+    int phase, proc;
+    double totals[NUM_COUNTERS];
+
+    if (all_times == NULL) return;
+    if (options.phase_times) {
+        for (phase = 0; phase < NUM_PHASES; phase++) {
+            printf("%f;%f;%f;%f;%f;", summaries[phase].min, summaries[phase].mean, 
+                    summaries[phase].max, summaries[phase].cpu_mean, summaries[phase].imbalance);
+        }
+    }
+    if (options.counters) {
+        for (proc = 0; proc < timed_procs; proc++) {
+            if (process_counters(proc, totals)) printf("%.0f;%.0f;%.0f;", totals[0], totals[1], totals[2]);
+            else printf("-1;-1;-1;");
+            printf("%f;", all_joules[proc]);
+        }
+    }
+}
+
+/*
+ * Writes the summary and the times of every thread of every process in the json file path (process 0)
+ */
+void write_phase_times_json(char *path, char *library, char *algorithm_tag, long precision, double execution_time){
+    int proc, thread, phase, i;
+    double *slot;
+    FILE *file;
+
+    if (all_times == NULL) return;
+    file = fopen(path, "w");
+    if (file == NULL) {
+        printf("  The file %s can not be written \n", path);
+        exit(-1);
+    }
+
+    fprintf(file, "{\n  \"library\": \"%s\",\n  \"algorithm\": \"%s\",\n  \"precision\": %ld,\n", library, algorithm_tag, precision);
+    fprintf(file, "  \"processes\": %d,\n  \"threads\": %d,\n  \"execution_time\": %f,\n", timed_procs, all_threads, execution_time);
+    fprintf(file, "  \"phases\": {\n");
+    for (phase = 0; phase < NUM_PHASES; phase++) {
+        fprintf(file, "    \"%s\": {\"min\": %f, \"mean\": %f, \"max\": %f, \"cpu_mean\": %f, \"imbalance\": %f}%s\n", 
+                phase_names[phase], summaries[phase].min, summaries[phase].mean, summaries[phase].max, 
+                summaries[phase].cpu_mean, summaries[phase].imbalance, (phase < NUM_PHASES - 1) ? "," : "");
+    }
+    if (options.counters) {
+        fprintf(file, "  },\n  \"joules\": [");
+        for (proc = 0; proc < timed_procs; proc++) fprintf(file, "%f%s", all_joules[proc], (proc < timed_procs - 1) ? ", " : "");
+        fprintf(file, "],\n");
+    } else {
+        fprintf(file, "  },\n");
+    }
+
+    //Every phase of a thread is [wall, cpu] or [wall, cpu, cycles, instructions, llc_misses]
+    fprintf(file, "  \"threads_times\": [\n");
+    for (proc = 0; proc < timed_procs; proc++) {
+        for (thread = 0; thread < all_threads; thread++) {
+            fprintf(file, "    {\"process\": %d, \"thread\": %d", proc, thread);
+            for (phase = 0; phase < NUM_PHASES; phase++) {
+                slot = all_times + (proc * all_threads + thread) * THREAD_VALUES + phase * VALUES_PER_PHASE;
+                fprintf(file, ", \"%s\": [%f, %f", phase_names[phase], slot[0], slot[1]);
+                if (options.counters) {
+                    for (i = 0; i < NUM_COUNTERS; i++) fprintf(file, ", %.0f", slot[3 + i]);
+                }
+                fprintf(file, "]");
+            }
+            fprintf(file, "}%s\n", (proc == timed_procs - 1 && thread == all_threads - 1) ? "" : ",");
+        }
+    }
+    fprintf(file, "  ]\n}\n");
+    fclose(file);
+}
+
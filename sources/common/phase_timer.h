@@ -0,0 +1,23 @@
+#ifndef PHASE_TIMER
+#define PHASE_TIMER
+
+#include "mpi.h"
+
+enum phase {
+    SEED_PHASE,
+    SUM_PHASE,
+    THREAD_REDUCE_PHASE,
+    PROC_REDUCE_PHASE,
+    FINAL_PHASE,
+    NUM_PHASES
+};
+
+void init_phase_times(MPI_Comm, int);
+void mark_phase(enum phase);
+void gather_phase_times(MPI_Comm, int, int);
+void print_phase_times();
+void print_phase_times_csv();
+void write_phase_times_json(char *, char *, char *, long, double);
+
+#endif
+
@@ -0,0 +1,98 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <sched.h>
+#include <omp.h>
+#include "placement.h"
+
+#define MAX_NODES 64
+
+
+/************************************************************************************
+ * NUMA aware placement of the threads                                              *
+ *                                                                                  *
+ ************************************************************************************
+ * The threads of the process are bound to the CPUs allowed to the process (the     *
+ * ones given by mpirun --bind-to socket or --bind-to none), ordered by NUMA node:  *
+ * thread 0 gets the first CPU of the first node, and the threads are placed        *
+ * compactly until the node is full. Therefore:                                     *
+ *                                                                                  *
+ *   - With one rank per socket every rank keeps its threads in its socket.         *
+ *   - With one rank per node the threads of a socket have consecutive ids.         *
+ *                                                                                  *
+ * OpenMP reuses the threads of a team, so the binding lasts for all the parallel   *
+ * regions. The numbers of every thread are allocated inside the parallel regions   *
+ * by the thread that uses them, so they are placed in its node by the first touch  *
+ * policy of Linux. As the threads of a node have consecutive ids, the binary tree  *
+ * of reduce_threads_gmp and reduce_threads_mpfr first adds the partial sums of     *
+ * each socket and only the last steps cross sockets, before the MPI reduction.     *
+ *                                                                                  *
+ ************************************************************************************/
+
+
+/*
+ * NUMA node of a cpu according to sysfs, or 0 if it is not known
+ */
+static int cpu_node(int cpu){
+    int node;
+    char path[128];
+    FILE *file;
+
+    for (node = 0; node < MAX_NODES; node++) {
+        sprintf(path, "/sys/devices/system/cpu/cpu%d/node%d", cpu, node);
+        file = fopen(path, "r");
+        if (file != NULL) {
+            fclose(file);
+            return node;
+        }
+    }
+    return 0;
+}
+
+/*
+ * Binds the threads used by the algorithms to the CPUs of the process
+ */
+void place_threads(int num_threads){
+    int cpu, node, i, num_cpus, num_allowed, *allowed_cpus, *nodes, *cpus;
+    cpu_set_t allowed;
+
+    if (sched_getaffinity(0, sizeof(cpu_set_t), &allowed) != 0) return;
+    num_allowed = CPU_COUNT(&allowed);
+    allowed_cpus = malloc(num_allowed * sizeof(int));
+    nodes = malloc(num_allowed * sizeof(int));
+    cpus = malloc(num_allowed * sizeof(int));
+
+    //Find the node of every allowed CPU
+    i = 0;
+    for (cpu = 0; cpu < CPU_SETSIZE && i < num_allowed; cpu++) {
+        if (CPU_ISSET(cpu, &allowed)) {
+            allowed_cpus[i] = cpu;
+            nodes[i] = cpu_node(cpu);
+            i++;
+        }
+    }
+
+    //List the allowed CPUs ordered by NUMA node
+    num_cpus = 0;
+    for (node = 0; node < MAX_NODES && num_cpus < num_allowed; node++) {
+        for (i = 0; i < num_allowed; i++) {
+            if (nodes[i] == node) cpus[num_cpus++] = allowed_cpus[i];
+        }
+    }
+
+    omp_set_num_threads(num_threads);
+
+    #pragma omp parallel
+    {
+        cpu_set_t mask;
+
+        CPU_ZERO(&mask);
+        CPU_SET(cpus[omp_get_thread_num() % num_cpus], &mask);
+        sched_setaffinity(0, sizeof(cpu_set_t), &mask);
+    }
+
+    free(allowed_cpus);
+    free(nodes);
+    free(cpus);
+}
+
@@ -0,0 +1,7 @@
+#ifndef PLACEMENT
+#define PLACEMENT
+
+void place_threads(int);
+
+#endif
+
@@ -0,0 +1,126 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "planner.h"
+
+#define LOG2_10 3.321928094887362
+#define GUARD_BITS 64
+#define NUMBERS_PER_THREAD 12         // partial sum, dependencies, quotients and auxiliaries
+#define NUMBERS_PER_PROCESS 8         // pi, transport and reduction buffers and constants
+
+
+/************************************************************************************
+ * Precision planner                                                                *
+ * It derives the number of bits of the mantissas and the number of iterations      *
+ * needed to get the requested decimals from the error bounds of every series.      *
+ *                                                                                  *
+ ************************************************************************************
+ * Bits needed for d decimals:                                                      *
+ *      bits = ceil(d log2(10)) + guard                                             *
+ *                                                                                  *
+ * The guard bits cover the rounding errors: every one of the N terms adds an       *
+ * error below 2^-bits, so the sum loses at most log2(N) bits, and the last         *
+ * operations (sqrt, division) lose a few more.                                     *
+ *                                                                                  *
+ ************************************************************************************
+ * Iterations needed to keep the truncation error of the series below 2^-bits:      *
+ *                                                                                  *
+ *   BBP:         |term(n)| < 4 / 16^n           ->  tail(N) < 2^(2 - 4N)           *
+ *                                                                                  *
+ *   Bellard:     |term(n)| < 2^9 / 1024^n       ->  tail(N) / 64 < 2^(4 - 10N)     *
+ *                                                                                  *
+ *   Chudnovsky:  |term(n + 1) / term(n)| < 1 / 151931373056000 = 2^-47.11          *
+ *                and the sum is greater than its first term, so its relative       *
+ *                error after N terms is below 2^(1 - 47.11N)                       *
+ *                                                                                  *
+ *   Machin-like: 1/((2n+1) k^(2n+1)) < 2^-bits when n > bits / (2 log2(k)), and  *
+ *                the slowest arctan is 1/49 (Takano) or 1/57 (Stormer)             *
+ *                                                                                  *
+ *   Gauss-Legendre: the error after N iterations of the AGM is below               *
+ *                pi^2 2^(N+4) e^(-pi 2^(N+1)) = 2^(N + 7.3 - 9.06 2^N)             *
+ *                                                                                  *
+ ************************************************************************************/
+
+
+/*
+ * Number of terms of the series needed to get an error below 2^-bits
+ */
+static long series_iterations(long bits, enum series series){
+    switch (series) {
+    case BBP_SERIES:
+        return (long) ceil((bits + 2) / 4.0);
+    case BELLARD_SERIES:
+        return (long) ceil((bits + 4) / 10.0);
+    case TAKANO_SERIES:
+        return (long) ceil(bits / 11.23) + 1;
+    case STORMER_SERIES:
+        return (long) ceil(bits / 11.67) + 1;
+    case GAUSS_LEGENDRE_AGM:
+        return (long) ceil(log2((bits + 16) / 9.06));
+    case CHUDNOVSKY_SERIES:
+    default:
+        return (long) ceil((bits + 1) / 47.11);
+    }
+}
+
+/*
+ * Returns the precision (in bits) and the number of iterations needed to compute
+ * pi with precision decimals using series, and the bits of the truncation error
+ */
+struct plan plan_pi(long precision, enum series series){
+    struct plan plan;
+    long bits;
+
+    bits = (long) ceil(precision * LOG2_10) + GUARD_BITS;
+    plan.num_iterations = series_iterations(bits, series);
+    plan.precision_bits = bits + (long) ceil(log2(plan.num_iterations + 1));
+    plan.target_bits = bits;
+
+    return plan;
+}
+
+/*
+ * Returns the fraction bits and the number of iterations needed to compute
+ * length hex digits of pi after the position start with the BBP series.
+ * Every iteration before start adds its error to the fraction, as in plan_pi.
+ */
+struct plan plan_hex_window(long length, long start){
+    struct plan plan;
+    long bits;
+
+    bits = 4 * length + GUARD_BITS;
+    plan.num_iterations = start + series_iterations(bits, BBP_SERIES);
+    plan.precision_bits = bits + (long) ceil(log2(plan.num_iterations + 1));
+    plan.target_bits = bits;
+
+    return plan;
+}
+
+/*
+ * Estimate of the bytes used by every process to compute pi with precision decimals
+ * and num_threads threads: every thread keeps NUMBERS_PER_THREAD numbers and the
+ * process NUMBERS_PER_PROCESS numbers of the full precision
+ */
+long plan_memory(long precision, int num_threads){
+    long number_bytes;
+
+    number_bytes = (long) ceil((precision * LOG2_10 + GUARD_BITS) / 8);
+    return number_bytes * (NUMBERS_PER_THREAD * (long) num_threads + NUMBERS_PER_PROCESS);
+}
+
+/*
+ * Reads a precision given in decimals or in bits with the suffix b (332193b).
+ * It returns the decimals needed to keep those bits, or 0 if it is not correct.
+ */
+long parse_precision(char *arg){
+    long value;
+    char *end;
+
+    value = strtol(arg, &end, 10);
+    if (end == arg || value <= 0) return 0;
+    if (*end == '\0') return value;
+    if (strcmp(end, "b") == 0) return (long) ceil(value / LOG2_10);
+    return 0;
+}
+
@@ -0,0 +1,24 @@
+#ifndef PLANNER
+#define PLANNER
+
+enum series {
+    BBP_SERIES,
+    BELLARD_SERIES,
+    CHUDNOVSKY_SERIES,
+    TAKANO_SERIES,
+    STORMER_SERIES,
+    GAUSS_LEGENDRE_AGM
+};
+
+struct plan {
+    long precision_bits;
+    long num_iterations;
+    long target_bits;
+};
+
+struct plan plan_pi(long, enum series);
+struct plan plan_hex_window(long, long);
+long plan_memory(long, int);
+long parse_precision(char *);
+
+#endif
@@ -1,7 +1,11 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdbool.h>
 #include "mpi.h"
+#include "phase_timer.h"
+#include "planner.h"
+#include "large_buffer.h"
 
 
 void print_title(){
@@ -21,43 +25,90 @@ void print_title(){
     fclose(file);
 }
 
-void check_errors(int num_procs, int precision, int num_iterations, int num_threads, int proc_id){
+/*
+ * Finishes the job after an error found by every process of comm. If comm is only a
+ * group of the processes the other groups are still running, so the whole job is aborted.
+ */
+static void stop_job(MPI_Comm comm){
+    int result;
+
+    MPI_Comm_compare(comm, MPI_COMM_WORLD, &result);
+    if (result != MPI_IDENT && result != MPI_CONGRUENT) {
+        fflush(stdout);
+        MPI_Abort(MPI_COMM_WORLD, -1);
+    }
+    MPI_Finalize();
+    exit(-1);
+}
+
+void check_errors(MPI_Comm comm, int num_procs, long precision, long num_iterations, int num_threads, int proc_id){
+    int node_procs, enough_memory;
+    double memory;
+    MPI_Comm node_comm;
+
     if (precision <= 0){
         if(proc_id == 0) printf("  Precision should be greater than cero. \n\n");
-        MPI_Finalize();
-        exit(-1);
+        stop_job(comm);
     } 
-    if (num_iterations < (num_threads * num_procs)){
+    if (num_iterations < ((long) num_threads * num_procs)){
         if(proc_id == 0){
             printf("  The number of iterations required for the computation is too small to be solved with %d threads and %d procesess. \n", num_threads, num_procs);
             printf("  Try using a greater precision or lower threads/processes number. \n\n");
         }
-        MPI_Finalize();
-        exit(-1);
+        stop_job(comm);
+    }
+
+    //The processes of every node should fit in the memory of the node
+    MPI_Comm_split_type(comm, MPI_COMM_TYPE_SHARED, proc_id, MPI_INFO_NULL, &node_comm);
+    MPI_Comm_size(node_comm, &node_procs);
+    MPI_Comm_free(&node_comm);
+    memory = (double) plan_memory(precision, num_threads) * node_procs;
+    enough_memory = (memory <= (double) physical_memory());
+    MPI_Allreduce(MPI_IN_PLACE, &enough_memory, 1, MPI_INT, MPI_LAND, comm);
+    if (!enough_memory){
+        if(proc_id == 0){
+            printf("  The computation needs about %.2f GiB per node and the node has %.2f GiB of memory. \n", 
+                        memory / (1L << 30), (double) physical_memory() / (1L << 30));
+            printf("  Try using a lower precision, less threads per process or less processes per node. \n\n");
+        }
+        stop_job(comm);
     }
 }
 
-void print_results(char *library, char *algorithm_tag, int precision, int num_iterations, int num_procs, int num_threads, int decimals_computed, double execution_time) {
+/*
+ * Finishes the job if the option given is not supported by the algorithm selected
+ */
+void check_option(MPI_Comm comm, bool supported, char *option, int proc_id){
+    if (!supported){
+        if(proc_id == 0) printf("  The option %s is not supported by the algorithm selected. \n\n", option);
+        stop_job(comm);
+    }
+}
+
+void print_results(char *library, char *algorithm_tag, long precision, long num_iterations, int num_procs, int num_threads, long decimals_computed, double execution_time) {
     printf("  Library used: %s \n", library);
     printf("  Algorithm: %s \n", algorithm_tag);
-    printf("  Precision used: %d \n", precision);
-    printf("  Number of iterations: %d \n", num_iterations);
+    printf("  Precision used: %ld \n", precision);
+    printf("  Number of iterations: %ld \n", num_iterations);
     printf("  Number of processes: %d\n", num_procs);
     printf("  Number of threads (per process): %d\n", num_threads);
-    if (decimals_computed >= precision) { printf("  Correct decimals: %d \n", decimals_computed); } 
-    else { printf("  Something went wrong. The execution just achieved %d decimals \n", decimals_computed); }
+    if (decimals_computed >= precision) { printf("  Correct decimals: %ld \n", decimals_computed); } 
+    else { printf("  Something went wrong. The execution just achieved %ld decimals \n", decimals_computed); }
     printf("  Execution time: %f seconds \n", execution_time);
+    print_phase_times();
     printf("\n");
 }
 
-void print_results_csv(char *library, char *algorithm_tag, int precision, int num_iterations, int num_procs, int num_threads, int decimals_computed, double execution_time) {
+void print_results_csv(char *library, char *algorithm_tag, long precision, long num_iterations, int num_procs, int num_threads, long decimals_computed, double execution_time) {
     printf("MPI;");
     printf("%s;", library);
     printf("%s;", algorithm_tag);
-    printf("%d;", precision);
-    printf("%d;", num_iterations);
+    printf("%ld;", precision);
+    printf("%ld;", num_iterations);
     printf("%d;", num_procs);
     printf("%d;", num_threads);
-    printf("%d;", decimals_computed);
-    printf("%f;\n", execution_time);
+    printf("%ld;", decimals_computed);
+    printf("%f;", execution_time);
+    print_phase_times_csv();
+    printf("\n");
 }
@@ -1,9 +1,12 @@
 #ifndef PRINTER
 #define PRINTER
 
+#include <stdbool.h>
+
 void print_title();
-void print_results(char *, char *, int, int, int, int, int, double);
-void print_results_csv(char *, char *, int, int, int, int, int, double);
-void check_errors(int, int, int, int, int);
+void print_results(char *, char *, long, long, int, int, long, double);
+void print_results_csv(char *, char *, long, long, int, int, long, double);
+void check_errors(MPI_Comm, int, long, long, int, int);
+void check_option(MPI_Comm, bool, char *, int);
 
 #endif
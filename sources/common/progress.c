@@ -0,0 +1,293 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <time.h>
+#include <errno.h>
+#include <pthread.h>
+#include <omp.h>
+#include "mpi.h"
+#include "options.h"
+#include "progress.h"
+
+#define PROGRESS_TAG 1                  // iterations done by a process
+#define FINAL_PROGRESS_TAG 2            // iterations done by a process that has finished
+#define POLL_SECONDS 0.1                // time between two probes of the messages in process 0
+
+
+/************************************************************************************
+ * Live progress of the computation (-progress=S)                                   *
+ *                                                                                  *
+ ************************************************************************************
+ * Every thread adds the iterations it completes to its own counter (one cache line *
+ * per thread, so the threads never share a line), with a relaxed atomic addition   *
+ * and no synchronization with the other threads.                                   *
+ *                                                                                  *
+ * One progress thread per process adds the counters of its threads every S         *
+ * seconds and sends the total to process 0 with MPI_Isend through a duplicate of   *
+ * the communicator of the run. A send is only started when the previous one has    *
+ * finished, so a busy process skips reports instead of queueing them. The compute  *
+ * threads never wait for the progress thread or for the messages.                  *
+ *                                                                                  *
+ * The progress thread of process 0 receives the totals of the processes and        *
+ * reports every S seconds the iterations done, the iterations per second, the      *
+ * estimated time remaining and the process with the largest lag (iterations below  *
+ * the mean of the processes) to stderr. With -progress_file=FILE the same values   *
+ * and the iterations, lag and age of the last report of every process are written  *
+ * in FILE in the Prometheus text format, through a temporary file and a rename.    *
+ *                                                                                  *
+ * The progress thread calls MPI while the compute threads may call it, so the      *
+ * option needs MPI_THREAD_MULTIPLE, which is only requested when it is given.      *
+ *                                                                                  *
+ ************************************************************************************/
+
+
+struct progress_counter {
+    long done;
+    char padding[64 - sizeof(long)];                    // no false sharing between threads
+};
+
+static struct progress_counter *counters = NULL;
+static int counted_threads = 0;
+
+static MPI_Comm progress_comm;
+static int progress_procs, progress_id;
+static long progress_iterations;
+static double start_time;
+static long *proc_done = NULL;                          // process 0: last total of every process
+static double *proc_seen = NULL;                        // process 0: time of the last total of every process
+
+static pthread_t progress_thread;
+static pthread_mutex_t progress_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t progress_stopped = PTHREAD_COND_INITIALIZER;
+static bool stopping = false;
+
+
+static double wall_clock(){
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec + now.tv_nsec / 1.e9;
+}
+
+/*
+ * Waits seconds or until stop_progress is called. It returns true if it was called.
+ */
+static bool wait_or_stop(double seconds){
+    struct timespec deadline;
+    bool stop;
+
+    clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_sec += (time_t) seconds;
+    deadline.tv_nsec += (long) ((seconds - (time_t) seconds) * 1.e9);
+    if (deadline.tv_nsec >= 1000000000L) {
+        deadline.tv_sec++;
+        deadline.tv_nsec -= 1000000000L;
+    }
+
+    pthread_mutex_lock(&progress_lock);
+    while (!stopping && pthread_cond_timedwait(&progress_stopped, &progress_lock, &deadline) != ETIMEDOUT);
+    stop = stopping;
+    pthread_mutex_unlock(&progress_lock);
+    return stop;
+}
+
+/*
+ * Iterations done by all the threads of the process
+ */
+static long local_progress(){
+    int thread;
+    long done = 0;
+
+    for (thread = 0; thread < counted_threads; thread++) {
+        done += __atomic_load_n(&counters[thread].done, __ATOMIC_RELAXED);
+    }
+    return done;
+}
+
+static void write_progress_file(char *path, long done, double rate, double seconds_left, double now, double mean){
+    int proc;
+    char temporary_path[4112];
+    FILE *file;
+
+    snprintf(temporary_path, sizeof(temporary_path), "%s.tmp", path);
+    file = fopen(temporary_path, "w");
+    if (file == NULL) {
+        fprintf(stderr, "  The progress file %s can not be written \n", temporary_path);
+        return;
+    }
+    fprintf(file, "# TYPE pidecimals_iterations_done gauge\npidecimals_iterations_done %ld\n", done);
+    fprintf(file, "# TYPE pidecimals_iterations_total gauge\npidecimals_iterations_total %ld\n", progress_iterations);
+    fprintf(file, "# TYPE pidecimals_iterations_per_second gauge\npidecimals_iterations_per_second %.3f\n", rate);
+    fprintf(file, "# TYPE pidecimals_seconds_left gauge\npidecimals_seconds_left %.3f\n", seconds_left);
+    fprintf(file, "# TYPE pidecimals_elapsed_seconds gauge\npidecimals_elapsed_seconds %.3f\n", now - start_time);
+    fprintf(file, "# TYPE pidecimals_rank_iterations_done gauge\n");
+    for (proc = 0; proc < progress_procs; proc++) {
+        fprintf(file, "pidecimals_rank_iterations_done{rank=\"%d\"} %ld\n", proc, proc_done[proc]);
+    }
+    fprintf(file, "# TYPE pidecimals_rank_lag_iterations gauge\n");
+    for (proc = 0; proc < progress_procs; proc++) {
+        fprintf(file, "pidecimals_rank_lag_iterations{rank=\"%d\"} %.1f\n", proc, mean - proc_done[proc]);
+    }
+    fprintf(file, "# TYPE pidecimals_rank_report_age_seconds gauge\n");
+    for (proc = 0; proc < progress_procs; proc++) {
+        fprintf(file, "pidecimals_rank_report_age_seconds{rank=\"%d\"} %.3f\n", proc, now - proc_seen[proc]);
+    }
+    fclose(file);
+    if (rename(temporary_path, path) != 0) {
+        fprintf(stderr, "  The progress file %s can not be written \n", path);
+    }
+}
+
+/*
+ * Reports the progress of all the processes received by process 0
+ */
+static void report_progress(bool finished){
+    int proc, slowest;
+    long done;
+    double now, rate, seconds_left, mean;
+
+    now = wall_clock();
+    proc_done[0] = local_progress();
+    proc_seen[0] = now;
+
+    done = 0;
+    slowest = 0;
+    for (proc = 0; proc < progress_procs; proc++) {
+        done += proc_done[proc];
+        if (proc_done[proc] < proc_done[slowest]) slowest = proc;
+    }
+    mean = (double) done / progress_procs;
+    rate = (now > start_time) ? done / (now - start_time) : 0;
+    seconds_left = (rate > 0 && done < progress_iterations) ? (progress_iterations - done) / rate : 0;
+
+    fprintf(stderr, "  Progress: %6.2f%% %ld/%ld iterations  %.1f it/s  %s %.0f s  slowest process %d (%.0f iterations below the mean) \n",
+                (progress_iterations > 0) ? 100. * done / progress_iterations : 100., done, progress_iterations, rate,
+                (finished) ? "elapsed" : "ETA", (finished) ? now - start_time : seconds_left, slowest, mean - proc_done[slowest]);
+    if (options.progress_file != NULL) write_progress_file(options.progress_file, done, rate, seconds_left, now, mean);
+}
+
+/*
+ * Progress thread of process 0: receives the totals of the processes until all of them
+ * have finished and reports them every progress interval
+ */
+static void * collect_progress(void *arg){
+    int flag, finished_procs = 0;
+    long done;
+    double next_report;
+    bool stop = false;
+    struct timespec final_poll = {0, 10000000};        // 10 ms while the last totals arrive
+    MPI_Status status;
+
+    (void) arg;
+    next_report = start_time + options.progress_interval;
+    while (!stop || finished_procs < progress_procs - 1) {
+        MPI_Iprobe(MPI_ANY_SOURCE, MPI_ANY_TAG, progress_comm, &flag, &status);
+        while (flag) {
+            MPI_Recv(&done, 1, MPI_LONG, status.MPI_SOURCE, status.MPI_TAG, progress_comm, MPI_STATUS_IGNORE);
+            proc_done[status.MPI_SOURCE] = done;
+            proc_seen[status.MPI_SOURCE] = wall_clock();
+            if (status.MPI_TAG == FINAL_PROGRESS_TAG) finished_procs++;
+            MPI_Iprobe(MPI_ANY_SOURCE, MPI_ANY_TAG, progress_comm, &flag, &status);
+        }
+        if (!stop && wall_clock() >= next_report) {
+            report_progress(false);
+            next_report += options.progress_interval;
+        }
+        if (!stop) stop = wait_or_stop(POLL_SECONDS);
+        else nanosleep(&final_poll, NULL);
+    }
+    report_progress(true);
+    return NULL;
+}
+
+/*
+ * Progress thread of the other processes: sends the total of the process every
+ * progress interval if the previous send has finished, and the last total at the end
+ */
+static void * send_progress(void *arg){
+    int sent;
+    long done;
+    bool pending = false;
+    MPI_Request request;
+
+    (void) arg;
+    while (!wait_or_stop(options.progress_interval)) {
+        if (pending) {
+            MPI_Test(&request, &sent, MPI_STATUS_IGNORE);
+            pending = !sent;
+        }
+        if (!pending) {
+            done = local_progress();
+            MPI_Isend(&done, 1, MPI_LONG, 0, PROGRESS_TAG, progress_comm, &request);
+            pending = true;
+        }
+    }
+    if (pending) MPI_Wait(&request, MPI_STATUS_IGNORE);
+    done = local_progress();
+    MPI_Send(&done, 1, MPI_LONG, 0, FINAL_PROGRESS_TAG, progress_comm);
+    return NULL;
+}
+
+/*
+ * Starts counting the iterations of the num_threads threads of the process and the
+ * progress thread of the process in a run of num_iterations iterations
+ */
+void start_progress(MPI_Comm comm, long num_iterations, int num_threads, int proc_id){
+    int thread_level, thread, proc;
+
+    if (options.progress_interval <= 0) return;
+    MPI_Query_thread(&thread_level);
+    if (thread_level < MPI_THREAD_MULTIPLE) {
+        if (proc_id == 0) fprintf(stderr, "  The MPI library does not support MPI_THREAD_MULTIPLE, the progress is not reported \n");
+        return;
+    }
+
+    MPI_Comm_dup(comm, &progress_comm);
+    MPI_Comm_size(progress_comm, &progress_procs);
+    progress_id = proc_id;
+    progress_iterations = num_iterations;
+    start_time = wall_clock();
+    stopping = false;
+
+    counted_threads = num_threads;
+    counters = aligned_alloc(sizeof(struct progress_counter), num_threads * sizeof(struct progress_counter));
+    for (thread = 0; thread < num_threads; thread++) counters[thread].done = 0;
+
+    if (proc_id == 0) {
+        proc_done = calloc(progress_procs, sizeof(long));
+        proc_seen = malloc(progress_procs * sizeof(double));
+        for (proc = 0; proc < progress_procs; proc++) proc_seen[proc] = start_time;
+        pthread_create(&progress_thread, NULL, collect_progress, NULL);
+    } else {
+        pthread_create(&progress_thread, NULL, send_progress, NULL);
+    }
+}
+
+/*
+ * Adds iterations to the counter of the calling thread
+ */
+void add_progress(long iterations){
+    if (counters == NULL) return;
+    __atomic_fetch_add(&counters[omp_get_thread_num() % counted_threads].done, iterations, __ATOMIC_RELAXED);
+}
+
+/*
+ * Stops the progress thread after the last report and stops counting
+ */
+void stop_progress(){
+    if (counters == NULL) return;
+
+    pthread_mutex_lock(&progress_lock);
+    stopping = true;
+    pthread_cond_broadcast(&progress_stopped);
+    pthread_mutex_unlock(&progress_lock);
+    pthread_join(progress_thread, NULL);
+
+    MPI_Comm_free(&progress_comm);
+    free(counters);
+    counters = NULL;
+    if (progress_id == 0) {
+        free(proc_done);
+        free(proc_seen);
+    }
+}
+
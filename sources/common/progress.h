@@ -0,0 +1,11 @@
+#ifndef PROGRESS
+#define PROGRESS
+
+#include "mpi.h"
+
+void start_progress(MPI_Comm, long, int, int);
+void add_progress(long);
+void stop_progress();
+
+#endif
+
@@ -0,0 +1,211 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <omp.h>
+#include "result_dump.h"
+
+#define RESULT_DUMP_MAGIC 0x504944554d503032L    // "PIDUMP02"
+#define DUMP_CHUNK_WORDS (1L << 20)             // words written by a thread at once and checked together
+
+
+/************************************************************************************
+ * Binary dump of the results                                                       *
+ *                                                                                  *
+ ************************************************************************************
+ * A dump is a header with the library, the precision in bits, the exponent, the    *
+ * sign, the number of limbs and a checksum, followed by the checksums of the       *
+ * chunks of limbs and the raw limbs of the mantissa (_mp_d of GMP or the           *
+ * significand of MPFR), the least significant first. The meaning of the exponent   *
+ * is the one of the library: limbs for GMP and bits for MPFR.                      *
+ *                                                                                  *
+ * The limbs are written by all the threads of process 0 in chunks at their         *
+ * offsets of the file, which is written in a temporary file and renamed, so a      *
+ * dump is never seen half written.                                                 *
+ *                                                                                  *
+ * The checksum of a chunk is SUM((2i + 1) limb(i)) mod 2^64 over its limbs, with   *
+ * i the position of the limb in the dump, so it detects swapped or shifted limbs.  *
+ * The checksum of the header is the same sum over the checksums of the chunks.     *
+ *                                                                                  *
+ ************************************************************************************
+ * Result cache (-cache=DIR)                                                        *
+ *                                                                                  *
+ * Every verified pi is stored as DIR/pi_<library>_<precision bits>.dump. A run     *
+ * that needs pi with some precision maps the smallest dump of its library with     *
+ * the same or more bits and truncates it, instead of computing it. Only the        *
+ * chunks of the most significant limbs needed are checked and copied, so only      *
+ * their pages are read from the file.                                              *
+ *                                                                                  *
+ ************************************************************************************/
+
+
+static uint64_t limbs_checksum(const uint64_t *limbs, long first, long last){
+    long i;
+    uint64_t checksum = 0;
+
+    for (i = first; i < last; i++) {
+        checksum += (2 * (uint64_t) i + 1) * limbs[i];
+    }
+    return checksum;
+}
+
+static long dump_chunks(long num_limbs){
+    return (num_limbs + DUMP_CHUNK_WORDS - 1) / DUMP_CHUNK_WORDS;
+}
+
+static long chunk_end(long chunk, long num_limbs){
+    return ((chunk + 1) * DUMP_CHUNK_WORDS < num_limbs) ? (chunk + 1) * DUMP_CHUNK_WORDS : num_limbs;
+}
+
+static void dump_error(char *path){
+    printf("  The result dump %s can not be written \n", path);
+    exit(-1);
+}
+
+/*
+ * Writes the num_limbs limbs of a result of library in path
+ */
+void write_result_dump(char *path, char *library, long precision_bits, long exponent, int sign, void *limbs, long num_limbs){
+    int fd;
+    long chunk, num_chunks;
+    bool failed = false;
+    char temporary_path[4112];
+    uint64_t *checksums;
+    size_t limbs_offset;
+    struct result_dump_header header;
+
+    memset(&header, 0, sizeof(header));
+    header.magic = RESULT_DUMP_MAGIC;
+    strncpy(header.library, library, sizeof(header.library) - 1);
+    header.precision_bits = precision_bits;
+    header.exponent = exponent;
+    header.sign = sign;
+    header.num_limbs = num_limbs;
+
+    snprintf(temporary_path, sizeof(temporary_path), "%s.tmp", path);
+    fd = open(temporary_path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0) dump_error(temporary_path);
+
+    //Every thread checks and writes its chunks at their offset
+    num_chunks = dump_chunks(num_limbs);
+    checksums = malloc(num_chunks * sizeof(uint64_t));
+    limbs_offset = sizeof(header) + num_chunks * sizeof(uint64_t);
+    #pragma omp parallel for schedule(dynamic)
+    for (chunk = 0; chunk < num_chunks; chunk++) {
+        size_t bytes, done;
+        ssize_t written;
+        char *start;
+
+        checksums[chunk] = limbs_checksum(limbs, chunk * DUMP_CHUNK_WORDS, chunk_end(chunk, num_limbs));
+        start = (char *) ((uint64_t *) limbs + chunk * DUMP_CHUNK_WORDS);
+        bytes = (chunk_end(chunk, num_limbs) - chunk * DUMP_CHUNK_WORDS) * sizeof(uint64_t);
+        for (done = 0; done < bytes; done += written) {
+            written = pwrite(fd, start + done, bytes - done, limbs_offset + chunk * DUMP_CHUNK_WORDS * sizeof(uint64_t) + done);
+            if (written <= 0) {
+                failed = true;
+                break;
+            }
+        }
+    }
+
+    //The header and the checksums of the chunks are written at the end
+    header.checksum = limbs_checksum(checksums, 0, num_chunks);
+    if (pwrite(fd, &header, sizeof(header), 0) != sizeof(header)) failed = true;
+    if (pwrite(fd, checksums, num_chunks * sizeof(uint64_t), sizeof(header)) != (ssize_t) (num_chunks * sizeof(uint64_t))) failed = true;
+    free(checksums);
+    if (failed || close(fd) != 0) dump_error(temporary_path);
+    if (rename(temporary_path, path) != 0) dump_error(path);
+}
+
+/*
+ * Maps the dump of path in memory if it is a dump of library whose used_limbs most
+ * significant limbs are correct. Only the chunks of these limbs are checked, and
+ * the number of limbs that can be used is left in dump -> used_limbs.
+ */
+bool map_result_dump(struct mapped_result_dump *dump, char *path, char *library, long used_limbs){
+    int fd;
+    long chunk, num_chunks;
+    bool correct = true;
+    uint64_t *checksums;
+    struct stat status;
+
+    fd = open(path, O_RDONLY);
+    if (fd < 0) return false;
+    if (fstat(fd, &status) != 0 || (size_t) status.st_size < sizeof(struct result_dump_header)) {
+        close(fd);
+        return false;
+    }
+    dump -> map_size = status.st_size;
+    dump -> map = mmap(NULL, dump -> map_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (dump -> map == MAP_FAILED) return false;
+
+    memcpy(&dump -> header, dump -> map, sizeof(struct result_dump_header));
+    num_chunks = dump_chunks(dump -> header.num_limbs);
+    checksums = (uint64_t *) ((char *) dump -> map + sizeof(struct result_dump_header));
+    dump -> limbs = checksums + num_chunks;
+    if (dump -> header.magic != RESULT_DUMP_MAGIC
+            || strncmp(dump -> header.library, library, sizeof(dump -> header.library)) != 0
+            || dump -> header.num_limbs <= 0
+            || dump -> map_size != sizeof(struct result_dump_header) + (num_chunks + dump -> header.num_limbs) * sizeof(uint64_t)
+            || limbs_checksum(checksums, 0, num_chunks) != dump -> header.checksum) {
+        munmap(dump -> map, dump -> map_size);
+        return false;
+    }
+
+    //Only the chunks with the most significant used_limbs limbs are checked
+    dump -> used_limbs = (used_limbs < dump -> header.num_limbs) ? used_limbs : dump -> header.num_limbs;
+    #pragma omp parallel for schedule(dynamic) reduction(&&:correct)
+    for (chunk = (dump -> header.num_limbs - dump -> used_limbs) / DUMP_CHUNK_WORDS; chunk < num_chunks; chunk++) {
+        correct = correct && limbs_checksum(dump -> limbs, chunk * DUMP_CHUNK_WORDS, chunk_end(chunk, dump -> header.num_limbs)) == checksums[chunk];
+    }
+    if (!correct) {
+        munmap(dump -> map, dump -> map_size);
+        return false;
+    }
+    return true;
+}
+
+void unmap_result_dump(struct mapped_result_dump *dump){
+    munmap(dump -> map, dump -> map_size);
+}
+
+/*
+ * Path of the cached result of library with precision_bits in dir
+ */
+void cache_result_path(char *dir, char *library, long precision_bits, char *path, size_t size){
+    snprintf(path, size, "%s/pi_%s_%ld.dump", dir, library, precision_bits);
+}
+
+/*
+ * Looks in dir for the cached result of library with the least precision that is
+ * not lower than precision_bits and writes its path. It returns false if there is none.
+ */
+bool find_cached_result(char *dir, char *library, long precision_bits, char *path, size_t size){
+    long bits, best_bits;
+    char entry_library[8], suffix[8];
+    DIR *directory;
+    struct dirent *entry;
+
+    directory = opendir(dir);
+    if (directory == NULL) return false;
+
+    best_bits = -1;
+    while ((entry = readdir(directory)) != NULL) {
+        if (sscanf(entry -> d_name, "pi_%7[^_]_%ld.%7s", entry_library, &bits, suffix) != 3) continue;
+        if (strcmp(entry_library, library) != 0 || strcmp(suffix, "dump") != 0) continue;
+        if (bits >= precision_bits && (best_bits < 0 || bits < best_bits)) best_bits = bits;
+    }
+    closedir(directory);
+
+    if (best_bits < 0) return false;
+    cache_result_path(dir, library, best_bits, path, size);
+    return true;
+}
+
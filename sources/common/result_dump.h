@@ -0,0 +1,33 @@
+#ifndef RESULT_DUMP
+#define RESULT_DUMP
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+struct result_dump_header {
+    long magic;
+    char library[8];
+    long precision_bits;
+    long exponent;
+    int sign;
+    long num_limbs;
+    uint64_t checksum;
+};
+
+struct mapped_result_dump {
+    struct result_dump_header header;
+    void *map;
+    size_t map_size;
+    void *limbs;
+    long used_limbs;
+};
+
+void write_result_dump(char *, char *, long, long, int, void *, long);
+bool map_result_dump(struct mapped_result_dump *, char *, char *, long);
+void unmap_result_dump(struct mapped_result_dump *);
+bool find_cached_result(char *, char *, long, char *, size_t);
+void cache_result_path(char *, char *, long, char *, size_t);
+
+#endif
+
@@ -0,0 +1,314 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <sys/stat.h>
+#include "mpi.h"
+#include "options.h"
+#include "placement.h"
+#include "planner.h"
+#include "sweep.h"
+#include "../gmp/pi_calculator.h"
+#include "../mpfr/pi_calculator.h"
+
+#define MAX_SWEEP_VALUES 64
+
+
+/************************************************************************************
+ * Benchmark sweep                                                                  *
+ *                                                                                  *
+ ************************************************************************************
+ * The positional params library, algorithm, precision and num_threads can be       *
+ * lists of comma separated values. Every point of their cartesian product is run   *
+ * -warmups=W times without being measured and -repetitions=N times measured, all   *
+ * of them inside the same MPI job and with a barrier before every run. The         *
+ * algorithms that a library does not have are skipped.                             *
+ *                                                                                  *
+ * Every point reports the median, the median absolute deviation (MAD) and the      *
+ * minimum of its N execution times, which are robust to the outliers of a noisy    *
+ * node.                                                                            *
+ *                                                                                  *
+ * With -groups=G the processes are split in G groups of consecutive ranks (one     *
+ * communicator each) and the points are dealt round robin to the groups, which     *
+ * run them at the same time. The summaries are gathered in process 0 and printed   *
+ * in the order of the points, followed by the aggregate throughput of the job.     *
+ * Every group writes its own files, FILE.group<G>, and uses its own directories,   *
+ * DIR/group<G>, so the groups never write the same checkpoint, dump, cache,        *
+ * output, phases or progress file.                                                 *
+ *                                                                                  *
+ ************************************************************************************/
+
+
+struct point_summary {
+    int index;
+    char library[8];
+    char algorithm_tag[32];
+    long precision;
+    long num_iterations;
+    int num_procs;
+    int num_threads;
+    long decimals_computed;
+    double median;
+    double mad;
+    double min;
+};
+
+
+/*
+ * Splits the comma separated list in values (the list is modified).
+ * It returns the number of values.
+ */
+static int split_list(char *list, char **values){
+    int count = 0;
+    char *value, *saveptr;
+
+    for (value = strtok_r(list, ",", &saveptr); value != NULL && count < MAX_SWEEP_VALUES; value = strtok_r(NULL, ",", &saveptr)) {
+        values[count++] = value;
+    }
+    return count;
+}
+
+static int compare_doubles(const void *a, const void *b){
+    double x = *(const double *) a, y = *(const double *) b;
+    return (x > y) - (x < y);
+}
+
+/*
+ * Median of the count values (the values are sorted)
+ */
+static double median(double *values, int count){
+    qsort(values, count, sizeof(double), compare_doubles);
+    if (count % 2 == 1) return values[count / 2];
+    return (values[count / 2 - 1] + values[count / 2]) / 2;
+}
+
+/*
+ * Returns true if the params ask for more than one run: a list in some positional param,
+ * warmups or repetitions
+ */
+bool sweep_requested(char **params){
+    int i;
+
+    if (options.warmups > 0 || options.repetitions > 1 || options.groups > 1) return true;
+    for (i = 0; i < 4; i++) {
+        if (strchr(params[i], ',') != NULL) return true;
+    }
+    return false;
+}
+
+/*
+ * Runs the warmups and repetitions of one point, and returns false if the algorithm is not available
+ */
+static bool run_point(MPI_Comm comm, int num_procs, int proc_id, char *library, int algorithm, long precision, int num_threads, 
+                    double *times, struct run_result *result){
+    int run;
+
+    for (run = 0; run < options.warmups + options.repetitions; run++) {
+        MPI_Barrier(comm);
+        if (strcmp(library, "GMP") == 0) {
+            calculate_pi_gmp(comm, num_procs, proc_id, algorithm, precision, num_threads, options.csv, result);
+        } else {
+            calculate_pi_mpfr(comm, num_procs, proc_id, algorithm, precision, num_threads, options.csv, result);
+        }
+        if (!result -> available) return false;
+        if (run >= options.warmups) times[run - options.warmups] = result -> execution_time;
+    }
+    return true;
+}
+
+/*
+ * Fills the summary of the point with the median, MAD and minimum of its times (the times are sorted)
+ */
+static void summarize_point(struct point_summary *summary, int index, char *library, long precision, int num_procs, 
+                    int num_threads, double *times, struct run_result *result){
+    int i, repetitions;
+    double *deviations;
+
+    repetitions = options.repetitions;
+    deviations = malloc(repetitions * sizeof(double));
+    summary -> median = median(times, repetitions);
+    summary -> min = times[0];
+    for (i = 0; i < repetitions; i++) {
+        deviations[i] = (times[i] > summary -> median) ? times[i] - summary -> median : summary -> median - times[i];
+    }
+    summary -> mad = median(deviations, repetitions);
+    free(deviations);
+
+    summary -> index = index;
+    snprintf(summary -> library, sizeof(summary -> library), "%s", library);
+    snprintf(summary -> algorithm_tag, sizeof(summary -> algorithm_tag), "%s", result -> algorithm_tag);
+    summary -> precision = precision;
+    summary -> num_iterations = result -> num_iterations;
+    summary -> num_procs = num_procs;
+    summary -> num_threads = num_threads;
+    summary -> decimals_computed = result -> decimals_computed;
+}
+
+static void print_point(struct point_summary *summary){
+    if (options.csv) {
+        printf("MPI;%s;%s;%ld;%ld;%d;%d;%ld;%f;%f;%f;%d;\n", summary -> library, summary -> algorithm_tag, summary -> precision, 
+                summary -> num_iterations, summary -> num_procs, summary -> num_threads, summary -> decimals_computed, 
+                summary -> median, summary -> mad, summary -> min, options.repetitions);
+    } else {
+        printf("  %s %s, precision %ld, %d processes, %d threads: %ld correct decimals \n", summary -> library, 
+                summary -> algorithm_tag, summary -> precision, summary -> num_procs, summary -> num_threads, summary -> decimals_computed);
+        printf("      median %f s, MAD %f s, min %f s (%d repetitions, %d warmups) \n", 
+                summary -> median, summary -> mad, summary -> min, options.repetitions, options.warmups);
+    }
+    fflush(stdout);
+}
+
+static int compare_summaries(const void *a, const void *b){
+    return ((const struct point_summary *) a) -> index - ((const struct point_summary *) b) -> index;
+}
+
+/*
+ * Gathers the summaries of the first process of every group in process 0, prints them in the
+ * order of the points and prints the aggregate throughput of the wall_time of the sweep
+ */
+static void print_group_points(int num_procs, int proc_id, struct point_summary *summaries, int num_summaries, double wall_time){
+    int i, total, runs, *counts = NULL, *displacements = NULL;
+    double decimals;
+    struct point_summary *all_summaries = NULL;
+
+    if (proc_id == 0) {
+        counts = malloc(num_procs * sizeof(int));
+        displacements = malloc(num_procs * sizeof(int));
+    }
+    num_summaries *= sizeof(struct point_summary);
+    MPI_Gather(&num_summaries, 1, MPI_INT, counts, 1, MPI_INT, 0, MPI_COMM_WORLD);
+    total = 0;
+    if (proc_id == 0) {
+        for (i = 0; i < num_procs; i++) {
+            displacements[i] = total;
+            total += counts[i];
+        }
+        all_summaries = malloc(total);
+    }
+    MPI_Gatherv(summaries, num_summaries, MPI_BYTE, all_summaries, counts, displacements, MPI_BYTE, 0, MPI_COMM_WORLD);
+    if (proc_id != 0) return;
+
+    total /= sizeof(struct point_summary);
+    qsort(all_summaries, total, sizeof(struct point_summary), compare_summaries);
+    decimals = 0;
+    for (i = 0; i < total; i++) {
+        print_point(&all_summaries[i]);
+        decimals += (double) all_summaries[i].precision * (options.warmups + options.repetitions);
+    }
+    runs = total * (options.warmups + options.repetitions);
+    if (options.csv) {
+        printf("MPI-GROUPS;%d;%d;%d;%f;%f;%f;\n", options.groups, total, runs, wall_time, runs / wall_time, decimals / wall_time);
+    } else {
+        printf("  Aggregate throughput of %d groups: %d points and %d runs in %f s, %f runs/s, %f decimals/s \n", 
+                options.groups, total, runs, wall_time, runs / wall_time, decimals / wall_time);
+    }
+    fflush(stdout);
+
+    free(counts);
+    free(displacements);
+    free(all_summaries);
+}
+
+/*
+ * Returns path with the group index added with format, or NULL if path is NULL
+ */
+static char * group_path(char *path, char *format, int group){
+    char *path_of_group;
+
+    if (path == NULL) return NULL;
+    path_of_group = malloc(strlen(path) + 32);
+    sprintf(path_of_group, format, path, group);
+    return path_of_group;
+}
+
+/*
+ * Gives the group its own files and directories, as the groups run at the same time
+ */
+static void separate_group_paths(int group){
+    options.output_file = group_path(options.output_file, "%s.group%d", group);
+    options.dump_file = group_path(options.dump_file, "%s.group%d", group);
+    options.phase_report = group_path(options.phase_report, "%s.group%d", group);
+    options.progress_file = group_path(options.progress_file, "%s.group%d", group);
+    if (options.checkpoint_dir != NULL) {
+        mkdir(options.checkpoint_dir, 0755);
+        options.checkpoint_dir = group_path(options.checkpoint_dir, "%s/group%d", group);
+        mkdir(options.checkpoint_dir, 0755);
+    }
+    if (options.cache_dir != NULL) {
+        mkdir(options.cache_dir, 0755);
+        options.cache_dir = group_path(options.cache_dir, "%s/group%d", group);
+    }
+}
+
+/*
+ * Runs every point of the lists of params (library, algorithm, precision and num_threads)
+ */
+void run_sweep(int num_procs, int proc_id, char **params){
+    int num_libraries, num_algorithms, num_precisions, num_thread_values, l, a, p, t, max_threads, num_threads;
+    int group, group_procs, group_proc_id, index, num_summaries;
+    char *libraries[MAX_SWEEP_VALUES], *algorithms[MAX_SWEEP_VALUES], *precisions[MAX_SWEEP_VALUES], *thread_values[MAX_SWEEP_VALUES];
+    double *times, start_time;
+    struct run_result result;
+    struct point_summary *summaries;
+    MPI_Comm comm;
+
+    num_libraries = split_list(params[0], libraries);
+    num_algorithms = split_list(params[1], algorithms);
+    num_precisions = split_list(params[2], precisions);
+    num_thread_values = split_list(params[3], thread_values);
+    for (l = 0; l < num_libraries; l++) {
+        if (strcmp(libraries[l], "GMP") != 0 && strcmp(libraries[l], "MPFR") != 0) {
+            if (proc_id == 0) printf("  Library %s is not correct, it should be GMP or MPFR \n\n", libraries[l]);
+            MPI_Finalize();
+            exit(-1);
+        }
+    }
+
+    //The threads are bound once, as the binding restricts the CPUs of the process
+    max_threads = 1;
+    for (t = 0; t < num_thread_values; t++) {
+        if (atoi(thread_values[t]) > max_threads) max_threads = atoi(thread_values[t]);
+    }
+    if (options.bind_threads) place_threads(max_threads);
+
+    //Split the processes in groups of consecutive ranks
+    if (options.groups > num_procs) {
+        if (proc_id == 0) printf("  The number of groups should not be greater than the number of processes. \n\n");
+        MPI_Finalize();
+        exit(-1);
+    }
+    group = (long) proc_id * options.groups / num_procs;
+    MPI_Comm_split(MPI_COMM_WORLD, group, proc_id, &comm);
+    MPI_Comm_size(comm, &group_procs);
+    MPI_Comm_rank(comm, &group_proc_id);
+    if (options.groups > 1) separate_group_paths(group);
+
+    times = malloc(options.repetitions * sizeof(double));
+    summaries = malloc(num_libraries * num_algorithms * num_precisions * num_thread_values * sizeof(struct point_summary));
+    num_summaries = 0;
+    index = 0;
+    MPI_Barrier(MPI_COMM_WORLD);
+    start_time = MPI_Wtime();
+    for (l = 0; l < num_libraries; l++) {
+        for (a = 0; a < num_algorithms; a++) {
+            for (p = 0; p < num_precisions; p++) {
+                for (t = 0; t < num_thread_values; t++, index++) {
+                    if (index % options.groups != group) continue;
+                    num_threads = (atoi(thread_values[t]) <= 0) ? 1 : atoi(thread_values[t]);
+                    if (!run_point(comm, group_procs, group_proc_id, libraries[l], atoi(algorithms[a]), parse_precision(precisions[p]), num_threads, times, &result)) continue;
+                    if (group_proc_id != 0) continue;
+                    summarize_point(&summaries[num_summaries], index, libraries[l], parse_precision(precisions[p]), group_procs, num_threads, times, &result);
+                    if (options.groups == 1) print_point(&summaries[num_summaries]);
+                    num_summaries++;
+                }
+            }
+        }
+    }
+    MPI_Barrier(MPI_COMM_WORLD);
+    if (options.groups > 1) print_group_points(num_procs, proc_id, summaries, num_summaries, MPI_Wtime() - start_time);
+
+    MPI_Comm_free(&comm);
+    free(times);
+    free(summaries);
+}
+
@@ -0,0 +1,18 @@
+#ifndef SWEEP
+#define SWEEP
+
+#include <stdbool.h>
+
+struct run_result {
+    bool available;
+    char *algorithm_tag;
+    long num_iterations;
+    long decimals_computed;
+    double execution_time;
+};
+
+bool sweep_requested(char **);
+void run_sweep(int, int, char **);
+
+#endif
+
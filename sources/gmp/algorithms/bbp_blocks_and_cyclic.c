@@ -5,9 +5,16 @@
 #include <omp.h>
 #include "mpi.h"
 #include "../mpi_operations.h"
+#include "../omp_operations.h"
+#include "../working_precision.h"
+#include "../seeding.h"
+#include "../../common/checkpoint.h"
+#include "../checkpoint.h"
+#include "../../common/phase_timer.h"
+#include "../../common/progress.h"
 
 
-#define QUOTIENT 0.0625
+#define BITS_PER_TERM 4                 // log2(16)
 
 
 /************************************************************************************
@@ -45,14 +52,14 @@
 /*
  * An iteration of Bailey Borwein Plouffe formula
  */
-void bbp_iteration_gmp(mpf_t pi, int n, mpf_t dep_m, mpf_t quot_a, mpf_t quot_b, mpf_t quot_c, mpf_t quot_d, mpf_t aux){
+void bbp_iteration_gmp(mpf_t pi, long n, mpf_t dep_m, mpf_t quot_a, mpf_t quot_b, mpf_t quot_c, mpf_t quot_d, mpf_t aux){
     mpf_set_ui(quot_a, 4);              // quot_a = ( 4 / (8n + 1))
     mpf_set_ui(quot_b, 2);              // quot_b = (-2 / (8n + 4))
     mpf_set_ui(quot_c, 1);              // quot_c = (-1 / (8n + 5))
     mpf_set_ui(quot_d, 1);              // quot_d = (-1 / (8n + 6))
     mpf_set_ui(aux, 0);                 // aux = a + b + c + d  
 
-    int i = n << 3;                     // i = 8n
+    unsigned long i = (unsigned long) n << 3;   // i = 8n
     mpf_div_ui(quot_a, quot_a, i | 1);  // 4 / (8n + 1)
     mpf_div_ui(quot_b, quot_b, i | 4);  // 2 / (8n + 4)
     mpf_div_ui(quot_c, quot_c, i | 5);  // 1 / (8n + 5)
@@ -67,78 +74,70 @@ void bbp_iteration_gmp(mpf_t pi, int n, mpf_t dep_m, mpf_t quot_a, mpf_t quot_b,
     mpf_mul(aux, aux, dep_m);   
     
     mpf_add(pi, pi, aux);  
+    add_progress(1);
 }
 
 
-void bbp_blocks_and_cyclic_algorithm_gmp(int num_procs, int proc_id, mpf_t pi, int num_iterations, int num_threads){
-    int block_size, block_start, block_end, position, packet_size;
-    mpf_t local_proc_pi, jump, quotient;
+void bbp_blocks_and_cyclic_algorithm_gmp(MPI_Comm comm, int num_procs, int proc_id, mpf_t pi, long num_iterations, int num_threads){
+    long block_size, block_start, block_end;
+    mp_bitcnt_t precision;
+    mpf_t local_proc_pi;
 
     block_size = (num_iterations + num_procs - 1) / num_procs;
     block_start = proc_id * block_size;
     block_end = block_start + block_size;
     if (block_end > num_iterations) block_end = num_iterations;
 
-    mpf_init_set_ui(local_proc_pi, 0);          
-    mpf_init_set_d(quotient, QUOTIENT);             // quotient = (1 / 16)   
-    mpf_init_set_ui(jump, 1);        
-    mpf_pow_ui(jump, quotient, num_threads);        // jump = (1/16)^num_threads
+    precision = mpf_get_default_prec();
+    init_transport_gmp(local_proc_pi);          
     
     //Set the number of threads 
     omp_set_num_threads(num_threads);
 
     #pragma omp parallel
     {
-        int thread_id, i;
+        int thread_id;
+        long i, first_i;
+        mp_bitcnt_t working_precision;
         mpf_t local_thread_pi, dep_m, quot_a, quot_b, quot_c, quot_d, aux;
+        struct checkpoint checkpoint;
 
         thread_id = omp_get_thread_num();
         mpf_init_set_ui(local_thread_pi, 0);                    // private thread pi
+        first_i = block_start + thread_id;
+        init_checkpoint(&checkpoint, "GMP-BBP-BLC-CYC", num_procs, proc_id, num_threads, thread_id, num_iterations, precision);
+        load_checkpoint_gmp(&checkpoint, &first_i, local_thread_pi);
         mpf_init(dep_m);      
-        mpf_pow_ui(dep_m, quotient, block_start + thread_id);   // dep_m = (1/16)^n      
+        seed_bbp_gmp(dep_m, first_i);                           // dep_m = (1/16)^n
         mpf_inits(quot_a, quot_b, quot_c, quot_d, aux, NULL);    
 
+        mark_phase(SEED_PHASE);
         //First Phase -> Working on a local variable        
-        for(i = block_start + thread_id; i < block_end; i += num_threads){    
+        for(i = first_i; i < block_end; i += num_threads){    
+            //Work with the precision needed by the term i
+            working_precision = working_precision_gmp(precision, BITS_PER_TERM, i);
+            set_working_precision_gmp(working_precision, dep_m, quot_a, quot_b, quot_c, quot_d, aux, NULL);
             bbp_iteration_gmp(local_thread_pi, i, dep_m, quot_a, quot_b, quot_c, quot_d, aux); 
             // Update depencies: 
-            mpf_mul(dep_m, dep_m, jump);    
+            mpf_div_2exp(dep_m, dep_m, 4 * (mp_bitcnt_t) num_threads);    // dep_m = dep_m * (1/16)^num_threads
+            if (checkpoint_due(&checkpoint)) save_checkpoint_gmp(&checkpoint, i + num_threads, local_thread_pi);
         }
 
         //Second Phase -> Accumulate the result in the global variable
-        #pragma omp critical
-        mpf_add(local_proc_pi, local_proc_pi, local_thread_pi);
+        reduce_threads_gmp(local_proc_pi, local_thread_pi);
 
         //Clear memory
+        set_working_precision_gmp(precision, dep_m, quot_a, quot_b, quot_c, quot_d, aux, NULL);
         mpf_clears(local_thread_pi, dep_m, quot_a, quot_b, quot_c, quot_d, aux, NULL);
     }
 
 
-    //Create user defined operation
-    MPI_Op add_op;
-    MPI_Op_create((MPI_User_function *)add_gmp, 0, &add_op);
-
-    //Set buffers for cumunications, and position for pack and unpack information 
-    packet_size = 8 + sizeof(mp_exp_t) + ((local_proc_pi -> _mp_prec + 1) * sizeof(mp_limb_t));
-    char recbuffer[packet_size];
-    char sendbuffer[packet_size];
-
-
-    //Pack local_proc_pi in sendbuffuer
-    position = pack_gmp(sendbuffer, local_proc_pi);
-
-    //Reduce piLocal
-    MPI_Reduce(sendbuffer, recbuffer, position, MPI_PACKED, add_op, 0, MPI_COMM_WORLD);
-
-    //Unpack recbuffer in global Pi
-    if (proc_id == 0){
-        unpack_gmp(recbuffer, pi);
-    }
+    //Reduce local_proc_pi in global Pi
+    reduce_add_gmp(comm, pi, local_proc_pi, proc_id);
 
 
     //Clear memory
-    MPI_Op_free(&add_op);
-    mpf_clears(local_proc_pi, quotient, jump, NULL);
+    clear_transport_gmp(local_proc_pi);
 }
 
 
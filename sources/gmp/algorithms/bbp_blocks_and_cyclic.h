@@ -1,7 +1,9 @@
 #ifndef BBP_BLOCKS_AND_CYCLIC_GMP
 #define BBP_BLOCKS_AND_CYCLIC_GMP
 
-void bbp_blocks_and_cyclic_algorithm_gmp(int, int, mpf_t, int, int);
+void bbp_blocks_and_cyclic_algorithm_gmp(MPI_Comm, int, int, mpf_t, long, int);
+
+void bbp_iteration_gmp(mpf_t, long, mpf_t, mpf_t, mpf_t, mpf_t, mpf_t, mpf_t);
 
 #endif
 
@@ -0,0 +1,80 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <gmp.h>
+#include <omp.h>
+#include "mpi.h"
+#include "../working_precision.h"
+#include "../seeding.h"
+#include "../../common/dynamic_scheduler.h"
+#include "../../common/phase_timer.h"
+#include "bbp_blocks_and_cyclic.h"
+
+#define BITS_PER_TERM 4                 // log2(16)
+#define SUM_EXPONENT 1                  // pi > 2
+
+
+/************************************************************************************
+ * Bailey Borwein Plouffe formula implementation                                    *
+ * This version distributes the iterations dynamically: processes take chunks of    *
+ * iterations from a shared counter and threads steal work from each other          *
+ * (see common/dynamic_scheduler.c and common/dynamic_schedules.c).                 *
+ *                                                                                  *
+ ************************************************************************************
+ * Bailey Borwein Plouffe formula:                                                  *
+ *                      1        4          2        1       1                      *
+ *    pi = SUMMATORY( ------ [ ------  - ------ - ------ - ------]),  n >=0         *
+ *                     16^n    8n + 1    8n + 4   8n + 5   8n + 6                   *
+ *                                                                                  *
+ ************************************************************************************
+ * Seed of the dependencies at the start of a chunk:                                *
+ *                                                                                  *
+ *                        1                                                         *
+ *           dep_m(n) = ----- = 2^-4n      (only the exponent is set)               *
+ *                       16^n                                                       *
+ *                                                                                  *
+ ************************************************************************************/
+
+
+/*
+ * Adds to local_thread_pi the terms of the chunks given to the thread thread_id by the
+ * scheduler, with precision bits
+ */
+void bbp_dynamic_terms_gmp(mpf_t local_thread_pi, struct dynamic_scheduler *scheduler, int thread_id, mp_bitcnt_t precision){
+    long i, chunk_start, chunk_end, previous_end, exponent;
+    mp_bitcnt_t working_precision;
+    mpf_t dep_m, quot_a, quot_b, quot_c, quot_d, aux;
+
+    mpf_init2(dep_m, precision);
+    mpf_init2(quot_a, precision);
+    mpf_init2(quot_b, precision);
+    mpf_init2(quot_c, precision);
+    mpf_init2(quot_d, precision);
+    mpf_init2(aux, precision);
+    previous_end = -1;
+
+    mark_phase(SEED_PHASE);
+    while (next_chunk(scheduler, thread_id, &chunk_start, &chunk_end)) {
+        if (chunk_start != previous_end) {
+            //Seed dep_m = (1/16)^n
+            working_precision = working_precision_gmp(precision, BITS_PER_TERM, chunk_start);
+            set_working_precision_gmp(working_precision, dep_m, NULL);
+            seed_bbp_gmp(dep_m, chunk_start);
+        }
+        for (i = chunk_start; i < chunk_end; i++) {
+            //Work with the precision needed by the term i
+            working_precision = working_precision_gmp(precision, BITS_PER_TERM, i);
+            set_working_precision_gmp(working_precision, dep_m, quot_a, quot_b, quot_c, quot_d, aux, NULL);
+            bbp_iteration_gmp(local_thread_pi, i, dep_m, quot_a, quot_b, quot_c, quot_d, aux);
+            mpf_get_d_2exp(&exponent, aux);
+            report_term_exponent(scheduler, i, exponent - SUM_EXPONENT);
+            // Update dependencies:
+            mpf_div_2exp(dep_m, dep_m, 4);
+        }
+        previous_end = chunk_end;
+    }
+
+    //Clear memory
+    set_working_precision_gmp(precision, dep_m, quot_a, quot_b, quot_c, quot_d, aux, NULL);
+    mpf_clears(dep_m, quot_a, quot_b, quot_c, quot_d, aux, NULL);
+}
+
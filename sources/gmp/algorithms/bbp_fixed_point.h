@@ -0,0 +1,9 @@
+#ifndef BBP_FIXED_POINT_GMP
+#define BBP_FIXED_POINT_GMP
+
+void bbp_fixed_point_algorithm_gmp(MPI_Comm, int, int, mpf_t, long, int);
+
+mp_bitcnt_t bbp_fixed_point_sum_gmp(mpz_t, long, long, long, mp_bitcnt_t);
+
+#endif
+
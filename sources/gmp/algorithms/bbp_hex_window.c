@@ -0,0 +1,135 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <gmp.h>
+#include <omp.h>
+#include "mpi.h"
+#include "../mpi_operations.h"
+#include "../omp_operations.h"
+#include "../fixed_point.h"
+#include "../../common/digit_extraction.h"
+#include "../../common/phase_timer.h"
+#include "../../common/progress.h"
+
+
+/************************************************************************************
+ * Bailey Borwein Plouffe digit extraction                                          *
+ * This version computes the hex digits of pi after a position without the digits   *
+ * before it. The iterations are distributed cyclically among all the threads of    *
+ * all the processes, as in the fixed point version (see gmp/fixed_point.c).        *
+ *                                                                                  *
+ ************************************************************************************
+ * The hex digits after the position d are the fraction of 16^d pi:                 *
+ *                                                                                  *
+ *                        16^(d-n)     4          2        1       1                *
+ *   16^d pi = SUMMATORY( -------- [ ------  - ------ - ------ - ------])           *
+ *                          1        8n + 1    8n + 4   8n + 5   8n + 6             *
+ *                                                                                  *
+ * For n <= d the integer part of every quotient is not needed, so the terms are    *
+ * computed with the numerators reduced modulo their divisors:                      *
+ *                                                                                  *
+ *      4 16^(d-n)            4 (16^(d-n) mod (8n + 1))                             *
+ *   frac(----------)  = frac(-------------------------)                            *
+ *        8n + 1                       8n + 1                                       *
+ *                                                                                  *
+ * Every term is one division of a word by a word developing the fraction limbs,    *
+ * so the cost is linear in d and the memory is the size of the window. The terms   *
+ * n > d are the usual ones scaled by 2^-4(n-d).                                    *
+ *                                                                                  *
+ ************************************************************************************/
+
+
+/*
+ * Adds sign * numerator 16^(start - n) / divisor to sum
+ */
+static void add_window_term(struct fixed_point_sum *sum, unsigned long numerator, unsigned long divisor,
+                    long start, long n, int sign){
+    if (n <= start) {
+        add_fixed_point_term(sum, numerator * power_16_mod(start - n, divisor) % divisor, divisor, 0, sign);
+    } else {
+        add_fixed_point_term(sum, numerator, divisor, 4 * (mp_bitcnt_t) (n - start), sign);
+    }
+}
+
+/*
+ * Sum of the terms first, first + step, ... below num_iterations of 16^start pi
+ * with precision fraction bits. The fraction of the sum is returned in result
+ * scaled by 2^bits, returning bits.
+ */
+mp_bitcnt_t bbp_hex_window_sum_gmp(mpz_t result, long start, long first, long step, long num_iterations, mp_bitcnt_t precision){
+    long i;
+    unsigned long n;
+    mp_bitcnt_t bits;
+    struct fixed_point_sum sum;
+
+    init_fixed_point_sum(&sum, precision);
+
+    for(i = first; i < num_iterations; i += step){
+        n = i;
+        add_window_term(&sum, 4, 8 * n + 1, start, i, 1);
+        add_window_term(&sum, 2, 8 * n + 4, start, i, -1);
+        add_window_term(&sum, 1, 8 * n + 5, start, i, -1);
+        add_window_term(&sum, 1, 8 * n + 6, start, i, -1);
+        add_progress(1);
+    }
+
+    bits = get_fixed_point_sum(result, &sum);
+    mpz_fdiv_r_2exp(result, result, bits);
+    clear_fixed_point_sum(&sum);
+
+    return bits;
+}
+
+/*
+ * Computes in the window of process 0 the fraction of 16^start pi
+ */
+void bbp_hex_window_algorithm_gmp(MPI_Comm comm, int num_procs, int proc_id, mpf_t window, long start, long num_iterations, int num_threads){
+    mp_bitcnt_t precision;
+    mpf_t local_proc_window, integer_part;
+
+    precision = mpf_get_default_prec();
+    init_transport_gmp(local_proc_window);
+
+    //Set the number of threads 
+    omp_set_num_threads(num_threads);
+
+    #pragma omp parallel
+    {
+        int thread_id;
+        mp_bitcnt_t bits;
+        mpz_t thread_sum;
+        mpf_t local_thread_window;
+
+        thread_id = omp_get_thread_num();
+        mpz_init(thread_sum);
+        mpf_init(local_thread_window);
+
+        mark_phase(SEED_PHASE);
+        //First Phase -> Working on a local fixed point sum
+        bits = bbp_hex_window_sum_gmp(thread_sum, start, proc_id * num_threads + thread_id, num_procs * num_threads, 
+                                        num_iterations, precision);
+        mpf_set_z(local_thread_window, thread_sum);
+        mpf_div_2exp(local_thread_window, local_thread_window, bits);
+
+        //Second Phase -> Accumulate the result in the global variable
+        reduce_threads_gmp(local_proc_window, local_thread_window);
+
+        //Clear memory
+        mpz_clear(thread_sum);
+        mpf_clear(local_thread_window);
+    }
+
+    //Reduce local_proc_window in global window
+    reduce_add_gmp(comm, window, local_proc_window, proc_id);
+
+    //Keep the fraction of the sum of the fractions
+    if (proc_id == 0){
+        mpf_init(integer_part);
+        mpf_floor(integer_part, window);
+        mpf_sub(window, window, integer_part);
+        mpf_clear(integer_part);
+    }
+
+    //Clear memory
+    clear_transport_gmp(local_proc_window);
+}
+
@@ -0,0 +1,9 @@
+#ifndef BBP_HEX_WINDOW_GMP
+#define BBP_HEX_WINDOW_GMP
+
+void bbp_hex_window_algorithm_gmp(MPI_Comm, int, int, mpf_t, long, long, int);
+
+mp_bitcnt_t bbp_hex_window_sum_gmp(mpz_t, long, long, long, long, mp_bitcnt_t);
+
+#endif
+
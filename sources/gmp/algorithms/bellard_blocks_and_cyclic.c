@@ -4,6 +4,15 @@
 #include <omp.h>
 #include "mpi.h"
 #include "../mpi_operations.h"
+#include "../omp_operations.h"
+#include "../working_precision.h"
+#include "../seeding.h"
+#include "../../common/checkpoint.h"
+#include "../checkpoint.h"
+#include "../../common/phase_timer.h"
+#include "../../common/progress.h"
+
+#define BITS_PER_TERM 10                // log2(1024)
 
 
 
@@ -43,8 +52,8 @@
 /*
  * An iteration of Bellard formula
  */
-void bellard_iteration_gmp(mpf_t pi, int n, mpf_t m, mpf_t a, mpf_t b, mpf_t c, mpf_t d, 
-                    mpf_t e, mpf_t f, mpf_t g, mpf_t aux, int dep_a, int dep_b){
+void bellard_iteration_gmp(mpf_t pi, long n, mpf_t m, mpf_t a, mpf_t b, mpf_t c, mpf_t d, 
+                    mpf_t e, mpf_t f, mpf_t g, mpf_t aux, long dep_a, long dep_b){
     mpf_set_ui(a, 32);              // a = ( 32 / ( 4n + 1))
     mpf_set_ui(b, 1);               // b = (  1 / ( 4n + 3))
     mpf_set_ui(c, 256);             // c = (256 / (10n + 1))
@@ -76,84 +85,79 @@ void bellard_iteration_gmp(mpf_t pi, int n, mpf_t m, mpf_t a, mpf_t b, mpf_t c,
     mpf_mul(aux, aux, m);   
 
     mpf_add(pi, pi, aux); 
+    add_progress(1);
 }
 
 
-void bellard_blocks_and_cyclic_algorithm_gmp(int num_procs, int proc_id, mpf_t pi, int num_iterations, int num_threads){
-    int block_size, block_start, block_end, position, packet_size;
-    mpf_t local_proc_pi, ONE;
+void bellard_blocks_and_cyclic_algorithm_gmp(MPI_Comm comm, int num_procs, int proc_id, mpf_t pi, long num_iterations, int num_threads){
+    long block_size, block_start, block_end;
+    mp_bitcnt_t precision;
+    mpf_t local_proc_pi;
 
     block_size = (num_iterations + num_procs - 1) / num_procs;
     block_start = proc_id * block_size;
     block_end = block_start + block_size;
     if (block_end > num_iterations) block_end = num_iterations;
 
-    mpf_init_set_ui(local_proc_pi, 0);
-    mpf_init_set_ui(ONE, 1);
+    precision = mpf_get_default_prec();
+    init_transport_gmp(local_proc_pi);
 
     //Set the number of threads 
     omp_set_num_threads(num_threads);
 
     #pragma omp parallel 
     {
-        int thread_id, i, dep_a, dep_b, jump_dep_a, jump_dep_b, next_i;
+        int thread_id;
+        long i, dep_a, dep_b, jump_dep_a, jump_dep_b, next_i, first_i;
+        mp_bitcnt_t working_precision;
         mpf_t local_thread_pi, dep_m, a, b, c, d, e, f, g, aux;
+        struct checkpoint checkpoint;
 
         thread_id = omp_get_thread_num();
         mpf_init_set_ui(local_thread_pi, 0);       // private thread pi
-        dep_a = (block_start + thread_id) * 4;
-        dep_b = (block_start + thread_id) * 10;
-        jump_dep_a = 4 * num_threads;
-        jump_dep_b = 10 * num_threads;
+        first_i = block_start + thread_id;
+        init_checkpoint(&checkpoint, "GMP-BEL-BLC-CYC", num_procs, proc_id, num_threads, thread_id, num_iterations, precision);
+        load_checkpoint_gmp(&checkpoint, &first_i, local_thread_pi);
+        dep_a = first_i * 4;
+        dep_b = first_i * 10;
+        jump_dep_a = 4 * (long) num_threads;
+        jump_dep_b = 10 * (long) num_threads;
         mpf_init(dep_m);
-        mpf_mul_2exp(dep_m, ONE, 10 * (block_start + thread_id));
-        mpf_div(dep_m, ONE, dep_m);
-        if((thread_id + block_start) % 2 != 0) mpf_neg(dep_m, dep_m);
+        seed_bellard_gmp(dep_m, first_i);                      // dep_m = ((-1)^n)/1024^n
         mpf_inits(a, b, c, d, e, f, g, aux, NULL);
 
+        mark_phase(SEED_PHASE);
         //First Phase -> Working on a local variable
-        for(i = block_start + thread_id; i < block_end; i += num_threads){
+        for(i = first_i; i < block_end; i += num_threads){
+            //Work with the precision needed by the term i
+            working_precision = working_precision_gmp(precision, BITS_PER_TERM, i);
+            set_working_precision_gmp(working_precision, dep_m, a, b, c, d, e, f, g, aux, NULL);
             bellard_iteration_gmp(local_thread_pi, i, dep_m, a, b, c, d, e, f, g, aux, dep_a, dep_b);
             // Update dependencies for next iteration:
             next_i = i + num_threads;
-            mpf_mul_2exp(dep_m, ONE, 10 * next_i);
-            mpf_div(dep_m, ONE, dep_m);
-            if (next_i % 2 != 0) mpf_neg(dep_m, dep_m);
+            seed_bellard_gmp(dep_m, next_i);
             dep_a += jump_dep_a;
             dep_b += jump_dep_b;
+            if (checkpoint_due(&checkpoint)) save_checkpoint_gmp(&checkpoint, next_i, local_thread_pi);
         }
 
         //Second Phase -> Accumulate the result in the global variable
-        #pragma omp critical
-        mpf_add(local_proc_pi, local_proc_pi, local_thread_pi);
+        reduce_threads_gmp(local_proc_pi, local_thread_pi);
 
         //Clear memory
+        set_working_precision_gmp(precision, dep_m, a, b, c, d, e, f, g, aux, NULL);
         mpf_clears(local_thread_pi, dep_m, a, b, c, d, e, f, g, aux, NULL);
     }
 
-    //Create user defined operation
-    MPI_Op add_op;
-    MPI_Op_create((MPI_User_function *)add_gmp, 0, &add_op);
-
-    //Set buffers for cumunications and position for pack and unpack information
-    packet_size = 8 + sizeof(mp_exp_t) + ((local_proc_pi -> _mp_prec + 1) * sizeof(mp_limb_t));
-    char recbuffer[packet_size];
-    char sendbuffer[packet_size];
-
-    //Pack local_proc_pi in sendbuffuer
-    position = pack_gmp(sendbuffer, local_proc_pi);
-
-    //Reduce piLocal
-    MPI_Reduce(sendbuffer, recbuffer, position, MPI_PACKED, add_op, 0, MPI_COMM_WORLD);
+    //Reduce local_proc_pi in global Pi
+    reduce_add_gmp(comm, pi, local_proc_pi, proc_id);
 
-    //Unpack recbuffer in global Pi and do the last operation
+    //Do the last operations to get Pi
     if (proc_id == 0){
-        unpack_gmp(recbuffer, pi);
         mpf_div_ui(pi, pi, 64);
     }
 
     //Clear memory
-    MPI_Op_free(&add_op);
-    mpf_clears(local_proc_pi, ONE, NULL);       
+    clear_transport_gmp(local_proc_pi);
 }
 
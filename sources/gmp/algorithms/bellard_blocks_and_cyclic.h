@@ -1,7 +1,9 @@
 #ifndef BELLARD_BLOCKS_AND_CYCLIC_GMP
 #define BELLARD_BLOCKS_AND_CYCLIC_GMP
 
-void bellard_blocks_and_cyclic_algorithm_gmp(int, int, mpf_t, int, int);
+void bellard_blocks_and_cyclic_algorithm_gmp(MPI_Comm, int, int, mpf_t, long, int);
+
+void bellard_iteration_gmp(mpf_t, long, mpf_t, mpf_t, mpf_t, mpf_t, mpf_t, mpf_t, mpf_t, mpf_t, mpf_t, long, long);
 
 #endif
 
@@ -0,0 +1,89 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <gmp.h>
+#include <omp.h>
+#include "mpi.h"
+#include "../working_precision.h"
+#include "../seeding.h"
+#include "../../common/dynamic_scheduler.h"
+#include "../../common/phase_timer.h"
+#include "bellard_blocks_and_cyclic.h"
+
+#define BITS_PER_TERM 10                // log2(1024)
+#define SUM_EXPONENT 7                  // 2^6 pi > 2^7
+
+
+/************************************************************************************
+ * Bellard formula implementation                                                   *
+ * This version distributes the iterations dynamically: processes take chunks of    *
+ * iterations from a shared counter and threads steal work from each other          *
+ * (see common/dynamic_scheduler.c and common/dynamic_schedules.c).                 *
+ *                                                                                  *
+ ************************************************************************************
+ * Bellard formula:                                                                 *
+ *                 (-1)^n     32     1      256     64       4       4       1      *
+ * 2^6 * pi = SUM( ------ [- ---- - ---- + ----- - ----- - ----- - ----- + -----])  *
+ *                 2^10n     4n+1   4n+3   10n+1   10n+3   10n+5   10n+7   10n+9    *
+ *                                                                                  *
+ ************************************************************************************
+ * Seed of the dependencies at the start of a chunk:                                *
+ *                                                                                  *
+ *              dep_m(n) = (-1)^n 2^-10n      (only the exponent and sign are set)  *
+ *              dep_a(n) = 4n                                                       *
+ *              dep_b(n) = 10n                                                      *
+ *                                                                                  *
+ ************************************************************************************/
+
+
+/*
+ * Adds to local_thread_pi the terms of the chunks given to the thread thread_id by the
+ * scheduler, with precision bits. The sum is 2^6 pi.
+ */
+void bellard_dynamic_terms_gmp(mpf_t local_thread_pi, struct dynamic_scheduler *scheduler, int thread_id, mp_bitcnt_t precision){
+    long i, chunk_start, chunk_end, previous_end, dep_a, dep_b, exponent;
+    mp_bitcnt_t working_precision;
+    mpf_t dep_m, a, b, c, d, e, f, g, aux;
+
+    mpf_init2(dep_m, precision);
+    mpf_init2(a, precision);
+    mpf_init2(b, precision);
+    mpf_init2(c, precision);
+    mpf_init2(d, precision);
+    mpf_init2(e, precision);
+    mpf_init2(f, precision);
+    mpf_init2(g, precision);
+    mpf_init2(aux, precision);
+    previous_end = -1;
+    dep_a = dep_b = 0;                  // seeded with the first chunk
+
+    mark_phase(SEED_PHASE);
+    while (next_chunk(scheduler, thread_id, &chunk_start, &chunk_end)) {
+        if (chunk_start != previous_end) {
+            //Seed dep_m = (-1)^n / 1024^n, dep_a = 4n and dep_b = 10n
+            working_precision = working_precision_gmp(precision, BITS_PER_TERM, chunk_start);
+            set_working_precision_gmp(working_precision, dep_m, NULL);
+            seed_bellard_gmp(dep_m, chunk_start);
+            dep_a = chunk_start * 4;
+            dep_b = chunk_start * 10;
+        }
+        for (i = chunk_start; i < chunk_end; i++) {
+            //Work with the precision needed by the term i
+            working_precision = working_precision_gmp(precision, BITS_PER_TERM, i);
+            set_working_precision_gmp(working_precision, dep_m, a, b, c, d, e, f, g, aux, NULL);
+            bellard_iteration_gmp(local_thread_pi, i, dep_m, a, b, c, d, e, f, g, aux, dep_a, dep_b);
+            mpf_get_d_2exp(&exponent, aux);
+            report_term_exponent(scheduler, i, exponent - SUM_EXPONENT);
+            // Update dependencies for next iteration:
+            mpf_div_2exp(dep_m, dep_m, 10);
+            mpf_neg(dep_m, dep_m);
+            dep_a += 4;
+            dep_b += 10;
+        }
+        previous_end = chunk_end;
+    }
+
+    //Clear memory
+    set_working_precision_gmp(precision, dep_m, a, b, c, d, e, f, g, aux, NULL);
+    mpf_clears(dep_m, a, b, c, d, e, f, g, aux, NULL);
+}
+
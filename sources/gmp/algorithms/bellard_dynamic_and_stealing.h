@@ -0,0 +1,8 @@
+#ifndef BELLARD_DYNAMIC_AND_STEALING_GMP
+#define BELLARD_DYNAMIC_AND_STEALING_GMP
+
+#include "../../common/dynamic_scheduler.h"
+
+void bellard_dynamic_terms_gmp(mpf_t, struct dynamic_scheduler *, int, mp_bitcnt_t);
+
+#endif
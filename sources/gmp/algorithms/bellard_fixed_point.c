@@ -0,0 +1,107 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <gmp.h>
+#include <omp.h>
+#include "mpi.h"
+#include "../mpi_operations.h"
+#include "../omp_operations.h"
+#include "../fixed_point.h"
+#include "../../common/phase_timer.h"
+#include "../../common/progress.h"
+
+
+/************************************************************************************
+ * Bellard formula implementation                                                   *
+ * This version adds the terms as fixed point integers (see gmp/fixed_point.c)      *
+ * The iterations are distributed cyclically among all the threads of all the       *
+ * processes, as every term is computed without dependencies.                       *
+ *                                                                                  *
+ ************************************************************************************
+ * Bellard formula:                                                                 *
+ *                 (-1)^n     32     1      256     64       4       4       1      *
+ * 2^6 * pi = SUM( ------ [- ---- - ---- + ----- - ----- - ----- - ----- + -----])  *
+ *                 2^10n     4n+1   4n+3   10n+1   10n+3   10n+5   10n+7   10n+9    *
+ *                                                                                  *
+ * The term n is coded as four divisions scaled by (-1)^n 2^-(10n + 6):             *
+ *                                                                                  *
+ *        32     1        256     1         64      4        4                      *
+ *    - (---- + ----) + (----- + -----) - (----- + -----) - -----                   *
+ *       4n+1   4n+3      10n+1   10n+9     10n+3   10n+5    10n+7                  *
+ *                                                                                  *
+ ************************************************************************************/
+
+
+/*
+ * Sum of the terms first, first + step, ... below num_iterations with precision fraction bits.
+ * The sum is returned in result scaled by 2^bits, returning bits.
+ */
+mp_bitcnt_t bellard_fixed_point_sum_gmp(mpz_t result, long first, long step, long num_iterations, mp_bitcnt_t precision){
+    long i;
+    int sign;
+    unsigned long n;
+    mp_bitcnt_t bits, shift;
+    struct fixed_point_sum sum;
+
+    init_fixed_point_sum(&sum, precision);
+
+    for(i = first; i < num_iterations; i += step){
+        n = i;
+        sign = (i % 2 == 0) ? 1 : -1;
+        shift = 10 * n + 6;
+        add_fixed_point_pair(&sum, 32, 4 * n + 1, 1, 4 * n + 3, shift, -sign);
+        add_fixed_point_pair(&sum, 256, 10 * n + 1, 1, 10 * n + 9, shift, sign);
+        add_fixed_point_pair(&sum, 64, 10 * n + 3, 4, 10 * n + 5, shift, -sign);
+        add_fixed_point_term(&sum, 4, 10 * n + 7, shift, -sign);
+        add_progress(1);
+    }
+
+    bits = get_fixed_point_sum(result, &sum);
+    clear_fixed_point_sum(&sum);
+
+    return bits;
+}
+
+
+void bellard_fixed_point_algorithm_gmp(MPI_Comm comm, int num_procs, int proc_id, mpf_t pi, long num_iterations, int num_threads){
+    mp_bitcnt_t precision;
+    mpf_t local_proc_pi;
+
+    precision = mpf_get_default_prec();
+    init_transport_gmp(local_proc_pi);
+
+    //Set the number of threads 
+    omp_set_num_threads(num_threads);
+
+    #pragma omp parallel
+    {
+        int thread_id;
+        mp_bitcnt_t bits;
+        mpz_t thread_sum;
+        mpf_t local_thread_pi;
+
+        thread_id = omp_get_thread_num();
+        mpz_init(thread_sum);
+        mpf_init(local_thread_pi);
+
+        mark_phase(SEED_PHASE);
+        //First Phase -> Working on a local fixed point sum
+        bits = bellard_fixed_point_sum_gmp(thread_sum, proc_id * num_threads + thread_id, num_procs * num_threads, 
+                                            num_iterations, precision);
+        mpf_set_z(local_thread_pi, thread_sum);
+        mpf_div_2exp(local_thread_pi, local_thread_pi, bits);
+
+        //Second Phase -> Accumulate the result in the global variable
+        reduce_threads_gmp(local_proc_pi, local_thread_pi);
+
+        //Clear memory
+        mpz_clear(thread_sum);
+        mpf_clear(local_thread_pi);
+    }
+
+    //Reduce local_proc_pi in global Pi
+    reduce_add_gmp(comm, pi, local_proc_pi, proc_id);
+
+    //Clear memory
+    clear_transport_gmp(local_proc_pi);
+}
+
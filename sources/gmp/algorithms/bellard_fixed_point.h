@@ -0,0 +1,9 @@
+#ifndef BELLARD_FIXED_POINT_GMP
+#define BELLARD_FIXED_POINT_GMP
+
+void bellard_fixed_point_algorithm_gmp(MPI_Comm, int, int, mpf_t, long, int);
+
+mp_bitcnt_t bellard_fixed_point_sum_gmp(mpz_t, long, long, long, mp_bitcnt_t);
+
+#endif
+
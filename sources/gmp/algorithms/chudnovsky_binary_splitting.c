@@ -0,0 +1,249 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <gmp.h>
+#include <omp.h>
+#include "mpi.h"
+#include "../mpi_operations.h"
+#include "../parallel_arithmetic.h"
+#include "../out_of_core.h"
+#include "../../common/options.h"
+#include "../../common/phase_timer.h"
+#include "../../common/large_buffer.h"
+
+#define A 13591409
+#define B 545140134
+#define C 640320
+#define D 426880
+#define E 10005
+#define C3_OVER_24 10939058860032000    // 640320^3 / 24
+
+
+/************************************************************************************
+ * Chudnovsky formula implementation                                                *
+ * This version computes the series with integer binary splitting                   *
+ * This version allows computing Pi using processes and threads in hybrid way.      *
+ *                                                                                  *
+ ************************************************************************************
+ * Chudnovsky formula:                                                              *
+ *     426880 sqrt(10005)                 (6n)! (545140134n + 13591409)             *
+ *    --------------------  = SUMMATORY( ----------------------------- ),  n >=0    *
+ *            pi                            (n!)^3 (3n)! (-640320)^3n               *
+ *                                                                                  *
+ ************************************************************************************
+ * Binary splitting terms for the range [a, b):                                     *
+ *      p(0) = q(0) = 1                                                             *
+ *      p(n) = (6n - 5)(2n - 1)(6n - 1)                                             *
+ *      q(n) = n^3 640320^3 / 24                                                    *
+ *      t(n) = (-1)^n p(n) (13591409 + 545140134n)                                  *
+ *                                                                                  *
+ *      P(a, b) = p(a) ... p(b - 1)                                                 *
+ *      Q(a, b) = q(a) ... q(b - 1)                                                 *
+ *      T(a, b) = Q(m, b) T(a, m) + P(a, m) T(m, b),   a < m < b                    *
+ *                                                                                  *
+ *                 426880 sqrt(10005) Q(0, N)                                       *
+ *          pi = ----------------------------                                       *
+ *                        T(0, N)                                                   *
+ *                                                                                  *
+ ************************************************************************************/
+
+
+/*
+ * Merges the triple of the range [m, b) into the triple of the range [a, m)
+ * The operation is associative but not commutative: (P, Q, T) must be the left range
+ */
+void merge_pqt_gmp(mpz_t P, mpz_t Q, mpz_t T, mpz_t P_right, mpz_t Q_right, mpz_t T_right){
+    mpz_mul(T, T, Q_right);
+    mpz_mul(T_right, T_right, P);
+    mpz_add(T, T, T_right);
+    mpz_mul(P, P, P_right);
+    mpz_mul(Q, Q, Q_right);
+}
+
+
+/*
+ * Same as merge_pqt_gmp but every product is computed with num_threads threads.
+ * It is used for the last merges, where the triples are the largest numbers.
+ * P is not computed if compute_P is false, as in the last merge of all.
+ * With the -spill option the triples larger than one chunk are merged out of core.
+ */
+void parallel_merge_pqt_gmp(mpz_t P, mpz_t Q, mpz_t T, mpz_t P_right, mpz_t Q_right, mpz_t T_right, int num_threads, bool compute_P){
+    if (options.spill_dir != NULL && mpz_size(T) + mpz_size(T_right) > spill_chunk_limbs()) {
+        spilled_merge_pqt_gmp(P, Q, T, P_right, Q_right, T_right, num_threads, compute_P);
+        return;
+    }
+    parallel_mpz_mul_gmp(T, T, Q_right, num_threads);
+    parallel_mpz_mul_gmp(T_right, T_right, P, num_threads);
+    mpz_add(T, T, T_right);
+    if (compute_P) parallel_mpz_mul_gmp(P, P, P_right, num_threads);
+    parallel_mpz_mul_gmp(Q, Q, Q_right, num_threads);
+}
+
+
+/*
+ * Reduces the triples of the processes in process 0.
+ * The triples are merged in rank order through a binomial tree: in step s the process
+ * proc_id + s sends its triple, which covers the iterations on its right, to the process
+ * proc_id. The receiving process merges it using all its threads.
+ * P is not computed in the last merge of process 0, only Q and T are needed.
+ */
+void reduce_pqt_gmp(MPI_Comm comm, int num_procs, int proc_id, mpz_t P, mpz_t Q, mpz_t T, int num_threads){
+    int step;
+    long bytes;
+    void *buffer;
+    mpz_t P_right, Q_right, T_right;
+
+    mark_phase(THREAD_REDUCE_PHASE);
+    mpz_inits(P_right, Q_right, T_right, NULL);
+    for (step = 1; step < num_procs; step *= 2) {
+        if (proc_id % (2 * step) != 0) {
+            //Send the triple to the left neighbour and finish
+            buffer = pack_pqt_gmp(P, Q, T, &bytes);
+            send_large_buffer(comm, buffer, bytes, proc_id - step);
+            free_large_buffer(buffer);
+            break;
+        }
+        if (proc_id + step < num_procs) {
+            //Receive the triple of the right neighbour and merge it
+            buffer = receive_large_buffer(comm, &bytes, proc_id + step);
+            unpack_pqt_gmp(buffer, P_right, Q_right, T_right);
+            free_large_buffer(buffer);
+            parallel_merge_pqt_gmp(P, Q, T, P_right, Q_right, T_right, num_threads, 2 * step < num_procs);
+        }
+    }
+    mpz_clears(P_right, Q_right, T_right, NULL);
+    mark_phase(PROC_REDUCE_PHASE);
+}
+
+
+/*
+ * Computes P(a, b), Q(a, b) and T(a, b) recursively
+ * IMPORTANT: P, Q and T should have been previously initialized
+ */
+void binary_splitting_gmp(mpz_t P, mpz_t Q, mpz_t T, long a, long b){
+    mpz_t P_right, Q_right, T_right;
+    long m;
+
+    if (b <= a) {
+        //Empty range: identity triple
+        mpz_set_ui(P, 1);
+        mpz_set_ui(Q, 1);
+        mpz_set_ui(T, 0);
+        return;
+    }
+
+    if (b - a == 1) {
+        if (a == 0) {
+            mpz_set_ui(P, 1);
+            mpz_set_ui(Q, 1);
+        } else {
+            mpz_set_ui(P, 6 * a - 5);
+            mpz_mul_ui(P, P, 2 * a - 1);
+            mpz_mul_ui(P, P, 6 * a - 1);
+            mpz_set_ui(Q, a);
+            mpz_pow_ui(Q, Q, 3);
+            mpz_mul_ui(Q, Q, C3_OVER_24);
+        }
+        mpz_set_ui(T, B);
+        mpz_mul_ui(T, T, a);
+        mpz_add_ui(T, T, A);
+        mpz_mul(T, T, P);
+        if (a % 2 != 0) mpz_neg(T, T);
+        return;
+    }
+
+    m = a + (b - a) / 2;
+    mpz_inits(P_right, Q_right, T_right, NULL);
+    binary_splitting_gmp(P, Q, T, a, m);
+    binary_splitting_gmp(P_right, Q_right, T_right, m, b);
+    merge_pqt_gmp(P, Q, T, P_right, Q_right, T_right);
+    mpz_clears(P_right, Q_right, T_right, NULL);
+}
+
+
+/*
+ * Computes the triple of every process iterations and reduces it in process 0.
+ * Each thread builds the subtree of a block of iterations and the
+ * subtrees are merged in order. The P of process 0 is not computed in the last
+ * merge, as pi only needs Q and T.
+ * IMPORTANT: P, Q and T should have been previously initialized
+ */
+void chudnovsky_binary_splitting_pqt_gmp(MPI_Comm comm, int num_procs, int proc_id, mpz_t P, mpz_t Q, mpz_t T, long num_iterations, int num_threads){
+    long block_size, block_start, block_end;
+    int i;
+    mpz_t *thread_P, *thread_Q, *thread_T;
+
+    block_size = (num_iterations + num_procs - 1) / num_procs;
+    block_start = proc_id * block_size;
+    block_end = block_start + block_size;
+    if (block_end > num_iterations) block_end = num_iterations;
+
+    thread_P = malloc(sizeof(mpz_t) * num_threads);
+    thread_Q = malloc(sizeof(mpz_t) * num_threads);
+    thread_T = malloc(sizeof(mpz_t) * num_threads);
+
+    //Set the number of threads
+    omp_set_num_threads(num_threads);
+
+    #pragma omp parallel
+    {
+        int thread_id;
+        long thread_block_size, thread_block_start, thread_block_end;
+
+        thread_id = omp_get_thread_num();
+        thread_block_size = (block_size + num_threads - 1) / num_threads;
+        thread_block_start = (thread_id * thread_block_size) + block_start;
+        thread_block_end = thread_block_start + thread_block_size;
+        if (thread_block_end > block_end) thread_block_end = block_end;
+
+        mark_phase(SEED_PHASE);
+        //First Phase -> Every thread builds the subtree of its block
+        mpz_inits(thread_P[thread_id], thread_Q[thread_id], thread_T[thread_id], NULL);
+        binary_splitting_gmp(thread_P[thread_id], thread_Q[thread_id], thread_T[thread_id], thread_block_start, thread_block_end);
+        mark_phase(SUM_PHASE);
+    }
+
+    //Second Phase -> Merge the subtrees of the threads in order
+    mpz_swap(P, thread_P[0]);
+    mpz_swap(Q, thread_Q[0]);
+    mpz_swap(T, thread_T[0]);
+    for (i = 1; i < num_threads; i++) {
+        parallel_merge_pqt_gmp(P, Q, T, thread_P[i], thread_Q[i], thread_T[i], num_threads, num_procs > 1 || i < num_threads - 1);
+    }
+    for (i = 0; i < num_threads; i++) {
+        mpz_clears(thread_P[i], thread_Q[i], thread_T[i], NULL);
+    }
+    free(thread_P);
+    free(thread_Q);
+    free(thread_T);
+
+    //Third Phase -> Reduce the triples of the processes in process 0
+    reduce_pqt_gmp(comm, num_procs, proc_id, P, Q, T, num_threads);
+}
+
+
+void chudnovsky_binary_splitting_algorithm_gmp(MPI_Comm comm, int num_procs, int proc_id, mpf_t pi, long num_iterations, int num_threads){
+    mpz_t P, Q, T;
+    mpf_t e, aux;
+    struct sqrt_constant_gmp constant;
+
+    mpz_inits(P, Q, T, NULL);
+    if (proc_id == 0) start_sqrt_constant_gmp(&constant, D, E, mpf_get_default_prec());   // e = D sqrt(E) in parallel
+
+    chudnovsky_binary_splitting_pqt_gmp(comm, num_procs, proc_id, P, Q, T, num_iterations, num_threads);
+
+    //Do the last operations to get Pi: one product and one division
+    if (proc_id == 0){
+        mpf_inits(e, aux, NULL);
+        wait_sqrt_constant_gmp(e, &constant);
+        mpf_set_z(aux, Q);
+        parallel_mul_gmp(e, e, aux, num_threads);
+        mpf_set_z(aux, T);
+        parallel_div_gmp(pi, e, aux, num_threads);
+        mpf_clears(e, aux, NULL);
+    }
+
+    //Clear process memory
+    mpz_clears(P, Q, T, NULL);
+}
+
@@ -0,0 +1,17 @@
+#ifndef CHUDNOVSKY_BINARY_SPLITTING_GMP
+#define CHUDNOVSKY_BINARY_SPLITTING_GMP
+
+void chudnovsky_binary_splitting_algorithm_gmp(MPI_Comm, int, int, mpf_t, long, int);
+
+void binary_splitting_gmp(mpz_t, mpz_t, mpz_t, long, long);
+
+void merge_pqt_gmp(mpz_t, mpz_t, mpz_t, mpz_t, mpz_t, mpz_t);
+
+void parallel_merge_pqt_gmp(mpz_t, mpz_t, mpz_t, mpz_t, mpz_t, mpz_t, int, bool);
+
+void reduce_pqt_gmp(MPI_Comm, int, int, mpz_t, mpz_t, mpz_t, int);
+
+void chudnovsky_binary_splitting_pqt_gmp(MPI_Comm, int, int, mpz_t, mpz_t, mpz_t, long, int);
+
+#endif
+
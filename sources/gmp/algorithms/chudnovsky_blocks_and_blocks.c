@@ -4,6 +4,15 @@
 #include <omp.h>
 #include "mpi.h"
 #include "../mpi_operations.h"
+#include "../omp_operations.h"
+#include "../working_precision.h"
+#include "../seeding.h"
+#include "../parallel_arithmetic.h"
+#include "../../common/options.h"
+#include "../../common/checkpoint.h"
+#include "../checkpoint.h"
+#include "../../common/phase_timer.h"
+#include "chudnovsky_rational_blocks.h"
 #include "chudnovsky_blocks_and_cyclic.h"
 
 #define A 13591409
@@ -11,6 +20,7 @@
 #define C 640320
 #define D 426880
 #define E 10005
+#define BITS_PER_TERM 47.11             // log2(640320^3 / 12^3)
 
 /************************************************************************************
  * Miguel Pardo Navarro. 17/07/2021                                                 *
@@ -42,17 +52,19 @@
  ************************************************************************************/
 
 
-void chudnovsky_blocks_and_blocks_algorithm_gmp(int num_procs, int proc_id, mpf_t pi, int num_iterations, int num_threads){
-    int packet_size, position, block_size, block_start, block_end; 
+void chudnovsky_blocks_and_blocks_algorithm_gmp(MPI_Comm comm, int num_procs, int proc_id, mpf_t pi, long num_iterations, int num_threads){
+    long block_size, block_start, block_end; 
     mpf_t local_proc_pi, e, c;  
+    struct sqrt_constant_gmp constant;
 
     block_size = (num_iterations + num_procs - 1) / num_procs;
     block_start = proc_id * block_size;
     block_end = block_start + block_size;
     if (block_end > num_iterations) block_end = num_iterations;
 
-    mpf_init_set_ui(local_proc_pi, 0);   
-    mpf_init_set_ui(e, E);
+    init_transport_gmp(local_proc_pi);   
+    mpf_init(e);
+    if (proc_id == 0) start_sqrt_constant_gmp(&constant, D, E, mpf_get_default_prec());   // e = D sqrt(E) in parallel
     mpf_init_set_ui(c, C);
     mpf_neg(c, c);
     mpf_pow_ui(c, c, 3);
@@ -62,78 +74,78 @@ void chudnovsky_blocks_and_blocks_algorithm_gmp(int num_procs, int proc_id, mpf_
 
     #pragma omp parallel 
     {
-        int thread_id, i, thread_block_size, thread_block_start, thread_block_end, factor_a;
+        int thread_id;
+        long i, thread_block_size, thread_block_start, thread_block_end, factor_a;
+        mp_bitcnt_t precision, working_precision;
         mpf_t local_thread_pi, dep_a, dep_a_dividend, dep_a_divisor, dep_b, dep_c, aux;
+        struct checkpoint checkpoint;
 
         thread_id = omp_get_thread_num();
+        precision = mpf_get_default_prec();
         thread_block_size = (block_size + num_threads - 1) / num_threads;
         thread_block_start = (thread_id * thread_block_size) + block_start;
         thread_block_end = thread_block_start + thread_block_size;
         if (thread_block_end > block_end) thread_block_end = block_end;
        
         mpf_init_set_ui(local_thread_pi, 0);    // private thread pi
-        mpf_inits(dep_a, dep_b, dep_a_dividend, dep_a_divisor, aux, NULL);
-        init_dep_a_gmp(dep_a, thread_block_start);
-        mpf_pow_ui(dep_b, c, thread_block_start);
-        mpf_init_set_ui(dep_c, B);
-        mpf_mul_ui(dep_c, dep_c, thread_block_start);
-        mpf_add_ui(dep_c, dep_c, A);
+        if (options.block_terms == 1) {
+            init_checkpoint(&checkpoint, "GMP-CHD-SME-BLC-BLC", num_procs, proc_id, num_threads, thread_id, num_iterations, precision);
+            load_checkpoint_gmp(&checkpoint, &thread_block_start, local_thread_pi);
+        }
+        mpf_inits(dep_a, dep_b, dep_c, dep_a_dividend, dep_a_divisor, aux, NULL);
+        seed_chudnovsky_gmp(dep_a, dep_b, dep_c, thread_block_start);
         factor_a = 12 * thread_block_start;
 
+        mark_phase(SEED_PHASE);
         //First Phase -> Working on a local variable        
-        for(i = thread_block_start; i < thread_block_end; i++){
-            chudnovsky_iteration_gmp(local_thread_pi, i, dep_a, dep_b, dep_c, aux);
-            //Update dep_a:
-            mpf_set_ui(dep_a_dividend, factor_a + 10);
-            mpf_mul_ui(dep_a_dividend, dep_a_dividend, factor_a + 6);
-            mpf_mul_ui(dep_a_dividend, dep_a_dividend, factor_a + 2);
-            mpf_mul(dep_a_dividend, dep_a_dividend, dep_a);
-
-            mpf_set_ui(dep_a_divisor, i + 1);
-            mpf_pow_ui(dep_a_divisor, dep_a_divisor, 3);
-            mpf_div(dep_a, dep_a_dividend, dep_a_divisor);
-            factor_a += 12; 
-
-            //Update dep_b:
-            mpf_mul(dep_b, dep_b, c);
-
-            //Update dep_c:
-            mpf_add_ui(dep_c, dep_c, B);
+        if (options.block_terms > 1) {
+            mpf_div(dep_a, dep_a, dep_b);     // x = dep_a / dep_b
+            chudnovsky_rational_blocks_gmp(local_thread_pi, dep_a, thread_block_start, thread_block_end, options.block_terms);
+        } else {
+            for(i = thread_block_start; i < thread_block_end; i++){
+                //Work with the precision needed by the term i
+                working_precision = working_precision_gmp(precision, BITS_PER_TERM, i);
+                set_working_precision_gmp(working_precision, dep_a, dep_b, dep_a_dividend, dep_a_divisor, aux, NULL);
+                chudnovsky_iteration_gmp(local_thread_pi, i, dep_a, dep_b, dep_c, aux);
+                //Update dep_a:
+                mpf_set_ui(dep_a_dividend, factor_a + 10);
+                mpf_mul_ui(dep_a_dividend, dep_a_dividend, factor_a + 6);
+                mpf_mul_ui(dep_a_dividend, dep_a_dividend, factor_a + 2);
+                mpf_mul(dep_a_dividend, dep_a_dividend, dep_a);
+
+                mpf_set_ui(dep_a_divisor, i + 1);
+                mpf_pow_ui(dep_a_divisor, dep_a_divisor, 3);
+                mpf_div(dep_a, dep_a_dividend, dep_a_divisor);
+                factor_a += 12; 
+
+                //Update dep_b:
+                mpf_mul(dep_b, dep_b, c);
+
+                //Update dep_c:
+                mpf_add_ui(dep_c, dep_c, B);
+                if (checkpoint_due(&checkpoint)) save_checkpoint_gmp(&checkpoint, i + 1, local_thread_pi);
+            }
         }
 
-        //Second Phase -> Accumulate the result in the global variable 
-        #pragma omp critical
-        mpf_add(local_proc_pi, local_proc_pi, local_thread_pi);
+        //Second Phase -> Accumulate the result in the global variable
+        reduce_threads_gmp(local_proc_pi, local_thread_pi);
 
         //Clear thread memory
+        set_working_precision_gmp(precision, dep_a, dep_b, dep_a_dividend, dep_a_divisor, aux, NULL);
         mpf_clears(local_thread_pi, dep_a, dep_a_dividend, dep_a_divisor, dep_b, dep_c, aux, NULL);   
     }
     
-    //Create user defined operation
-    MPI_Op add_op;
-    MPI_Op_create((MPI_User_function *)add_gmp, 0, &add_op);
-
-    //Set buffers for cumunications and position for pack and unpack information 
-    packet_size = 8 + sizeof(mp_exp_t) + ((local_proc_pi -> _mp_prec + 1) * sizeof(mp_limb_t));
-    char recbuffer[packet_size];
-    char sendbuffer[packet_size];
-
-    //Pack local_proc_pi in sendbuffuer
-    position = pack_gmp(sendbuffer, local_proc_pi);
-
-    //Reduce local_proc_pi
-    MPI_Reduce(sendbuffer, recbuffer, position, MPI_PACKED, add_op, 0, MPI_COMM_WORLD);
+    //Reduce local_proc_pi in global Pi
+    reduce_add_gmp(comm, pi, local_proc_pi, proc_id);
 
-    //Unpack recbuffer in global Pi and do the last operations to get Pi
+    //Do the last operations to get Pi
     if (proc_id == 0){
-        unpack_gmp(recbuffer, pi);
-        mpf_sqrt(e, e);
-        mpf_mul_ui(e, e, D);
-        mpf_div(pi, e, pi); 
+        wait_sqrt_constant_gmp(e, &constant);
+        parallel_div_gmp(pi, e, pi, num_threads);
     }    
 
     //Clear process memory
-    MPI_Op_free(&add_op);
-    mpf_clears(local_proc_pi, e, c, NULL);
+    clear_transport_gmp(local_proc_pi);
+    mpf_clears(e, c, NULL);
 }
 
@@ -1,7 +1,7 @@
 #ifndef CHUDNOVSKY_BLOCKS_AND_BLOCKS_GMP
 #define CHUDNOVSKY_BLOCKS_AND_BLOCKS_GMP
 
-void chudnovsky_blocks_and_blocks_algorithm_gmp(int, int, mpf_t, int, int);
+void chudnovsky_blocks_and_blocks_algorithm_gmp(MPI_Comm, int, int, mpf_t, long, int);
 
 #endif
 
@@ -4,18 +4,26 @@
 #include <omp.h>
 #include "mpi.h"
 #include "../mpi_operations.h"
+#include "../omp_operations.h"
+#include "../working_precision.h"
+#include "../seeding.h"
+#include "../parallel_arithmetic.h"
+#include "../../common/phase_timer.h"
+#include "../../common/progress.h"
 
 #define A 13591409
 #define B 545140134
 #define C 640320
 #define D 426880
 #define E 10005
+#define BITS_PER_TERM 47.11             // log2(640320^3 / 12^3)
 
 /************************************************************************************
  * Miguel Pardo Navarro. 17/07/2021                                                 *
  * Chudnovsky formula implementation                                                *
  * This version does not computes all the factorials                                *
- * This version allows computing Pi using processes and threads in hybrid way.      *
+ * The iteration and the jumps of dep_a of the terms computed cyclically by the     *
+ * threads, used by the schedules of common/chudnovsky_schedules.c.                 *
  *                                                                                  *
  ************************************************************************************
  * Chudnovsky formula:                                                              *
@@ -44,65 +52,20 @@
 /*
  * An iteration of Chudnovsky formula
  */
-void chudnovsky_iteration_gmp(mpf_t pi, int n, mpf_t dep_a, mpf_t dep_b, mpf_t dep_c, mpf_t aux){
+void chudnovsky_iteration_gmp(mpf_t pi, long n, mpf_t dep_a, mpf_t dep_b, mpf_t dep_c, mpf_t aux){
     mpf_mul(aux, dep_a, dep_c);
     mpf_div(aux, aux, dep_b);
     
     mpf_add(pi, pi, aux);
+    add_progress(1);
 }
 
 
 /*
- * This method is used by ParallelChudnovskyAlgorithm procs
- * for computing the first value of dep_a
+ * Jumps dep_a from the term current_i to the term next_i
  */
-void init_dep_a_gmp(mpf_t dep_a, int block_start){
-    mpz_t factorial_n, dividend, divisor;
-    mpf_t float_dividend, float_divisor;
-    mpz_inits(factorial_n, dividend, divisor, NULL);
-    mpf_inits(float_dividend, float_divisor, NULL);
-
-    mpz_fac_ui(factorial_n, block_start);
-    mpz_fac_ui(divisor, 3 * block_start);
-    mpz_fac_ui(dividend, 6 * block_start);
-
-    mpz_pow_ui(factorial_n, factorial_n, 3);
-    mpz_mul(divisor, divisor, factorial_n);
-
-    mpf_set_z(float_dividend, dividend);
-    mpf_set_z(float_divisor, divisor);
-
-    mpf_div(dep_a, float_dividend, float_divisor);
-
-    mpz_clears(factorial_n, dividend, divisor, NULL);
-    mpf_clears(float_dividend, float_divisor, NULL);
-}
-
-
-void compute_dep_a_gmp(mpf_t dep_a, int iteration){
-    int i, factor_a;
-    mpf_t dividend, divisor, result;
-
-    mpf_inits(result, dividend, divisor, NULL);
-    mpf_set_ui(dep_a, 1);
-
-    for (i = 1; i <= iteration; i++) {
-        factor_a = 12 * (i - 1);
-        mpf_set_ui(dividend, factor_a + 10);
-        mpf_mul_ui(dividend, dividend, factor_a + 6);
-        mpf_mul_ui(dividend, dividend, factor_a + 2);
-
-        mpf_set_ui(divisor, i);
-        mpf_pow_ui(divisor, divisor, 3);
-        mpf_div(result, dividend, divisor);
-        mpf_mul(dep_a, dep_a, result);
-    }    
-
-    mpf_clears(result, dividend, divisor, NULL);
-}
-
-void compute_portion_of_dep_a_gmp(mpf_t dep_a, int next_i, int current_i){
-    int i, factor_a;
+void compute_portion_of_dep_a_gmp(mpf_t dep_a, long next_i, long current_i){
+    long i, factor_a;
     mpf_t result, dividend, divisor;
 
     mpf_inits(result, dividend, divisor, NULL);
@@ -124,88 +87,3 @@ void compute_portion_of_dep_a_gmp(mpf_t dep_a, int next_i, int current_i){
 }
 
 
-void chudnovsky_blocks_and_cyclic_algorithm_gmp(int num_procs, int proc_id, mpf_t pi, int num_iterations, int num_threads){
-    int packet_size, position, block_size, block_start, block_end; 
-    mpf_t local_proc_pi, e, c, jump;  
-
-    block_size = (num_iterations + num_procs - 1) / num_procs;
-    block_start = proc_id * block_size;
-    block_end = block_start + block_size;
-    if (block_end > num_iterations) block_end = num_iterations;
-
-    mpf_init_set_ui(local_proc_pi, 0);   
-    mpf_init_set_ui(e, E);
-    mpf_init_set_ui(c, C);
-    mpf_neg(c, c);
-    mpf_pow_ui(c, c, 3);
-    mpf_inits(jump, NULL);
-    mpf_pow_ui(jump, c, num_threads);
-
-    //Set the number of threads 
-    omp_set_num_threads(num_threads);
-
-    #pragma omp parallel 
-    {
-        int thread_id, i, j;
-        mpf_t local_thread_pi, dep_a, dep_b, dep_c, aux;
-
-        thread_id = omp_get_thread_num();
-       
-        mpf_init_set_ui(local_thread_pi, 0);    // private thread pi
-        mpf_inits(dep_a, dep_b, aux, NULL);
-        compute_dep_a_gmp(dep_a, block_start + thread_id);
-        mpf_pow_ui(dep_b, c, block_start + thread_id);
-        mpf_init_set_ui(dep_c, B);
-        mpf_mul_ui(dep_c, dep_c, block_start + thread_id);
-        mpf_add_ui(dep_c, dep_c, A);
-
-        //First Phase -> Working on a local variable        
-        for(i = block_start + thread_id; i < block_end; i += num_threads){
-            chudnovsky_iteration_gmp(local_thread_pi, i, dep_a, dep_b, dep_c, aux);
-
-            //Update dep_a:
-            compute_portion_of_dep_a_gmp(dep_a, i + num_threads, i);
-
-            //Update dep_b:
-            mpf_mul(dep_b, dep_b, jump);
-
-            //Update dep_c:
-            mpf_add_ui(dep_c, dep_c, B * num_threads);
-        }
-
-        //Second Phase -> Accumulate the result in the global variable 
-        #pragma omp critical
-        mpf_add(local_proc_pi, local_proc_pi, local_thread_pi);
-
-        //Clear thread memory
-        mpf_clears(local_thread_pi, dep_a, dep_b, dep_c, aux, NULL);   
-    }
-    
-    //Create user defined operation
-    MPI_Op add_op;
-    MPI_Op_create((MPI_User_function *)add_gmp, 0, &add_op);
-
-    //Set buffers for cumunications and position for pack and unpack information 
-    packet_size = 8 + sizeof(mp_exp_t) + ((local_proc_pi -> _mp_prec + 1) * sizeof(mp_limb_t));
-    char recbuffer[packet_size];
-    char sendbuffer[packet_size];
-
-    //Pack local_proc_pi in sendbuffuer
-    position = pack_gmp(sendbuffer, local_proc_pi);
-
-    //Reduce local_proc_pi
-    MPI_Reduce(sendbuffer, recbuffer, position, MPI_PACKED, add_op, 0, MPI_COMM_WORLD);
-
-    //Unpack recbuffer in global Pi and do the last operations to get Pi
-    if (proc_id == 0){
-        unpack_gmp(recbuffer, pi);
-        mpf_sqrt(e, e);
-        mpf_mul_ui(e, e, D);
-        mpf_div(pi, e, pi); 
-    }    
-
-    //Clear process memory
-    MPI_Op_free(&add_op);
-    mpf_clears(local_proc_pi, e, c, jump, NULL);
-}
-
@@ -1,11 +1,8 @@
 #ifndef CHUDNOVSKY_BLOCKS_AND_CYCLIC_GMP
 #define CHUDNOVSKY_BLOCKS_AND_CYCLIC_GMP
 
-void chudnovsky_blocks_and_cyclic_algorithm_gmp(int, int, mpf_t, int, int);
-
-void chudnovsky_iteration_gmp(mpf_t, int, mpf_t, mpf_t, mpf_t, mpf_t);
-
-void init_dep_a_gmp(mpf_t, int);
+void chudnovsky_iteration_gmp(mpf_t, long, mpf_t, mpf_t, mpf_t, mpf_t);
+void compute_portion_of_dep_a_gmp(mpf_t, long, long);
 
 #endif
 
@@ -0,0 +1,122 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <gmp.h>
+#include <omp.h>
+#include "mpi.h"
+#include "../working_precision.h"
+#include "../seeding.h"
+#include "../../common/options.h"
+#include "../../common/dynamic_scheduler.h"
+#include "../../common/phase_timer.h"
+#include "chudnovsky_rational_blocks.h"
+#include "chudnovsky_blocks_and_cyclic.h"
+
+#define A 13591409
+#define B 545140134
+#define C 640320
+#define BITS_PER_TERM 47.11             // log2(640320^3 / 12^3)
+#define SUM_EXPONENT 23                 // the sum is greater than its first term 13591409 > 2^23
+
+
+/************************************************************************************
+ * Chudnovsky formula implementation                                                *
+ * This version distributes the iterations dynamically: processes take chunks of    *
+ * iterations from a shared counter and threads steal work from each other          *
+ * (see common/dynamic_scheduler.c and common/dynamic_schedules.c).                 *
+ *                                                                                  *
+ ************************************************************************************
+ * Chudnovsky formula:                                                              *
+ *     426880 sqrt(10005)                 (6n)! (545140134n + 13591409)             *
+ *    --------------------  = SUMMATORY( ----------------------------- ),  n >=0    *
+ *            pi                            (n!)^3 (3n)! (-640320)^3n               *
+ *                                                                                  *
+ ************************************************************************************
+ * Chudnovsky formula dependencies:                                                 *
+ *                     (6n)!         (12n + 10)(12n + 6)(12n + 2)                   *
+ *      dep_a(n) = --------------- = ---------------------------- * dep_a(n-1)      *
+ *                 ((n!)^3 (3n)!)              (n + 1)^3                            *
+ *                                                                                  *
+ *      dep_b(n) = (-640320)^3n = (-640320)^3(n-1) * (-640320)^3)                   *
+ *                                                                                  *
+ *      dep_c(n) = (545140134n + 13591409) = dep_c(n - 1) + 545140134               *
+ *                                                                                  *
+ * They are only seeded with their closed form when a chunk does not start where    *
+ * the previous chunk of the thread ended.                                          *
+ *                                                                                  *
+ ************************************************************************************/
+
+
+/*
+ * Adds to local_thread_pi the terms of the chunks given to the thread thread_id by the
+ * scheduler, with precision bits. Pi is 426880 sqrt(10005) divided by the sum.
+ */
+void chudnovsky_dynamic_terms_gmp(mpf_t local_thread_pi, struct dynamic_scheduler *scheduler, int thread_id, mp_bitcnt_t precision){
+    long i, chunk_start, chunk_end, previous_end, factor_a, exponent, block_start, block_end;
+    mp_bitcnt_t working_precision;
+    mpf_t dep_a, dep_a_dividend, dep_a_divisor, dep_b, dep_c, c, aux;
+
+    mpf_init2(dep_a, precision);
+    mpf_init2(dep_b, precision);
+    mpf_init2(dep_c, precision);
+    mpf_init2(dep_a_dividend, precision);
+    mpf_init2(dep_a_divisor, precision);
+    mpf_init2(aux, precision);
+    mpf_init2(c, precision);
+    mpf_set_si(c, -C);
+    mpf_pow_ui(c, c, 3);
+    previous_end = -1;
+    factor_a = 0;                       // seeded with the first chunk
+
+    mark_phase(SEED_PHASE);
+    while (next_chunk(scheduler, thread_id, &chunk_start, &chunk_end)) {
+        if (chunk_start != previous_end) {
+            //Seed dep_a, dep_b and dep_c
+            working_precision = working_precision_gmp(precision, BITS_PER_TERM, chunk_start);
+            set_working_precision_gmp(working_precision, dep_a, dep_b, NULL);
+            seed_chudnovsky_gmp(dep_a, dep_b, dep_c, chunk_start);
+            if (options.block_terms > 1) mpf_div(dep_a, dep_a, dep_b);     // x = dep_a / dep_b
+            factor_a = 12 * chunk_start;
+        }
+        if (options.block_terms > 1) {
+            for (block_start = chunk_start; block_start < chunk_end; block_start = block_end) {
+                block_end = (chunk_end - block_start < options.block_terms) ? chunk_end : block_start + options.block_terms;
+                chudnovsky_rational_blocks_gmp(local_thread_pi, dep_a, block_start, block_end, options.block_terms);
+                //dep_a is x(block_end), so the term block_end is dep_a dep_c(block_end)
+                mpf_mul_ui(aux, dep_a, (unsigned long) B * block_end + A);
+                mpf_get_d_2exp(&exponent, aux);
+                report_term_exponent(scheduler, block_end, exponent - SUM_EXPONENT);
+            }
+        } else {
+            for (i = chunk_start; i < chunk_end; i++) {
+                //Work with the precision needed by the term i
+                working_precision = working_precision_gmp(precision, BITS_PER_TERM, i);
+                set_working_precision_gmp(working_precision, dep_a, dep_b, dep_a_dividend, dep_a_divisor, aux, NULL);
+                chudnovsky_iteration_gmp(local_thread_pi, i, dep_a, dep_b, dep_c, aux);
+                mpf_get_d_2exp(&exponent, aux);
+                report_term_exponent(scheduler, i, exponent - SUM_EXPONENT);
+                //Update dep_a:
+                mpf_set_ui(dep_a_dividend, factor_a + 10);
+                mpf_mul_ui(dep_a_dividend, dep_a_dividend, factor_a + 6);
+                mpf_mul_ui(dep_a_dividend, dep_a_dividend, factor_a + 2);
+                mpf_mul(dep_a_dividend, dep_a_dividend, dep_a);
+
+                mpf_set_ui(dep_a_divisor, i + 1);
+                mpf_pow_ui(dep_a_divisor, dep_a_divisor, 3);
+                mpf_div(dep_a, dep_a_dividend, dep_a_divisor);
+                factor_a += 12;
+
+                //Update dep_b:
+                mpf_mul(dep_b, dep_b, c);
+
+                //Update dep_c:
+                mpf_add_ui(dep_c, dep_c, B);
+            }
+        }
+        previous_end = chunk_end;
+    }
+
+    //Clear memory
+    set_working_precision_gmp(precision, dep_a, dep_b, dep_a_dividend, dep_a_divisor, aux, NULL);
+    mpf_clears(dep_a, dep_a_dividend, dep_a_divisor, dep_b, dep_c, c, aux, NULL);
+}
+
@@ -1,7 +0,0 @@
-#ifndef CHUDNOVSKY_NON_UNIFORM_AND_BLOCKS_GMP
-#define CHUDNOVSKY_NON_UNIFORM_AND_BLOCKS_GMP
-
-void chudnovsky_non_uniform_and_blocks_algorithm_gmp(int, int, mpf_t, int, int);
-
-#endif
-
@@ -0,0 +1,131 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <gmp.h>
+#include "../working_precision.h"
+#include "../../common/progress.h"
+
+#define A 13591409
+#define B 545140134
+#define C 640320
+#define BITS_PER_TERM 47.11             // log2(640320^3 / 12^3)
+
+
+/************************************************************************************
+ * Chudnovsky formula evaluated in blocks of k terms                                *
+ * Every block is gathered in one exact rational, so there is only one division     *
+ * of the working precision per block instead of two per term.                      *
+ *                                                                                  *
+ ************************************************************************************
+ * With x(n) = dep_a(n) / dep_b(n) and dep_c(n) = 545140134n + 13591409:            *
+ *                                                                                  *
+ *                          p(n)                                                    *
+ *      x(n + 1) = x(n) * ------,     p(n) = (12n + 2)(12n + 6)(12n + 10)           *
+ *                          q(n)      q(n) = -(n + 1)^3 640320^3                    *
+ *                                                                                  *
+ * so the block [n, n + k) is x(n) times the rational computed from the last term   *
+ * with Horner's rule:                                                              *
+ *                                                                                  *
+ *              p(n)               p(n + 1)         p(n + k - 2)                    *
+ *   dep_c(n) + ---- (dep_c(n+1) + -------- ( ... + ------------ dep_c(n+k-1)))     *
+ *              q(n)               q(n + 1)         q(n + k - 2)                    *
+ *                                                                                  *
+ *   SUM = numerator * y,            x(n + k) = product * y,                        *
+ *                                                                                  *
+ *                     x(n)                                                         *
+ *   with  y = ---------------------,  product = p(n) ... p(n + k - 1)              *
+ *              q(n) ... q(n + k - 1)                                               *
+ *                                                                                  *
+ ************************************************************************************/
+
+
+/*
+ * p(n) and q(n) of the ratio between consecutive x(n)
+ */
+void chudnovsky_ratio_gmp(mpz_t p, mpz_t q, long n){
+    mpz_set_ui(p, 12 * (unsigned long) n + 2);
+    mpz_mul_ui(p, p, 12 * (unsigned long) n + 6);
+    mpz_mul_ui(p, p, 12 * (unsigned long) n + 10);
+
+    mpz_ui_pow_ui(q, C, 3);
+    mpz_mul_ui(q, q, (unsigned long) n + 1);
+    mpz_mul_ui(q, q, (unsigned long) n + 1);
+    mpz_mul_ui(q, q, (unsigned long) n + 1);
+    mpz_neg(q, q);
+}
+
+/*
+ * Exact rational of the block of k terms starting at n:
+ *      SUM(x(n) ... x(n + k - 1)) = x(n) numerator / denominator
+ *                  x(n + k)       = x(n) product / denominator
+ */
+void chudnovsky_rational_block_gmp(mpz_t numerator, mpz_t denominator, mpz_t product, long n, int k){
+    long i;
+    mpz_t p, q;
+
+    mpz_inits(p, q, NULL);
+
+    //Start from the last term of the block
+    mpz_set_ui(numerator, (unsigned long) B * (n + k - 1) + A);
+    mpz_set_ui(denominator, 1);
+    mpz_set_ui(product, 1);
+
+    for (i = n + k - 2; i >= n; i--) {
+        // numerator / denominator = dep_c(i) + p(i) / q(i) * numerator / denominator
+        chudnovsky_ratio_gmp(p, q, i);
+        mpz_mul(numerator, numerator, p);
+        mpz_mul(denominator, denominator, q);
+        mpz_addmul_ui(numerator, denominator, (unsigned long) B * i + A);
+        mpz_mul(product, product, p);
+    }
+
+    //Add the ratio of the last term, needed to get x(n + k)
+    chudnovsky_ratio_gmp(p, q, n + k - 1);
+    mpz_mul(numerator, numerator, q);
+    mpz_mul(denominator, denominator, q);
+    mpz_mul(product, product, p);
+
+    mpz_clears(p, q, NULL);
+}
+
+/*
+ * Adds the terms [start, end) to pi in blocks of block_terms terms.
+ * x should be x(start) = dep_a(start) / dep_b(start) and it is left as x(end).
+ */
+void chudnovsky_rational_blocks_gmp(mpf_t pi, mpf_t x, long start, long end, int block_terms){
+    long n;
+    int k;
+    mp_bitcnt_t precision, working_precision;
+    mpz_t numerator, denominator, product;
+    mpf_t y, aux;
+
+    precision = mpf_get_default_prec();
+    mpz_inits(numerator, denominator, product, NULL);
+    mpf_inits(y, aux, NULL);
+
+    for (n = start; n < end; n += k) {
+        k = (end - n < block_terms) ? (int) (end - n) : block_terms;
+        //Work with the precision needed by the first term of the block
+        working_precision = working_precision_gmp(precision, BITS_PER_TERM, n);
+        set_working_precision_gmp(working_precision, x, y, aux, NULL);
+        chudnovsky_rational_block_gmp(numerator, denominator, product, n, k);
+
+        // y = x / denominator
+        mpf_set_z(aux, denominator);
+        mpf_div(y, x, aux);
+
+        // pi = pi + y * numerator
+        mpf_set_z(aux, numerator);
+        mpf_mul(aux, aux, y);
+        mpf_add(pi, pi, aux);
+
+        // x = y * product
+        mpf_set_z(aux, product);
+        mpf_mul(x, y, aux);
+        add_progress(k);
+    }
+
+    set_working_precision_gmp(precision, y, aux, NULL);
+    mpz_clears(numerator, denominator, product, NULL);
+    mpf_clears(y, aux, NULL);
+}
+
@@ -0,0 +1,9 @@
+#ifndef CHUDNOVSKY_RATIONAL_BLOCKS_GMP
+#define CHUDNOVSKY_RATIONAL_BLOCKS_GMP
+
+void chudnovsky_rational_block_gmp(mpz_t, mpz_t, mpz_t, long, int);
+
+void chudnovsky_rational_blocks_gmp(mpf_t, mpf_t, long, long, int);
+
+#endif
+
@@ -1,7 +0,0 @@
-#ifndef CHUDNOVSKY_SNAKE_LIKE_AND_BLOCKS_GMP
-#define CHUDNOVSKY_SNAKE_LIKE_AND_BLOCKS_GMP
-
-void chudnovsky_snake_like_and_blocks_algorithm_gmp(int, int, mpf_t, int, int);
-
-#endif
-
@@ -0,0 +1,71 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <gmp.h>
+#include <omp.h>
+#include "mpi.h"
+#include "../parallel_arithmetic.h"
+#include "../../common/progress.h"
+
+
+/************************************************************************************
+ * Gauss-Legendre algorithm implementation                                          *
+ * The arithmetic-geometric mean converges quadratically, so there are only a few   *
+ * iterations and all of them depend on the previous one. The parallelism is in     *
+ * the products and square roots of full precision (see parallel_arithmetic.c),     *
+ * which are split among the threads of process 0.                                  *
+ *                                                                                  *
+ ************************************************************************************
+ * Gauss-Legendre algorithm:                                                        *
+ *                                                                                  *
+ *   a(0) = 1,   b(0) = 1 / sqrt(2),   t(0) = 1 / 4,   p(0) = 1                     *
+ *                                                                                  *
+ *             a(n) + b(n)                                                          *
+ *   a(n+1) = -------------,   b(n+1) = sqrt(a(n) b(n)),                            *
+ *                  2                                                               *
+ *                                                                                  *
+ *   t(n+1) = t(n) - p(n) (a(n) - a(n+1))^2,   p(n+1) = 2 p(n)                      *
+ *                                                                                  *
+ *             (a(n) + b(n))^2                                                      *
+ *   pi ~= -----------------                                                        *
+ *                4 t(n)                                                            *
+ *                                                                                  *
+ ************************************************************************************/
+
+
+void gauss_legendre_algorithm_gmp(MPI_Comm comm, int num_procs, int proc_id, mpf_t pi, long num_iterations, int num_threads){
+    int i;
+    mpf_t a, b, t, next_a, aux;
+
+    (void) comm;
+    (void) num_procs;
+
+    //The iterations are not distributed among the processes
+    if (proc_id != 0) return;
+
+    mpf_inits(a, b, t, next_a, aux, NULL);
+    mpf_set_ui(a, 1);
+    mpf_set_d(aux, 0.5);
+    parallel_sqrt_gmp(b, aux, num_threads);         // b = sqrt(1/2)
+    mpf_set_d(t, 0.25);
+
+    for (i = 0; i < num_iterations; i++) {
+        mpf_add(next_a, a, b);
+        mpf_div_2exp(next_a, next_a, 1);            // next_a = (a + b) / 2
+        parallel_mul_gmp(aux, a, b, num_threads);
+        parallel_sqrt_gmp(b, aux, num_threads);     // b = sqrt(a b)
+        mpf_sub(aux, a, next_a);
+        parallel_mul_gmp(aux, aux, aux, num_threads);
+        mpf_mul_2exp(aux, aux, i);
+        mpf_sub(t, t, aux);                         // t = t - p (a - next_a)^2
+        mpf_swap(a, next_a);
+        add_progress(1);
+    }
+
+    mpf_add(aux, a, b);
+    parallel_mul_gmp(aux, aux, aux, num_threads);
+    mpf_div_2exp(aux, aux, 2);
+    mpf_div(pi, aux, t);                            // pi = (a + b)^2 / 4t
+
+    mpf_clears(a, b, t, next_a, aux, NULL);
+}
+
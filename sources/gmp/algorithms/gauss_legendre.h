@@ -0,0 +1,7 @@
+#ifndef GAUSS_LEGENDRE_GMP
+#define GAUSS_LEGENDRE_GMP
+
+void gauss_legendre_algorithm_gmp(MPI_Comm, int, int, mpf_t, long, int);
+
+#endif
+
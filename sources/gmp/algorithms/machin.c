@@ -0,0 +1,200 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <gmp.h>
+#include <omp.h>
+#include "mpi.h"
+#include "../mpi_operations.h"
+#include "../omp_operations.h"
+#include "../fixed_point.h"
+#include "../../common/phase_timer.h"
+#include "machin.h"
+
+
+/************************************************************************************
+ * Machin-like formulas implementation                                              *
+ * Every arctan is an independent task given to a group of processes (an MPI        *
+ * sub-communicator), and its terms are split among the threads of the group. The   *
+ * partial sums are multiplied by their coefficients and added in one reduction.    *
+ *                                                                                  *
+ ************************************************************************************
+ * Takano:                                                                          *
+ *   pi / 4 = 12 arctan(1/49) + 32 arctan(1/57) - 5 arctan(1/239)                   *
+ *            + 12 arctan(1/110443)                                                 *
+ *                                                                                  *
+ * Stormer:                                                                         *
+ *   pi / 4 = 44 arctan(1/57) + 7 arctan(1/239) - 12 arctan(1/682)                  *
+ *            + 24 arctan(1/12943)                                                  *
+ *                                                                                  *
+ *                          (-1)^n                                                  *
+ *   arctan(1/k) = SUM( ----------------- ),  n >= 0                                *
+ *                      (2n + 1) k^(2n+1)                                           *
+ *                                                                                  *
+ ************************************************************************************
+ * The terms are added as fixed point integers (see gmp/fixed_point.c). The power   *
+ * 1/k^(2n+1) is kept as a fraction of the sum precision: every term is one         *
+ * division of the power by 2n + 1 and the next power is one division by k^2. The   *
+ * power loses 2 log2(k) bits per term, so its leading zero limbs are skipped and   *
+ * the cost of the term n decreases linearly with n. A worker of the group gets the *
+ * terms [N (1 - sqrt(1 - w/W)), N (1 - sqrt(1 - (w + 1)/W))), that have the same   *
+ * cost, and its first power is computed with one division.                         *
+ *                                                                                  *
+ * The processes are given to the arctans in proportion to their cost, which is     *
+ * proportional to 1 / log2(k). With fewer processes than arctans every process     *
+ * computes several of them.                                                        *
+ *                                                                                  *
+ ************************************************************************************/
+
+
+const struct machin_formula takano_formula = {{12, 32, -5, 12}, {49, 57, 239, 110443}};
+const struct machin_formula stormer_formula = {{44, 7, -12, 24}, {57, 239, 682, 12943}};
+
+
+/*
+ * Sum of the terms [first, last) of arctan(1/k) with precision fraction bits.
+ * The sum is returned in result scaled by 2^bits, returning bits.
+ */
+mp_bitcnt_t arctan_fixed_point_sum_gmp(mpz_t result, unsigned long k, long first, long last, mp_bitcnt_t precision){
+    long n;
+    size_t power_size;
+    mp_bitcnt_t bits;
+    mp_limb_t *power;
+    mpz_t aux, divisor;
+    struct fixed_point_sum sum;
+
+    init_fixed_point_sum(&sum, precision);
+    power = calloc(sum.size, sizeof(mp_limb_t));
+
+    //power = 1/k^(2 first + 1) with the fraction limbs of the sum
+    mpz_inits(aux, divisor, NULL);
+    mpz_setbit(aux, (mp_bitcnt_t) (sum.size - 1) * GMP_NUMB_BITS);
+    mpz_ui_pow_ui(divisor, k, 2 * (unsigned long) first + 1);
+    mpz_tdiv_q(aux, aux, divisor);
+    mpz_export(power, &power_size, -1, sizeof(mp_limb_t), 0, 0, aux);
+    mpz_clears(aux, divisor, NULL);
+
+    for (n = first; n < last && power_size > 0; n++) {
+        add_fixed_point_fraction(&sum, power, power_size, 2 * (unsigned long) n + 1, (n % 2 == 0) ? 1 : -1);
+        mpn_divrem_1(power, 0, power, power_size, k * k);
+        while (power_size > 0 && power[power_size - 1] == 0) power_size--;
+    }
+
+    bits = get_fixed_point_sum(result, &sum);
+    clear_fixed_point_sum(&sum);
+    free(power);
+
+    return bits;
+}
+
+/*
+ * Splits the processes in groups and gives every arctan of formula to one group.
+ * It stores in arctan_groups the group of every arctan and returns the group of proc_id.
+ */
+int machin_groups(const struct machin_formula *formula, int num_procs, int proc_id, int *arctan_groups){
+    int i, proc, best, group_size[MACHIN_ARCTANS], first_proc;
+    double weight[MACHIN_ARCTANS];
+
+    if (num_procs < MACHIN_ARCTANS) {
+        for (i = 0; i < MACHIN_ARCTANS; i++) arctan_groups[i] = i % num_procs;
+        return proc_id;
+    }
+
+    //Every new process goes to the arctan with the greatest cost per process
+    for (i = 0; i < MACHIN_ARCTANS; i++) {
+        arctan_groups[i] = i;
+        group_size[i] = 1;
+        weight[i] = 1 / log2((double) formula -> denominators[i]);
+    }
+    for (proc = MACHIN_ARCTANS; proc < num_procs; proc++) {
+        best = 0;
+        for (i = 1; i < MACHIN_ARCTANS; i++) {
+            if (weight[i] / group_size[i] > weight[best] / group_size[best]) best = i;
+        }
+        group_size[best]++;
+    }
+
+    first_proc = 0;
+    for (i = 0; i < MACHIN_ARCTANS; i++) {
+        if (proc_id < first_proc + group_size[i]) return i;
+        first_proc += group_size[i];
+    }
+    return MACHIN_ARCTANS - 1;
+}
+
+/*
+ * Terms [first, last) of the arctan of formula computed by the worker of num_workers
+ * with precision bits, with the same cost for every worker
+ */
+void machin_worker_terms(const struct machin_formula *formula, int arctan, mp_bitcnt_t precision,
+                    int worker, int num_workers, long *first, long *last){
+    long num_terms;
+
+    num_terms = (long) ceil(precision / (2 * log2((double) formula -> denominators[arctan]))) + 1;
+    *first = (long) (num_terms * (1 - sqrt(1 - (double) worker / num_workers)));
+    *last = (worker == num_workers - 1) ? num_terms : (long) (num_terms * (1 - sqrt(1 - (double) (worker + 1) / num_workers)));
+}
+
+
+void machin_algorithm_gmp(MPI_Comm comm, int num_procs, int proc_id, mpf_t pi, const struct machin_formula *formula, int num_threads){
+    int group, group_id, group_procs, arctan_groups[MACHIN_ARCTANS];
+    mp_bitcnt_t precision;
+    mpf_t local_proc_pi;
+    MPI_Comm group_comm;
+
+    precision = mpf_get_default_prec();
+    init_transport_gmp(local_proc_pi);
+
+    //Every group of processes works on its arctans
+    group = machin_groups(formula, num_procs, proc_id, arctan_groups);
+    MPI_Comm_split(comm, group, proc_id, &group_comm);
+    MPI_Comm_rank(group_comm, &group_id);
+    MPI_Comm_size(group_comm, &group_procs);
+
+    //Set the number of threads 
+    omp_set_num_threads(num_threads);
+
+    #pragma omp parallel
+    {
+        int thread_id, arctan;
+        long first, last;
+        mp_bitcnt_t bits;
+        mpz_t thread_sum, arctan_sum;
+        mpf_t local_thread_pi;
+
+        thread_id = omp_get_thread_num();
+        mpz_inits(thread_sum, arctan_sum, NULL);
+        mpf_init(local_thread_pi);
+
+        mark_phase(SEED_PHASE);
+        //First Phase -> Working on a local fixed point sum of every arctan of the group
+        bits = 0;
+        for (arctan = 0; arctan < MACHIN_ARCTANS; arctan++) {
+            if (arctan_groups[arctan] != group) continue;
+            machin_worker_terms(formula, arctan, precision, group_id * num_threads + thread_id, 
+                                group_procs * num_threads, &first, &last);
+            bits = arctan_fixed_point_sum_gmp(arctan_sum, formula -> denominators[arctan], first, last, precision);
+            if (formula -> coefficients[arctan] > 0) {
+                mpz_addmul_ui(thread_sum, arctan_sum, 4 * formula -> coefficients[arctan]);
+            } else {
+                mpz_submul_ui(thread_sum, arctan_sum, -4 * formula -> coefficients[arctan]);
+            }
+        }
+        mpf_set_z(local_thread_pi, thread_sum);
+        mpf_div_2exp(local_thread_pi, local_thread_pi, bits);
+
+        //Second Phase -> Accumulate the result in the global variable
+        reduce_threads_gmp(local_proc_pi, local_thread_pi);
+
+        //Clear memory
+        mpz_clears(thread_sum, arctan_sum, NULL);
+        mpf_clear(local_thread_pi);
+    }
+
+    //Reduce local_proc_pi in global Pi
+    reduce_add_gmp(comm, pi, local_proc_pi, proc_id);
+
+    //Clear memory
+    MPI_Comm_free(&group_comm);
+    clear_transport_gmp(local_proc_pi);
+}
+
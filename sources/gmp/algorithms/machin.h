@@ -0,0 +1,21 @@
+#ifndef MACHIN_GMP
+#define MACHIN_GMP
+
+#define MACHIN_ARCTANS 4
+
+struct machin_formula {
+    int coefficients[MACHIN_ARCTANS];
+    unsigned long denominators[MACHIN_ARCTANS];
+};
+
+extern const struct machin_formula takano_formula;
+extern const struct machin_formula stormer_formula;
+
+void machin_algorithm_gmp(MPI_Comm, int, int, mpf_t, const struct machin_formula *, int);
+
+int machin_groups(const struct machin_formula *, int, int, int *);
+void machin_worker_terms(const struct machin_formula *, int, mp_bitcnt_t, int, int, long *, long *);
+mp_bitcnt_t arctan_fixed_point_sum_gmp(mpz_t, unsigned long, long, long, mp_bitcnt_t);
+
+#endif
+
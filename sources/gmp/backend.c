@@ -0,0 +1,191 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <gmp.h>
+#include "mpi.h"
+#include "mpi_operations.h"
+#include "omp_operations.h"
+#include "working_precision.h"
+#include "seeding.h"
+#include "parallel_arithmetic.h"
+#include "scheduler.h"
+#include "algorithms/chudnovsky_rational_blocks.h"
+#include "algorithms/chudnovsky_blocks_and_cyclic.h"
+#include "algorithms/bbp_dynamic_and_stealing.h"
+#include "algorithms/bellard_dynamic_and_stealing.h"
+#include "algorithms/chudnovsky_dynamic_and_stealing.h"
+#include "../common/options.h"
+#include "../common/phase_timer.h"
+#include "../common/dynamic_scheduler.h"
+#include "../common/backend.h"
+#include "backend.h"
+
+#define B 545140134
+#define C 640320
+#define D 426880
+#define E 10005
+#define BITS_PER_TERM 47.11             // log2(640320^3 / 12^3)
+
+
+/************************************************************************************
+ * GMP backend of the schedules of common/chudnovsky_schedules.c and                *
+ * common/dynamic_schedules.c                                                       *
+ *                                                                                  *
+ ************************************************************************************
+ * The numbers are mpf_ptr with the precision bits given by the schedules, which    *
+ * are the default precision set by init_pi_gmp, as the transport buffers of the    *
+ * reductions are always created with the default precision.                        *
+ *                                                                                  *
+ ************************************************************************************/
+
+
+static void * init_number_gmp(long precision_bits, bool transport){
+    mpf_ptr number = malloc(sizeof(__mpf_struct));
+
+    if (transport) {
+        init_transport_gmp(number);
+    } else {
+        mpf_init2(number, precision_bits);
+        mpf_set_ui(number, 0);
+    }
+    return number;
+}
+
+static void clear_number_gmp(void *number, bool transport){
+    if (transport) clear_transport_gmp(number);
+    else mpf_clear(number);
+    free(number);
+}
+
+static void reduce_threads_backend_gmp(void *local_proc_pi, void *local_thread_pi){
+    reduce_threads_gmp(local_proc_pi, local_thread_pi);
+}
+
+static void reduce_processes_gmp(MPI_Comm comm, void *pi, void *local_proc_pi, int proc_id){
+    reduce_add_gmp(comm, pi, local_proc_pi, proc_id);
+}
+
+static void div_ui_gmp(void *x, void *y, unsigned long n){
+    mpf_div_ui(x, y, n);
+}
+
+/*
+ * Adds to local_thread_pi the Chudnovsky terms start, start + step, ... before end
+ */
+static void chudnovsky_terms_gmp(void *local_thread_pi, long start, long end, long step, long precision_bits){
+    long i, factor_a;
+    mp_bitcnt_t precision, working_precision;
+    mpf_t dep_a, dep_a_dividend, dep_a_divisor, dep_b, dep_c, jump, aux;
+
+    if (start >= end) return;
+    precision = precision_bits;
+    mpf_init2(dep_a, precision);
+    mpf_init2(dep_b, precision);
+    mpf_init2(dep_c, precision);
+    mpf_init2(dep_a_dividend, precision);
+    mpf_init2(dep_a_divisor, precision);
+    mpf_init2(jump, precision);
+    mpf_init2(aux, precision);
+    mpf_set_si(jump, -C);
+    mpf_pow_ui(jump, jump, 3 * step);               // jump = (-640320)^(3 step)
+    seed_chudnovsky_gmp(dep_a, dep_b, dep_c, start);
+    factor_a = 12 * start;
+
+    mark_phase(SEED_PHASE);
+    if (step == 1 && options.block_terms > 1) {
+        mpf_div(dep_a, dep_a, dep_b);     // x = dep_a / dep_b
+        chudnovsky_rational_blocks_gmp(local_thread_pi, dep_a, start, end, options.block_terms);
+    } else {
+        for (i = start; i < end; i += step) {
+            //Work with the precision needed by the term i
+            working_precision = working_precision_gmp(precision, BITS_PER_TERM, i);
+            set_working_precision_gmp(working_precision, dep_a, dep_b, dep_a_dividend, dep_a_divisor, aux, NULL);
+            chudnovsky_iteration_gmp(local_thread_pi, i, dep_a, dep_b, dep_c, aux);
+            //Update dep_a:
+            if (step == 1) {
+                mpf_set_ui(dep_a_dividend, factor_a + 10);
+                mpf_mul_ui(dep_a_dividend, dep_a_dividend, factor_a + 6);
+                mpf_mul_ui(dep_a_dividend, dep_a_dividend, factor_a + 2);
+                mpf_mul(dep_a_dividend, dep_a_dividend, dep_a);
+
+                mpf_set_ui(dep_a_divisor, i + 1);
+                mpf_pow_ui(dep_a_divisor, dep_a_divisor, 3);
+                mpf_div(dep_a, dep_a_dividend, dep_a_divisor);
+                factor_a += 12;
+            } else {
+                compute_portion_of_dep_a_gmp(dep_a, i + step, i);
+            }
+
+            //Update dep_b:
+            mpf_mul(dep_b, dep_b, jump);
+
+            //Update dep_c:
+            mpf_add_ui(dep_c, dep_c, B * (unsigned long) step);
+        }
+    }
+
+    set_working_precision_gmp(precision, dep_a, dep_b, dep_a_dividend, dep_a_divisor, aux, NULL);
+    mpf_clears(dep_a, dep_a_dividend, dep_a_divisor, dep_b, dep_c, jump, aux, NULL);
+}
+
+static void * start_chudnovsky_constant_gmp(long precision_bits){
+    struct sqrt_constant_gmp *constant = malloc(sizeof(struct sqrt_constant_gmp));
+
+    start_sqrt_constant_gmp(constant, D, E, precision_bits);
+    return constant;
+}
+
+static void finish_chudnovsky_gmp(void *pi, void *constant, int num_threads){
+    mpf_t e;
+
+    mpf_init2(e, mpf_get_prec(pi));
+    wait_sqrt_constant_gmp(e, constant);
+    parallel_div_gmp(pi, e, pi, num_threads);
+    mpf_clear(e);
+    free(constant);
+}
+
+static long * chudnovsky_schedule_backend_gmp(MPI_Comm comm, long num_iterations, int num_workers, double *weights, int proc_id, long precision_bits){
+    struct cost_model_gmp model;
+
+    init_cost_model_gmp(&model);
+    if (options.calibrate) calibrate_cost_model_gmp(comm, &model, proc_id);
+    return chudnovsky_schedule_gmp(&model, num_iterations, num_workers, weights, precision_bits);
+}
+
+/*
+ * Adds to local_thread_pi the terms of series of the chunks given to the thread thread_id
+ */
+static void dynamic_terms_gmp(enum series series, void *local_thread_pi, struct dynamic_scheduler *scheduler, int thread_id, long precision_bits){
+    switch (series)
+    {
+    case BBP_SERIES:
+        bbp_dynamic_terms_gmp(local_thread_pi, scheduler, thread_id, precision_bits);
+        break;
+    case BELLARD_SERIES:
+        bellard_dynamic_terms_gmp(local_thread_pi, scheduler, thread_id, precision_bits);
+        break;
+    case CHUDNOVSKY_SERIES:
+        chudnovsky_dynamic_terms_gmp(local_thread_pi, scheduler, thread_id, precision_bits);
+        break;
+    default:
+        printf("  The series has no dynamic terms in the GMP backend \n");
+        exit(-1);
+    }
+}
+
+
+struct backend backend_gmp = {
+    .library = "GMP",
+    .init_number = init_number_gmp,
+    .clear_number = clear_number_gmp,
+    .reduce_threads = reduce_threads_backend_gmp,
+    .reduce_processes = reduce_processes_gmp,
+    .div_ui = div_ui_gmp,
+    .chudnovsky_terms = chudnovsky_terms_gmp,
+    .start_chudnovsky_constant = start_chudnovsky_constant_gmp,
+    .finish_chudnovsky = finish_chudnovsky_gmp,
+    .dynamic_terms = dynamic_terms_gmp,
+    .chudnovsky_schedule = chudnovsky_schedule_backend_gmp,
+};
+
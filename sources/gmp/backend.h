@@ -0,0 +1,9 @@
+#ifndef BACKEND_GMP
+#define BACKEND_GMP
+
+#include "../common/backend.h"
+
+extern struct backend backend_gmp;
+
+#endif
+
@@ -2,33 +2,106 @@
 #include <stdlib.h>
 #include <gmp.h>
 #include <omp.h>
+#include "mpi.h"
+#include "radix_conversion.h"
+#include "../common/options.h"
+#include "../common/digit_extraction.h"
 
 
-int check_decimals_gmp(mpf_t pi){
-    //Cast the number we want to check to string
-    int bytes_of_pi = ((pi -> _mp_prec + 1) * sizeof(mp_limb_t)) * sizeof(int); 
-    char calculated_pi[bytes_of_pi]; 
-    gmp_sprintf(calculated_pi, "%.Ff", pi);
+long check_decimals_gmp(mpf_t pi){
+    long num_decimals, bytes_of_pi, correct_bytes;
+    struct digit_writer writer;
 
-    //Read the correct pi number from numeroPiCorrecto.txt file and compares the decimals to calculated pi
-    FILE * file;
-    file = fopen("resources/numero_pi_correcto.txt", "r");
-    if(file == NULL){
+    //The integer part of pi has one digit, otherwise no decimal is correct
+    if (mpf_sgn(pi) < 0 || mpf_cmp_ui(pi, 10) >= 0) return 0;
+
+    //Map the correct pi number of numero_pi_correcto.txt file in memory
+    if (!open_reference_file(&writer, "resources/numero_pi_correcto.txt")) {
         printf("numero_pi_correcto.txt not found \n");
         exit(-1);
-    } 
+    }
+
+    //Cast the number we want to check to decimal comparing every block of digits with the correct pi
+    num_decimals = (long) (mpf_get_prec(pi) * 0.30103) + 1;       // log10(2)
+    if (num_decimals > writer.reference_length) num_decimals = writer.reference_length;
+    bytes_of_pi = write_decimals_gmp(pi, num_decimals, &writer);
+    correct_bytes = (writer.mismatch < bytes_of_pi) ? writer.mismatch : bytes_of_pi;
+
+    close_reference_file(&writer);
+
+    return (correct_bytes < 2) ? 0 : correct_bytes - 2;
+}
+
+/*
+ * The SPOT_HEX_DIGITS hex digits of x after the first position hex digits:
+ * floor(x 16^(position + SPOT_HEX_DIGITS)) mod 16^SPOT_HEX_DIGITS
+ */
+static unsigned long hex_digits_gmp(mpf_t x, long position){
+    unsigned long digits;
+    mpz_t aux;
+    mpf_t shifted_x;
+
+    mpz_init(aux);
+    mpf_init2(shifted_x, mpf_get_prec(x));
+    mpf_mul_2exp(shifted_x, x, 4 * (position + SPOT_HEX_DIGITS));
+    mpz_set_f(aux, shifted_x);
+    mpz_fdiv_r_2exp(aux, aux, 4 * SPOT_HEX_DIGITS);
+    digits = mpz_get_ui(aux);
+    mpz_clear(aux);
+    mpf_clear(shifted_x);
+
+    return digits;
+}
 
-    char correct_pi_char;
-    int i = 0;
-    while((correct_pi_char = fgetc(file)) != EOF){
-        if( (i >= bytes_of_pi) || (correct_pi_char != calculated_pi[i])){
-            break;
+/*
+ * Checks SPOT_HEX_DIGITS hex digits of pi (computed in process 0) at options.spot_checks
+ * positions with the BBP digit extraction. Every process should call it.
+ * It returns the decimals that are correct according to the positions checked.
+ */
+long spot_check_decimals_gmp(MPI_Comm comm, mpf_t pi, long precision, int num_procs, int proc_id){
+    int i, num_positions;
+    long decimals;
+    long *positions;
+    unsigned long *digits, *computed_digits;
+
+    num_positions = options.spot_checks;
+    positions = malloc(num_positions * sizeof(long));
+    digits = malloc(num_positions * sizeof(unsigned long));
+    computed_digits = malloc(num_positions * sizeof(unsigned long));
+
+    choose_spot_positions(comm, positions, num_positions, precision);
+    compute_spot_digits(comm, positions, digits, num_positions, num_procs, proc_id);
+
+    decimals = 0;
+    if (proc_id == 0) {
+        for (i = 0; i < num_positions; i++) {
+            computed_digits[i] = hex_digits_gmp(pi, positions[i]);
         }
-        i++;
+        decimals = spot_check_decimals(positions, digits, computed_digits, num_positions, precision);
     }
-    i = (i < 2) ? 0: i - 2;
-    
-    fclose(file);
 
-    return i;
+    free(positions);
+    free(digits);
+    free(computed_digits);
+
+    return decimals;
+}
+
+/*
+ * Checks the first and the last hex digits of the window of length hex digits after start
+ * (the fraction of 16^start pi) with the BBP digit extraction in long double.
+ * It returns the hex digits that are correct according to the positions checked.
+ */
+long check_hex_window_gmp(mpf_t window, long length, long start){
+    int checked_digits;
+    long last_position;
+
+    checked_digits = (length < SPOT_HEX_DIGITS) ? (int) length : SPOT_HEX_DIGITS;
+    if ((hex_digits_gmp(window, 0) ^ bbp_hex_digits(start)) >> (4 * (SPOT_HEX_DIGITS - checked_digits)) != 0) return 0;
+    if (length <= SPOT_HEX_DIGITS) return length;
+
+    last_position = length - SPOT_HEX_DIGITS;
+    if (hex_digits_gmp(window, last_position) != bbp_hex_digits(start + last_position)) return last_position;
+
+    return length;
 }
@@ -1,7 +1,9 @@
 #ifndef CHECK_DECIMALS_GMP
 #define CHECK_DECIMALS_GMP
 
-int check_decimals_gmp(mpf_t);
+long check_decimals_gmp(mpf_t);
+long spot_check_decimals_gmp(MPI_Comm, mpf_t, long, int, int);
+long check_hex_window_gmp(mpf_t, long, long);
 
 #endif
 
@@ -0,0 +1,49 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <gmp.h>
+#include "../common/checkpoint.h"
+
+
+/*
+ * Saves partial_pi as the state of the thread that continues at next_iteration.
+ * The state is the size and the exponent of partial_pi followed by its limbs.
+ */
+void save_checkpoint_gmp(struct checkpoint *checkpoint, long next_iteration, mpf_t partial_pi){
+    size_t num_limbs, state_size;
+    long *state;
+
+    num_limbs = abs(partial_pi -> _mp_size);
+    state_size = 2 * sizeof(long) + num_limbs * sizeof(mp_limb_t);
+    state = malloc(state_size);
+    state[0] = partial_pi -> _mp_size;
+    state[1] = partial_pi -> _mp_exp;
+    memcpy(state + 2, partial_pi -> _mp_d, num_limbs * sizeof(mp_limb_t));
+
+    save_checkpoint(checkpoint, next_iteration, state, state_size);
+    free(state);
+}
+
+/*
+ * Restores partial_pi and next_iteration from the checkpoint of the thread.
+ * It returns false (and does not change them) if there is no checkpoint.
+ */
+bool load_checkpoint_gmp(struct checkpoint *checkpoint, long *next_iteration, mpf_t partial_pi){
+    size_t state_size;
+    long *state;
+    mpf_t saved_pi;
+
+    state = load_checkpoint(checkpoint, next_iteration, &state_size);
+    if (state == NULL) return false;
+
+    //The saved limbs are read in place as a number of their own precision
+    saved_pi -> _mp_size = state[0];
+    saved_pi -> _mp_exp = state[1];
+    saved_pi -> _mp_prec = labs(state[0]);
+    saved_pi -> _mp_d = (mp_limb_t *) (state + 2);
+    mpf_set(partial_pi, saved_pi);
+    free(state);
+
+    return true;
+}
+
@@ -0,0 +1,8 @@
+#ifndef CHECKPOINT_GMP
+#define CHECKPOINT_GMP
+
+void save_checkpoint_gmp(struct checkpoint *, long, mpf_t);
+bool load_checkpoint_gmp(struct checkpoint *, long *, mpf_t);
+
+#endif
+
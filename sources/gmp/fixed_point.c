@@ -0,0 +1,116 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <limits.h>
+#include <gmp.h>
+#include "fixed_point.h"
+
+
+/************************************************************************************
+ * Fixed point sum of the terms of the BBP-like series                              *
+ *                                                                                  *
+ ************************************************************************************
+ * The terms of BBP and Bellard are small numerators divided by small divisors and  *
+ * scaled by a power of two:                                                        *
+ *                                                                                  *
+ *                        numerator                                                 *
+ *              term = --------------- 2^-shift                                     *
+ *                         divisor                                                  *
+ *                                                                                  *
+ * The sum is kept as an integer of size limbs scaled by B^(size - 1), where B is   *
+ * 2^GMP_NUMB_BITS, so the top limb holds the integer part. The scaling 2^-shift is *
+ * split in a limb offset k and a bit offset r < GMP_NUMB_BITS:                     *
+ *                                                                                  *
+ *              2^-shift = 2^r B^-k                                                 *
+ *                                                                                  *
+ * then a term is one mpn_divrem_1 of the (at most two limbs) numerator 2^r         *
+ * developing size - 1 - k fraction limbs, and one mpn_add. The terms get cheaper   *
+ * as shift grows and the ones below the last limb are not computed.                *
+ * Positive and negative terms are accumulated apart, so there are no borrows.      *
+ *                                                                                  *
+ ************************************************************************************/
+
+
+/*
+ * Inits a zero sum with at least precision fraction bits
+ */
+void init_fixed_point_sum(struct fixed_point_sum *sum, mp_bitcnt_t precision){
+    sum -> size = (precision + GMP_NUMB_BITS - 1) / GMP_NUMB_BITS + 1;
+    sum -> positive = calloc(sum -> size, sizeof(mp_limb_t));
+    sum -> negative = calloc(sum -> size, sizeof(mp_limb_t));
+    sum -> quotient = malloc(sum -> size * sizeof(mp_limb_t));
+}
+
+/*
+ * sum = sum + sign * numerator / divisor * 2^-shift
+ */
+void add_fixed_point_term(struct fixed_point_sum *sum, unsigned long numerator, unsigned long divisor, mp_bitcnt_t shift, int sign){
+    mp_limb_t dividend[2];
+    mp_size_t limb_shift, dividend_size, fraction_size;
+    int bit_shift;
+
+    limb_shift = (shift + GMP_NUMB_BITS - 1) / GMP_NUMB_BITS;
+    if (limb_shift >= sum -> size) return;
+    bit_shift = limb_shift * GMP_NUMB_BITS - shift;
+
+    dividend[0] = (mp_limb_t) numerator << bit_shift;
+    dividend[1] = (bit_shift > 0) ? (mp_limb_t) numerator >> (GMP_NUMB_BITS - bit_shift) : 0;
+    dividend_size = (dividend[1] != 0) ? 2 : 1;
+    fraction_size = sum -> size - 1 - limb_shift;
+
+    mpn_divrem_1(sum -> quotient, fraction_size, dividend, dividend_size, divisor);
+    if (sign >= 0) {
+        mpn_add(sum -> positive, sum -> positive, sum -> size, sum -> quotient, fraction_size + dividend_size);
+    } else {
+        mpn_add(sum -> negative, sum -> negative, sum -> size, sum -> quotient, fraction_size + dividend_size);
+    }
+}
+
+/*
+ * sum = sum + sign * (numerator_a / divisor_a + numerator_b / divisor_b) * 2^-shift
+ * The quotients are added as one fraction when it fits in a limb, saving one division.
+ */
+void add_fixed_point_pair(struct fixed_point_sum *sum, unsigned long numerator_a, unsigned long divisor_a,
+                    unsigned long numerator_b, unsigned long divisor_b, mp_bitcnt_t shift, int sign){
+    if (divisor_a <= ULONG_MAX / divisor_b && numerator_a <= ULONG_MAX / 2 / divisor_b 
+            && numerator_b <= ULONG_MAX / 2 / divisor_a) {
+        add_fixed_point_term(sum, numerator_a * divisor_b + numerator_b * divisor_a, divisor_a * divisor_b, shift, sign);
+    } else {
+        add_fixed_point_term(sum, numerator_a, divisor_a, shift, sign);
+        add_fixed_point_term(sum, numerator_b, divisor_b, shift, sign);
+    }
+}
+
+/*
+ * sum = sum + sign * fraction / divisor, where fraction is a number of size limbs
+ * below the point (size < sum -> size)
+ */
+void add_fixed_point_fraction(struct fixed_point_sum *sum, mp_limb_t *fraction, mp_size_t size, unsigned long divisor, int sign){
+    mpn_divrem_1(sum -> quotient, 0, fraction, size, divisor);
+    if (sign >= 0) {
+        mpn_add(sum -> positive, sum -> positive, sum -> size, sum -> quotient, size);
+    } else {
+        mpn_add(sum -> negative, sum -> negative, sum -> size, sum -> quotient, size);
+    }
+}
+
+/*
+ * Sets result to the sum scaled by 2^bits, returning bits.
+ */
+mp_bitcnt_t get_fixed_point_sum(mpz_t result, struct fixed_point_sum *sum){
+    mpz_t negative;
+
+    mpz_init(negative);
+    mpz_import(result, sum -> size, -1, sizeof(mp_limb_t), 0, 0, sum -> positive);
+    mpz_import(negative, sum -> size, -1, sizeof(mp_limb_t), 0, 0, sum -> negative);
+    mpz_sub(result, result, negative);
+    mpz_clear(negative);
+
+    return (mp_bitcnt_t) (sum -> size - 1) * GMP_NUMB_BITS;
+}
+
+void clear_fixed_point_sum(struct fixed_point_sum *sum){
+    free(sum -> positive);
+    free(sum -> negative);
+    free(sum -> quotient);
+}
+
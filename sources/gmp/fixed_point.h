@@ -0,0 +1,19 @@
+#ifndef FIXED_POINT_GMP
+#define FIXED_POINT_GMP
+
+struct fixed_point_sum {
+    mp_limb_t *positive;
+    mp_limb_t *negative;
+    mp_limb_t *quotient;
+    mp_size_t size;
+};
+
+void init_fixed_point_sum(struct fixed_point_sum *, mp_bitcnt_t);
+void add_fixed_point_term(struct fixed_point_sum *, unsigned long, unsigned long, mp_bitcnt_t, int);
+void add_fixed_point_pair(struct fixed_point_sum *, unsigned long, unsigned long, unsigned long, unsigned long, mp_bitcnt_t, int);
+void add_fixed_point_fraction(struct fixed_point_sum *, mp_limb_t *, mp_size_t, unsigned long, int);
+mp_bitcnt_t get_fixed_point_sum(mpz_t, struct fixed_point_sum *);
+void clear_fixed_point_sum(struct fixed_point_sum *);
+
+#endif
+
@@ -1,64 +1,320 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <limits.h>
 #include <gmp.h>
 #include "mpi.h"
+#include "../common/options.h"
+#include "../common/node_reduction.h"
+#include "../common/phase_timer.h"
+#include "../common/large_buffer.h"
+
+#define SEGMENT_DIGIT_BITS 32
+
+/*
+ * Header of the contiguous buffer used to move an mpf_t through MPI.
+ * The (prec + 1) limbs of the mantissa are stored right after the header,
+ * so the buffer is sent as it is, without packing the limbs.
+ */
+struct transport_header_gmp {
+    int size;
+    int prec;
+    mp_exp_t exp;
+};
+
+
+/*
+ * Inits data with the default precision and value 0 inside a transport buffer,
+ * so it can be reduced without copying its limbs.
+ * IMPORTANT: data should be cleared with clear_transport_gmp
+ */
+void init_transport_gmp(mpf_t data){
+    int prec;
+    char *buffer;
+
+    mpf_init(data);
+    prec = data -> _mp_prec;
+    mpf_clear(data);
+
+    buffer = allocate_large_buffer(sizeof(struct transport_header_gmp) + (prec + 1) * sizeof(mp_limb_t));
+    data -> _mp_prec = prec;
+    data -> _mp_size = 0;
+    data -> _mp_exp = 0;
+    data -> _mp_d = (mp_limb_t *) (buffer + sizeof(struct transport_header_gmp));
+}
+
+/*
+ * Frees the transport buffer of data
+ */
+void clear_transport_gmp(mpf_t data){
+    free_large_buffer((char *) data -> _mp_d - sizeof(struct transport_header_gmp));
+}
 
 /*
- * Pack mpf_t type
- * IMPORTANT: mpf_t data should have been previously initialized
+ * Size in bytes of the transport buffer of data
  */
-int pack_gmp(void * buffer, mpf_t data){
-    int position, packet_size;
-    packet_size = 8 + sizeof(mp_exp_t) + ((data -> _mp_prec + 1) * sizeof(mp_limb_t));
-    position = 0;
-    MPI_Pack(&data -> _mp_size, 1, MPI_INT, buffer, packet_size, &position, MPI_COMM_WORLD);
-    MPI_Pack(&data -> _mp_prec, 1, MPI_INT, buffer, packet_size, &position, MPI_COMM_WORLD);
-    MPI_Pack(&data -> _mp_exp, sizeof(mp_exp_t), MPI_BYTE, buffer, packet_size, &position, MPI_COMM_WORLD);
-    MPI_Pack( data -> _mp_d,  (data -> _mp_prec + 1) * sizeof(mp_limb_t), MPI_BYTE, buffer, packet_size, &position, MPI_COMM_WORLD);
-    return position;
+size_t transport_size_gmp(mpf_t data){
+    return sizeof(struct transport_header_gmp) + (data -> _mp_prec + 1) * sizeof(mp_limb_t);
 }
 
 /*
- * Unpack mpf_t type
- * IMPORTANT: mpf_t data should have been previously initialized
+ * Writes the header of the transport buffer of data and returns the buffer
  */
-void unpack_gmp(void * buffer, mpf_t data){
-    int position, packet_size;
-    packet_size = 8 + sizeof(mp_exp_t) + ((data -> _mp_prec + 1) * sizeof(mp_limb_t));
-    position = 0;
-    MPI_Unpack(buffer, packet_size, &position, &data -> _mp_size, 1, MPI_INT, MPI_COMM_WORLD);
-    MPI_Unpack(buffer, packet_size, &position, &data -> _mp_prec, 1, MPI_INT, MPI_COMM_WORLD);
-    MPI_Unpack(buffer, packet_size, &position, &data -> _mp_exp, sizeof(mp_exp_t), MPI_BYTE, MPI_COMM_WORLD);
-    MPI_Unpack(buffer, packet_size, &position,  data -> _mp_d, (data -> _mp_prec + 1) * sizeof(mp_limb_t) , MPI_BYTE, MPI_COMM_WORLD);
+void * transport_buffer_gmp(mpf_t data){
+    struct transport_header_gmp * header;
+    header = (struct transport_header_gmp *) ((char *) data -> _mp_d - sizeof(struct transport_header_gmp));
+    header -> size = data -> _mp_size;
+    header -> prec = data -> _mp_prec;
+    header -> exp = data -> _mp_exp;
+    return header;
+}
+
+/*
+ * Makes view an mpf_t whose limbs are the limbs stored in a transport buffer
+ * IMPORTANT: view should not be initialized nor cleared
+ */
+void view_transport_gmp(mpf_t view, void * buffer){
+    struct transport_header_gmp * header = (struct transport_header_gmp *) buffer;
+    view -> _mp_size = header -> size;
+    view -> _mp_prec = header -> prec;
+    view -> _mp_exp = header -> exp;
+    view -> _mp_d = (mp_limb_t *) ((char *) buffer + sizeof(struct transport_header_gmp));
 }
 
 /*
  * Operation defined for MPI
- * Adds mpf_t types
+ * Adds mpf_t types stored in transport buffers, working on the limbs in place
  */
 void add_gmp(void * invec, void * inoutvec, int *len, MPI_Datatype *dtype){
+    int i;
+    MPI_Count element_size;
     mpf_t a, b;
-    mpf_inits(a, b, NULL);
-    unpack_gmp(invec, a);
-    unpack_gmp(inoutvec, b);
-    mpf_add(b, b, a);
-    pack_gmp(inoutvec, b);
-    mpf_clears(a, b, NULL);
+    MPI_Type_size_x(*dtype, &element_size);
+    for (i = 0; i < *len; i++) {
+        view_transport_gmp(a, (char *) invec + (size_t) i * element_size);
+        view_transport_gmp(b, (char *) inoutvec + (size_t) i * element_size);
+        mpf_add(b, b, a);
+        transport_buffer_gmp(b);
+    }
 }
 
 /*
  * Operation defined for MPI
- * Multiply mpf_t types
+ * Multiply mpf_t types stored in transport buffers, working on the limbs in place
  */
 void mul_gmp(void * invec, void * inoutvec, int *len, MPI_Datatype *dtype){
+    int i;
+    MPI_Count element_size;
     mpf_t a, b;
-    mpf_inits(a, b, NULL);    
-    unpack_gmp(invec, a);
-    unpack_gmp(inoutvec, b);
-    mpf_mul(b, b, a);
-    pack_gmp(inoutvec, b);
-    mpf_clears(a, b, NULL);
+    MPI_Type_size_x(*dtype, &element_size);
+    for (i = 0; i < *len; i++) {
+        view_transport_gmp(a, (char *) invec + (size_t) i * element_size);
+        view_transport_gmp(b, (char *) inoutvec + (size_t) i * element_size);
+        mpf_mul(b, b, a);
+        transport_buffer_gmp(b);
+    }
+}
+
+/*
+ * Adds the fixed point numbers local of every process and stores the result in sum (process 0).
+ * local is a signed integer that must fit in num_digits digits of SEGMENT_DIGIT_BITS bits
+ * in two's complement. Every digit is sent in a 64 bits word, so the digits of all the
+ * processes can be added with MPI_SUM without carries.
+ * The digits are split in num_segments segments that are reduced with MPI_Ireduce in a
+ * pipeline: while a segment travels the next one is prepared and, in process 0, the carries
+ * of a received segment are propagated while the next ones are still arriving.
+ */
+void segmented_reduce_add_z_gmp(MPI_Comm comm, mpz_t sum, mpz_t local, long num_digits, int num_segments, int proc_id){
+    int s;
+    long segment_size, segment_start, segment_end, i;
+    uint32_t *digits;
+    uint64_t *sendbuffer, *recbuffer = NULL, carry, value;
+    mpz_t aux;
+    MPI_Request *requests;
+
+    //The count of every MPI_Ireduce is an int
+    if ((num_digits + num_segments - 1) / num_segments > INT_MAX) num_segments = (num_digits + INT_MAX - 1) / INT_MAX;
+    segment_size = (num_digits + num_segments - 1) / num_segments;
+    digits = calloc(num_digits, sizeof(uint32_t));
+    sendbuffer = allocate_large_buffer(num_digits * sizeof(uint64_t));
+    requests = malloc(num_segments * sizeof(MPI_Request));
+    if (proc_id == 0) recbuffer = allocate_large_buffer(num_digits * sizeof(uint64_t));
+
+    //Write local in two's complement with the least significant digit first
+    mpz_init(aux);
+    if (mpz_sgn(local) < 0) {
+        mpz_setbit(aux, (mp_bitcnt_t) num_digits * SEGMENT_DIGIT_BITS);
+    }
+    mpz_add(aux, aux, local);
+    mpz_export(digits, NULL, -1, sizeof(uint32_t), 0, 0, aux);
+
+    //Start the reduction of every segment as soon as it is ready
+    for (s = 0; s < num_segments; s++) {
+        segment_start = s * segment_size;
+        segment_end = (segment_start + segment_size < num_digits) ? segment_start + segment_size : num_digits;
+        if (segment_start >= num_digits) {
+            requests[s] = MPI_REQUEST_NULL;
+            continue;
+        }
+        for (i = segment_start; i < segment_end; i++) sendbuffer[i] = digits[i];
+        MPI_Ireduce(sendbuffer + segment_start, (proc_id == 0) ? recbuffer + segment_start : NULL, (int) (segment_end - segment_start),
+                    MPI_UINT64_T, MPI_SUM, 0, comm, &requests[s]);
+    }
+
+    if (proc_id == 0) {
+        //Propagate the carries of every segment in order as they arrive
+        carry = 0;
+        for (s = 0; s < num_segments; s++) {
+            MPI_Wait(&requests[s], MPI_STATUS_IGNORE);
+            segment_start = s * segment_size;
+            segment_end = (segment_start + segment_size < num_digits) ? segment_start + segment_size : num_digits;
+            for (i = segment_start; i < segment_end; i++) {
+                value = recbuffer[i] + carry;
+                digits[i] = (uint32_t) value;
+                carry = value >> SEGMENT_DIGIT_BITS;
+            }
+        }
+
+        //Read the sum from two's complement (the last carry is out of range)
+        mpz_import(sum, num_digits, -1, sizeof(uint32_t), 0, 0, digits);
+        if (mpz_tstbit(sum, (mp_bitcnt_t) num_digits * SEGMENT_DIGIT_BITS - 1)) {
+            mpz_set_ui(aux, 0);
+            mpz_setbit(aux, (mp_bitcnt_t) num_digits * SEGMENT_DIGIT_BITS);
+            mpz_sub(sum, sum, aux);
+        }
+        free_large_buffer(recbuffer);
+    } else {
+        MPI_Waitall(num_segments, requests, MPI_STATUSES_IGNORE);
+    }
+
+    mpz_clear(aux);
+    free(digits);
+    free_large_buffer(sendbuffer);
+    free(requests);
 }
 
+/*
+ * Segmented version of reduce_add_gmp.
+ * local_proc_pi is converted to a fixed point number with all the bits of its precision
+ * after the point and one digit for the integer part and one digit for the sign.
+ */
+void segmented_reduce_add_gmp(MPI_Comm comm, mpf_t pi, mpf_t local_proc_pi, int proc_id, int num_segments){
+    mp_bitcnt_t fraction_bits;
+    long num_digits;
+    mpf_t aux;
+    mpz_t local, sum;
+
+    fraction_bits = ((mp_bitcnt_t) local_proc_pi -> _mp_prec + 1) * GMP_NUMB_BITS;
+    num_digits = (fraction_bits + SEGMENT_DIGIT_BITS - 1) / SEGMENT_DIGIT_BITS + 2;
+
+    mpf_init2(aux, mpf_get_prec(local_proc_pi));
+    mpz_inits(local, sum, NULL);
+    mpf_mul_2exp(aux, local_proc_pi, fraction_bits);
+    mpz_set_f(local, aux);
+
+    segmented_reduce_add_z_gmp(comm, sum, local, num_digits, num_segments, proc_id);
+
+    if (proc_id == 0){
+        mpf_set_z(pi, sum);
+        mpf_div_2exp(pi, pi, fraction_bits);
+    }
+
+    mpf_clear(aux);
+    mpz_clears(local, sum, NULL);
+}
+
+/*
+ * Adds the local_proc_pi of every process and stores the result in pi (process 0).
+ * local_proc_pi should have been initialized with init_transport_gmp: its buffer
+ * is sent as one contiguous MPI datatype and the reduction works on it in place.
+ * If the -segments option is given the segmented reduction is used instead, and if the
+ * -node_reduce option is given the processes of every node are added in shared memory first.
+ */
+void reduce_add_gmp(MPI_Comm comm, mpf_t pi, mpf_t local_proc_pi, int proc_id){
+    size_t packet_size;
+    void *recbuffer = NULL;
+    mpf_t result;
+    MPI_Datatype transport_type;
+    MPI_Op add_op;
+
+    mark_phase(THREAD_REDUCE_PHASE);
+    if (options.reduce_segments > 0){
+        segmented_reduce_add_gmp(comm, pi, local_proc_pi, proc_id, options.reduce_segments);
+        mark_phase(PROC_REDUCE_PHASE);
+        return;
+    }
+
+    //Create user defined datatype and operation
+    packet_size = transport_size_gmp(local_proc_pi);
+    create_bytes_type(packet_size, &transport_type);
+    MPI_Op_create((MPI_User_function *)add_gmp, 0, &add_op);
+
+    if (proc_id == 0) recbuffer = allocate_large_buffer(packet_size);
+
+    //Reduce local_proc_pi
+    if (options.node_reduce) {
+        node_reduce(comm, transport_buffer_gmp(local_proc_pi), recbuffer, transport_type, add_op, (MPI_User_function *)add_gmp);
+    } else {
+        MPI_Reduce(transport_buffer_gmp(local_proc_pi), recbuffer, 1, transport_type, add_op, 0, comm);
+    }
 
+    //Copy the result in global Pi
+    if (proc_id == 0){
+        view_transport_gmp(result, recbuffer);
+        mpf_set(pi, result);
+        free_large_buffer(recbuffer);
+    }
+
+    MPI_Op_free(&add_op);
+    MPI_Type_free(&transport_type);
+    mark_phase(PROC_REDUCE_PHASE);
+}
+
+/*
+ * Pack three mpz_t types in one page aligned buffer
+ * Format: the signed number of limbs of P, Q and T (three int) followed by the limbs of P, Q and T
+ * It returns the buffer and sets its size in bytes. The buffer should be freed with free_large_buffer
+ */
+void * pack_pqt_gmp(mpz_t P, mpz_t Q, mpz_t T, long *bytes){
+    int *header;
+    char *buffer;
+    size_t size_P, size_Q, size_T;
+
+    size_P = mpz_size(P) * sizeof(mp_limb_t);
+    size_Q = mpz_size(Q) * sizeof(mp_limb_t);
+    size_T = mpz_size(T) * sizeof(mp_limb_t);
+    *bytes = 3 * sizeof(int) + size_P + size_Q + size_T;
+    buffer = allocate_large_buffer(*bytes);
+
+    header = (int *) buffer;
+    header[0] = P -> _mp_size;
+    header[1] = Q -> _mp_size;
+    header[2] = T -> _mp_size;
+    buffer += 3 * sizeof(int);
+    memcpy(buffer, P -> _mp_d, size_P);
+    memcpy(buffer + size_P, Q -> _mp_d, size_Q);
+    memcpy(buffer + size_P + size_Q, T -> _mp_d, size_T);
+
+    return header;
+}
+
+/*
+ * Unpack three mpz_t types packed with pack_pqt_gmp
+ * IMPORTANT: mpz_t P, Q and T should have been previously initialized
+ */
+void unpack_pqt_gmp(void * buffer, mpz_t P, mpz_t Q, mpz_t T){
+    int *header, i;
+    char *limbs;
+    mpz_ptr data[3] = {P, Q, T};
+
+    header = (int *) buffer;
+    limbs = (char *) buffer + 3 * sizeof(int);
+    for (i = 0; i < 3; i++) {
+        mpz_realloc2(data[i], ((mp_bitcnt_t) abs(header[i]) + 1) * GMP_NUMB_BITS);
+        memcpy(data[i] -> _mp_d, limbs, (size_t) abs(header[i]) * sizeof(mp_limb_t));
+        data[i] -> _mp_size = header[i];
+        limbs += (size_t) abs(header[i]) * sizeof(mp_limb_t);
+    }
+}
 
@@ -3,8 +3,16 @@
 
 void add_gmp(void *, void *, int *, MPI_Datatype *);
 void mul_gmp(void *, void *, int *, MPI_Datatype *);
-int pack_gmp(void *, mpf_t);
-void unpack_gmp(void *, mpf_t);
+void init_transport_gmp(mpf_t);
+void clear_transport_gmp(mpf_t);
+size_t transport_size_gmp(mpf_t);
+void * transport_buffer_gmp(mpf_t);
+void view_transport_gmp(mpf_t, void *);
+void segmented_reduce_add_z_gmp(MPI_Comm, mpz_t, mpz_t, long, int, int);
+void segmented_reduce_add_gmp(MPI_Comm, mpf_t, mpf_t, int, int);
+void reduce_add_gmp(MPI_Comm, mpf_t, mpf_t, int);
+void * pack_pqt_gmp(mpz_t, mpz_t, mpz_t, long *);
+void unpack_pqt_gmp(void *, mpz_t, mpz_t, mpz_t);
 
 #endif
 
@@ -0,0 +1,43 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <gmp.h>
+#include <omp.h>
+#include "../common/phase_timer.h"
+
+
+/*
+ * Adds the thread_value of every thread of the current parallel region to result.
+ * The values are added in pairs through a binary tree, so there are only log2(num_threads)
+ * steps of additions instead of num_threads additions one after another.
+ * IMPORTANT: it should be called by all the threads of the parallel region.
+ * The thread_value of the threads is overwritten with partial sums.
+ * The time before the call is marked as the sum phase of the thread.
+ */
+void reduce_threads_gmp(mpf_t result, mpf_t thread_value){
+    static mpf_ptr *values;
+    int thread_id, num_threads, step;
+
+    thread_id = omp_get_thread_num();
+    num_threads = omp_get_num_threads();
+    mark_phase(SUM_PHASE);
+
+    #pragma omp single
+    values = malloc(num_threads * sizeof(mpf_ptr));
+
+    values[thread_id] = thread_value;
+    #pragma omp barrier
+
+    for (step = 1; step < num_threads; step *= 2) {
+        if (thread_id % (2 * step) == 0 && thread_id + step < num_threads) {
+            mpf_add(values[thread_id], values[thread_id], values[thread_id + step]);
+        }
+        #pragma omp barrier
+    }
+
+    #pragma omp single
+    {
+        mpf_add(result, result, values[0]);
+        free(values);
+    }
+    mark_phase(THREAD_REDUCE_PHASE);
+}
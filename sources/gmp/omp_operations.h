@@ -0,0 +1,6 @@
+#ifndef OMP_OPERATIONS_GMP
+#define OMP_OPERATIONS_GMP
+
+void reduce_threads_gmp(mpf_t, mpf_t);
+
+#endif
@@ -0,0 +1,410 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <gmp.h>
+#include "../common/options.h"
+#include "../common/large_buffer.h"
+#include "parallel_arithmetic.h"
+#include "out_of_core.h"
+
+
+/************************************************************************************
+ * Out of core storage of the binary splitting triples                              *
+ *                                                                                  *
+ ************************************************************************************
+ * With the -spill=DIR option the merges of the triples whose numbers are larger    *
+ * than one chunk (-spill_chunk=K KiB) are done with the numbers in files of DIR,   *
+ * which should be in a local disk of the node. Every number is stored as its       *
+ * limbs, the least significant first, and its sign and size are kept in memory.    *
+ * The files are removed as soon as they are opened, so they disappear when they    *
+ * are closed or when the process ends.                                             *
+ *                                                                                  *
+ * The products of the merge are computed in chunks: the chunk i of a times the     *
+ * chunk j of b is computed in memory and added to the limbs (i + j) chunk of the   *
+ * file of the result. Only two chunks of every factor and two partial products     *
+ * are in memory, so the whole factors are never loaded.                            *
+ *                                                                                  *
+ * The disk is used while the processor works: the chunks of the next partial       *
+ * product are read by one thread and the previous partial product is added to      *
+ * the file by another thread while the current one is computed.                    *
+ *                                                                                  *
+ * The sum T Q_right + P T_right of a merge is also added in the files, one chunk   *
+ * of every term at a time, so only Q and T are read back in memory, and P is not   *
+ * computed in the last merge, as the final division only needs Q and T.            *
+ *                                                                                  *
+ ************************************************************************************/
+
+
+struct limb_transfer {
+    pthread_t thread;
+    int fd;
+    mp_limb_t *limbs;
+    long offset;
+    long count;
+};
+
+struct accumulation {
+    pthread_t thread;
+    int fd;
+    long result_size;
+    long offset;
+    mpz_ptr product;
+    mp_limb_t *buffer;
+};
+
+static long spill_files = 0;
+
+
+/*
+ * Number of limbs of a chunk of the out of core products
+ */
+size_t spill_chunk_limbs(){
+    return ((size_t) options.spill_chunk << 10) / sizeof(mp_limb_t);
+}
+
+/*
+ * Opens a new file for a spilled number in the spill directory and removes its name
+ */
+static int open_spill_file(){
+    int fd;
+    char path[4096];
+
+    snprintf(path, sizeof(path), "%s/spill_%d_%ld.limbs", options.spill_dir, (int) getpid(),
+                __sync_fetch_and_add(&spill_files, 1));
+    fd = open(path, O_RDWR | O_CREAT | O_TRUNC, 0600);
+    if (fd < 0) {
+        printf("  The spill file %s can not be created \n", path);
+        exit(-1);
+    }
+    unlink(path);
+    return fd;
+}
+
+static void write_limbs(int fd, mp_limb_t *limbs, long offset, long count){
+    size_t done, bytes;
+    ssize_t written;
+
+    bytes = count * sizeof(mp_limb_t);
+    for (done = 0; done < bytes; done += written) {
+        written = pwrite(fd, (char *) limbs + done, bytes - done, offset * sizeof(mp_limb_t) + done);
+        if (written <= 0) {
+            printf("  The limbs of a spilled number can not be written \n");
+            exit(-1);
+        }
+    }
+}
+
+static void read_limbs(int fd, mp_limb_t *limbs, long offset, long count){
+    size_t done, bytes;
+    ssize_t bytes_read;
+
+    bytes = count * sizeof(mp_limb_t);
+    for (done = 0; done < bytes; done += bytes_read) {
+        bytes_read = pread(fd, (char *) limbs + done, bytes - done, offset * sizeof(mp_limb_t) + done);
+        if (bytes_read <= 0) {
+            printf("  The limbs of a spilled number can not be read \n");
+            exit(-1);
+        }
+    }
+}
+
+static void * limb_transfer_thread(void *arg){
+    struct limb_transfer *transfer = (struct limb_transfer *) arg;
+    read_limbs(transfer -> fd, transfer -> limbs, transfer -> offset, transfer -> count);
+    return NULL;
+}
+
+/*
+ * Starts reading count limbs of fd from offset in the background
+ */
+static void start_read(struct limb_transfer *transfer, int fd, mp_limb_t *limbs, long offset, long count){
+    transfer -> fd = fd;
+    transfer -> limbs = limbs;
+    transfer -> offset = offset;
+    transfer -> count = count;
+    pthread_create(&transfer -> thread, NULL, limb_transfer_thread, transfer);
+}
+
+/*
+ * Adds the partial product to the limbs of the result file from offset
+ * and propagates the carry
+ */
+static void * accumulation_thread(void *arg){
+    struct accumulation *accumulation = (struct accumulation *) arg;
+    long size, position;
+    mp_limb_t carry, limb;
+
+    size = mpz_size(accumulation -> product);
+    if (size > accumulation -> result_size - accumulation -> offset) size = accumulation -> result_size - accumulation -> offset;
+    read_limbs(accumulation -> fd, accumulation -> buffer, accumulation -> offset, size);
+    carry = mpn_add_n(accumulation -> buffer, accumulation -> buffer, accumulation -> product -> _mp_d, size);
+    write_limbs(accumulation -> fd, accumulation -> buffer, accumulation -> offset, size);
+
+    for (position = accumulation -> offset + size; carry != 0 && position < accumulation -> result_size; position++) {
+        read_limbs(accumulation -> fd, &limb, position, 1);
+        limb++;
+        carry = (limb == 0);
+        write_limbs(accumulation -> fd, &limb, position, 1);
+    }
+    return NULL;
+}
+
+/*
+ * Writes x in a spill file and frees its limbs
+ */
+void spill_mpz_gmp(struct spilled_mpz_gmp *spilled, mpz_t x){
+    spilled -> fd = open_spill_file();
+    spilled -> sign = mpz_sgn(x);
+    spilled -> size = mpz_size(x);
+    write_limbs(spilled -> fd, x -> _mp_d, 0, spilled -> size);
+    mpz_clear(x);
+    mpz_init(x);
+}
+
+/*
+ * Reads the spilled number in x and closes its file
+ * IMPORTANT: x should have been previously initialized
+ */
+void restore_mpz_gmp(mpz_t x, struct spilled_mpz_gmp *spilled){
+    long size;
+
+    size = spilled -> size;
+    mpz_realloc2(x, ((mp_bitcnt_t) size + 1) * GMP_NUMB_BITS);
+    read_limbs(spilled -> fd, x -> _mp_d, 0, size);
+    while (size > 0 && x -> _mp_d[size - 1] == 0) size--;
+    x -> _mp_size = (spilled -> sign < 0) ? -size : size;
+    close(spilled -> fd);
+}
+
+/*
+ * Read only view of the first length limbs of a chunk
+ */
+static void view_chunk(mpz_t view, mp_limb_t *limbs, long length){
+    while (length > 0 && limbs[length - 1] == 0) length--;
+    mpz_roinit_n(view, limbs, length);
+}
+
+/*
+ * result = a * b with the factors and the result in spill files, computing the
+ * products of every pair of chunks with num_threads threads.
+ * The files of a and b are kept open.
+ */
+void spilled_mul_gmp(struct spilled_mpz_gmp *result, struct spilled_mpz_gmp *a, struct spilled_mpz_gmp *b, int num_threads){
+    long chunk, chunks_a, chunks_b, step, num_steps, i, j, next_i, next_j;
+    mp_limb_t *chunk_a[2], *chunk_b[2], *buffer;
+    mpz_t products[2], view_a, view_b;
+    struct limb_transfer read_a, read_b;
+    struct accumulation accumulation;
+    int reading_a, reading_b, accumulating;
+
+    result -> fd = open_spill_file();
+    result -> sign = a -> sign * b -> sign;
+    result -> size = (result -> sign == 0) ? 0 : a -> size + b -> size;
+    if (result -> size == 0) return;
+    if (ftruncate(result -> fd, result -> size * sizeof(mp_limb_t)) != 0) {
+        printf("  The spill file of a product can not be allocated \n");
+        exit(-1);
+    }
+
+    chunk = spill_chunk_limbs();
+    chunks_a = (a -> size + chunk - 1) / chunk;
+    chunks_b = (b -> size + chunk - 1) / chunk;
+    num_steps = chunks_a * chunks_b;
+    for (i = 0; i < 2; i++) {
+        chunk_a[i] = allocate_large_buffer(chunk * sizeof(mp_limb_t));
+        chunk_b[i] = allocate_large_buffer(chunk * sizeof(mp_limb_t));
+        mpz_init(products[i]);
+    }
+    buffer = allocate_large_buffer(2 * chunk * sizeof(mp_limb_t));
+    accumulation.fd = result -> fd;
+    accumulation.result_size = result -> size;
+    accumulation.buffer = buffer;
+
+    //The first chunks are read before starting
+    read_limbs(a -> fd, chunk_a[0], 0, (a -> size < chunk) ? a -> size : chunk);
+    read_limbs(b -> fd, chunk_b[0], 0, (b -> size < chunk) ? b -> size : chunk);
+    accumulating = 0;
+
+    for (step = 0; step < num_steps; step++) {
+        i = step / chunks_b;
+        j = step % chunks_b;
+
+        //Read the chunks of the next step while this one is computed
+        reading_a = reading_b = 0;
+        if (step + 1 < num_steps) {
+            next_i = (step + 1) / chunks_b;
+            next_j = (step + 1) % chunks_b;
+            if (next_i != i) {
+                start_read(&read_a, a -> fd, chunk_a[next_i % 2], next_i * chunk,
+                            (a -> size - next_i * chunk < chunk) ? a -> size - next_i * chunk : chunk);
+                reading_a = 1;
+            }
+            if (chunks_b > 1) {
+                start_read(&read_b, b -> fd, chunk_b[(step + 1) % 2], next_j * chunk,
+                            (b -> size - next_j * chunk < chunk) ? b -> size - next_j * chunk : chunk);
+                reading_b = 1;
+            }
+        }
+
+        view_chunk(view_a, chunk_a[i % 2], (a -> size - i * chunk < chunk) ? a -> size - i * chunk : chunk);
+        view_chunk(view_b, chunk_b[(chunks_b > 1) ? step % 2 : 0], (b -> size - j * chunk < chunk) ? b -> size - j * chunk : chunk);
+        parallel_mpz_mul_gmp(products[step % 2], view_a, view_b, num_threads);
+
+        //Add the partial product to the file while the next one is computed
+        if (accumulating) pthread_join(accumulation.thread, NULL);
+        accumulating = (mpz_sgn(products[step % 2]) != 0);
+        if (accumulating) {
+            accumulation.offset = (i + j) * chunk;
+            accumulation.product = products[step % 2];
+            pthread_create(&accumulation.thread, NULL, accumulation_thread, &accumulation);
+        }
+
+        if (reading_a) pthread_join(read_a.thread, NULL);
+        if (reading_b) pthread_join(read_b.thread, NULL);
+    }
+    if (accumulating) pthread_join(accumulation.thread, NULL);
+
+    for (i = 0; i < 2; i++) {
+        free_large_buffer(chunk_a[i]);
+        free_large_buffer(chunk_b[i]);
+        mpz_clear(products[i]);
+    }
+    free_large_buffer(buffer);
+}
+
+/*
+ * Reads count limbs of the spilled number from offset, with zeros above its size
+ */
+static void read_padded_limbs(struct spilled_mpz_gmp *spilled, mp_limb_t *limbs, long offset, long count){
+    long stored;
+
+    stored = spilled -> size - offset;
+    if (stored > count) stored = count;
+    if (stored < 0) stored = 0;
+    if (stored > 0) read_limbs(spilled -> fd, limbs, offset, stored);
+    memset(limbs + stored, 0, (count - stored) * sizeof(mp_limb_t));
+}
+
+/*
+ * Compares the absolute values of two spilled numbers, reading their chunks from the
+ * most significant one until they differ
+ */
+static int compare_spilled_gmp(struct spilled_mpz_gmp *a, struct spilled_mpz_gmp *b, mp_limb_t *chunk_a, mp_limb_t *chunk_b){
+    long chunk, size, offset, count;
+    int comparison = 0;
+
+    chunk = spill_chunk_limbs();
+    size = (a -> size > b -> size) ? a -> size : b -> size;
+    for (offset = ((size - 1) / chunk) * chunk; offset >= 0 && comparison == 0; offset -= chunk) {
+        count = (size - offset < chunk) ? size - offset : chunk;
+        read_padded_limbs(a, chunk_a, offset, count);
+        read_padded_limbs(b, chunk_b, offset, count);
+        comparison = mpn_cmp(chunk_a, chunk_b, count);
+    }
+    return comparison;
+}
+
+/*
+ * a = a + b with both numbers in spill files, adding one chunk of every number at a
+ * time and propagating the carry (or the borrow) to the next chunk.
+ * The result is written in the file of a and the file of b is closed.
+ */
+void spilled_add_gmp(struct spilled_mpz_gmp *a, struct spilled_mpz_gmp *b){
+    long chunk, size, offset, count, top;
+    int sign;
+    bool subtract;
+    mp_limb_t *chunk_a, *chunk_b, carry;
+    struct spilled_mpz_gmp *larger, *smaller;
+
+    if (b -> sign == 0) {
+        close(b -> fd);
+        return;
+    }
+    if (a -> sign == 0) {
+        close(a -> fd);
+        *a = *b;
+        return;
+    }
+
+    chunk = spill_chunk_limbs();
+    chunk_a = allocate_large_buffer(chunk * sizeof(mp_limb_t));
+    chunk_b = allocate_large_buffer(chunk * sizeof(mp_limb_t));
+
+    //With different signs the smaller absolute value is subtracted from the larger one
+    subtract = (a -> sign != b -> sign);
+    larger = a;
+    smaller = b;
+    sign = a -> sign;
+    if (subtract) {
+        sign = compare_spilled_gmp(a, b, chunk_a, chunk_b);
+        if (sign < 0) {
+            larger = b;
+            smaller = a;
+        }
+        sign *= a -> sign;
+    }
+
+    size = ((a -> size > b -> size) ? a -> size : b -> size) + !subtract;
+    carry = 0;
+    top = 0;
+    for (offset = 0; sign != 0 && offset < size; offset += chunk) {
+        count = (size - offset < chunk) ? size - offset : chunk;
+        read_padded_limbs(larger, chunk_a, offset, count);
+        read_padded_limbs(smaller, chunk_b, offset, count);
+        if (subtract) {
+            carry = mpn_sub_n(chunk_a, chunk_a, chunk_b, count) + mpn_sub_1(chunk_a, chunk_a, count, carry);
+        } else {
+            carry = mpn_add_n(chunk_a, chunk_a, chunk_b, count) + mpn_add_1(chunk_a, chunk_a, count, carry);
+        }
+        write_limbs(a -> fd, chunk_a, offset, count);
+        while (count > 0 && chunk_a[count - 1] == 0) count--;
+        if (count > 0) top = offset + count;
+    }
+    a -> sign = sign;
+    a -> size = top;
+
+    close(b -> fd);
+    free_large_buffer(chunk_a);
+    free_large_buffer(chunk_b);
+}
+
+/*
+ * Same as parallel_merge_pqt_gmp with the six numbers spilled to disk during the
+ * products and the sum, so the memory needed by them is only a few chunks.
+ * Only P, Q and T are read again at the end, and P is not computed if compute_P
+ * is false. Q_right and T_right are cleared, and P_right too if P is computed.
+ */
+void spilled_merge_pqt_gmp(mpz_t P, mpz_t Q, mpz_t T, mpz_t P_right, mpz_t Q_right, mpz_t T_right, int num_threads, bool compute_P){
+    struct spilled_mpz_gmp p, q, t, p_right, q_right, t_right, t_q_right, q_q_right, p_t_right, p_p_right;
+
+    spill_mpz_gmp(&p, P);
+    spill_mpz_gmp(&q, Q);
+    spill_mpz_gmp(&t, T);
+    if (compute_P) spill_mpz_gmp(&p_right, P_right);
+    spill_mpz_gmp(&q_right, Q_right);
+    spill_mpz_gmp(&t_right, T_right);
+
+    // T = T Q_right + P T_right,   P = P P_right,   Q = Q Q_right
+    spilled_mul_gmp(&t_q_right, &t, &q_right, num_threads);
+    spilled_mul_gmp(&q_q_right, &q, &q_right, num_threads);
+    close(t.fd);
+    close(q.fd);
+    close(q_right.fd);
+    spilled_mul_gmp(&p_t_right, &p, &t_right, num_threads);
+    close(t_right.fd);
+    if (compute_P) {
+        spilled_mul_gmp(&p_p_right, &p, &p_right, num_threads);
+        close(p_right.fd);
+    }
+    close(p.fd);
+    spilled_add_gmp(&t_q_right, &p_t_right);
+
+    if (compute_P) restore_mpz_gmp(P, &p_p_right);
+    restore_mpz_gmp(Q, &q_q_right);
+    restore_mpz_gmp(T, &t_q_right);
+}
+
@@ -0,0 +1,18 @@
+#ifndef OUT_OF_CORE_GMP
+#define OUT_OF_CORE_GMP
+
+struct spilled_mpz_gmp {
+    int fd;
+    int sign;
+    long size;
+};
+
+size_t spill_chunk_limbs();
+void spill_mpz_gmp(struct spilled_mpz_gmp *, mpz_t);
+void restore_mpz_gmp(mpz_t, struct spilled_mpz_gmp *);
+void spilled_mul_gmp(struct spilled_mpz_gmp *, struct spilled_mpz_gmp *, struct spilled_mpz_gmp *, int);
+void spilled_add_gmp(struct spilled_mpz_gmp *, struct spilled_mpz_gmp *);
+void spilled_merge_pqt_gmp(mpz_t, mpz_t, mpz_t, mpz_t, mpz_t, mpz_t, int, bool);
+
+#endif
+
@@ -0,0 +1,238 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <gmp.h>
+#include <omp.h>
+#include "parallel_arithmetic.h"
+
+#define PARALLEL_MUL_THRESHOLD 4096     // Minimum size (in limbs) of each factor to split the product
+
+
+/*
+ * Read only view of the limbs [start, start + length) of the absolute value of data
+ */
+static void view_limbs(mpz_t view, mpz_t data, int start, int length){
+    int size = abs(data -> _mp_size);
+    if (start >= size) length = 0;
+    else if (start + length > size) length = size - start;
+    while (length > 0 && data -> _mp_d[start + length - 1] == 0) length--;
+    mpz_roinit_n(view, data -> _mp_d + start, length);
+}
+
+
+/*
+ * Multiplies a and b using num_threads threads.
+ * a is split into pieces_a and b into pieces_b = sqrt(num_threads) pieces, with
+ * pieces_a * pieces_b <= num_threads, and the partial products are computed in parallel.
+ * Each thread then accumulates one row of shifted partial products and the rows
+ * are added at the end. Small products are computed with a single mpz_mul.
+ */
+void parallel_mpz_mul_gmp(mpz_t result, mpz_t a, mpz_t b, int num_threads){
+    int pieces_a, pieces_b, size_a, size_b, piece_a, piece_b, i, sign;
+    mpz_t *products, *rows;
+
+    size_a = abs(a -> _mp_size);
+    size_b = abs(b -> _mp_size);
+    pieces_b = (int) sqrt((double) num_threads);
+    pieces_a = (pieces_b > 0) ? num_threads / pieces_b : 0;
+    if (pieces_a < 2 || size_a < PARALLEL_MUL_THRESHOLD || size_b < PARALLEL_MUL_THRESHOLD) {
+        mpz_mul(result, a, b);
+        return;
+    }
+
+    sign = mpz_sgn(a) * mpz_sgn(b);
+    piece_a = (size_a + pieces_a - 1) / pieces_a;
+    piece_b = (size_b + pieces_b - 1) / pieces_b;
+    products = malloc(sizeof(mpz_t) * pieces_a * pieces_b);
+    rows = malloc(sizeof(mpz_t) * pieces_a);
+
+    #pragma omp parallel for schedule(dynamic) num_threads(num_threads)
+    for (i = 0; i < pieces_a * pieces_b; i++) {
+        mpz_t view_a, view_b;
+        view_limbs(view_a, a, (i / pieces_b) * piece_a, piece_a);
+        view_limbs(view_b, b, (i % pieces_b) * piece_b, piece_b);
+        mpz_init(products[i]);
+        mpz_mul(products[i], view_a, view_b);
+    }
+
+    #pragma omp parallel for num_threads(pieces_a)
+    for (i = 0; i < pieces_a; i++) {
+        int j;
+        mpz_init(rows[i]);
+        for (j = pieces_b - 1; j >= 0; j--) {
+            mpz_mul_2exp(rows[i], rows[i], (mp_bitcnt_t) piece_b * GMP_NUMB_BITS);
+            mpz_add(rows[i], rows[i], products[i * pieces_b + j]);
+            mpz_clear(products[i * pieces_b + j]);
+        }
+    }
+
+    mpz_set_ui(result, 0);
+    for (i = pieces_a - 1; i >= 0; i--) {
+        mpz_mul_2exp(result, result, (mp_bitcnt_t) piece_a * GMP_NUMB_BITS);
+        mpz_add(result, result, rows[i]);
+        mpz_clear(rows[i]);
+    }
+    if (sign < 0) mpz_neg(result, result);
+
+    free(products);
+    free(rows);
+}
+
+/*
+ * result = u * v using num_threads threads.
+ * Only the limbs of the factors needed by the precision of result are multiplied, as in mpf_mul.
+ */
+void parallel_mul_gmp(mpf_t result, mpf_t u, mpf_t v, int num_threads){
+    int size_u, size_v, used_u, used_v;
+    mp_exp_t exponent;
+    mpz_t view_u, view_v, product;
+
+    size_u = abs(u -> _mp_size);
+    size_v = abs(v -> _mp_size);
+    used_u = (size_u > result -> _mp_prec + 1) ? result -> _mp_prec + 1 : size_u;
+    used_v = (size_v > result -> _mp_prec + 1) ? result -> _mp_prec + 1 : size_v;
+    if (num_threads < 2 || used_u < PARALLEL_MUL_THRESHOLD || used_v < PARALLEL_MUL_THRESHOLD) {
+        mpf_mul(result, u, v);
+        return;
+    }
+
+    //u v = (mantissa_u B^(exp_u - used_u)) (mantissa_v B^(exp_v - used_v))
+    mpz_roinit_n(view_u, u -> _mp_d + size_u - used_u, used_u);
+    mpz_roinit_n(view_v, v -> _mp_d + size_v - used_v, used_v);
+    exponent = (u -> _mp_exp - used_u) + (v -> _mp_exp - used_v);
+    mpz_init(product);
+    parallel_mpz_mul_gmp(product, view_u, view_v, num_threads);
+    if ((u -> _mp_size < 0) != (v -> _mp_size < 0)) mpz_neg(product, product);
+
+    mpf_set_z(result, product);
+    result -> _mp_exp += exponent;
+    mpz_clear(product);
+}
+
+/*
+ * result = sqrt(x) using num_threads threads in the products.
+ * The inverse square root y = 1/sqrt(x) is refined with the Newton iteration
+ *
+ *      y = y + y (1 - x y^2) / 2
+ *
+ * doubling its precision in every step, and then sqrt(x) = x y.
+ */
+void parallel_sqrt_gmp(mpf_t result, mpf_t x, int num_threads){
+    int num_steps, step;
+    mp_bitcnt_t precision, step_precision[64];
+    mpf_t y, aux, error;
+
+    precision = mpf_get_prec(result);
+    if (num_threads < 2 || mpf_sgn(x) <= 0 || precision < 2 * PARALLEL_MUL_THRESHOLD * GMP_NUMB_BITS) {
+        mpf_sqrt(result, x);
+        return;
+    }
+
+    //Precisions of the steps, from the last one to the first one
+    num_steps = 0;
+    while (precision > 2 * GMP_NUMB_BITS) {
+        step_precision[num_steps++] = precision;
+        precision = precision / 2 + GMP_NUMB_BITS;
+    }
+
+    mpf_init2(y, precision);
+    mpf_init2(aux, precision);
+    mpf_init2(error, precision);
+    mpf_set(aux, x);
+    mpf_sqrt(y, aux);
+    mpf_ui_div(y, 1, y);
+
+    for (step = num_steps - 1; step >= 0; step--) {
+        mpf_set_prec(y, step_precision[step]);
+        mpf_set_prec(aux, step_precision[step]);
+        mpf_set_prec(error, step_precision[step]);
+        parallel_mul_gmp(aux, y, y, num_threads);
+        parallel_mul_gmp(aux, aux, x, num_threads);
+        mpf_ui_sub(error, 1, aux);
+        parallel_mul_gmp(aux, y, error, num_threads);
+        mpf_div_2exp(aux, aux, 1);
+        mpf_add(y, y, aux);
+    }
+    parallel_mul_gmp(result, x, y, num_threads);
+
+    mpf_clears(y, aux, error, NULL);
+}
+
+/*
+ * result = u / v using num_threads threads in the products.
+ * The inverse y = 1/v is refined with the Newton iteration
+ *
+ *      y = y + y (1 - v y)
+ *
+ * doubling its precision in every step, and then u / v = u y.
+ * result may be the same variable as u or v.
+ */
+void parallel_div_gmp(mpf_t result, mpf_t u, mpf_t v, int num_threads){
+    int num_steps, step;
+    mp_bitcnt_t precision, step_precision[64];
+    mpf_t y, aux, error;
+
+    precision = mpf_get_prec(result);
+    if (num_threads < 2 || mpf_sgn(v) == 0 || precision < 2 * PARALLEL_MUL_THRESHOLD * GMP_NUMB_BITS) {
+        mpf_div(result, u, v);
+        return;
+    }
+
+    //Precisions of the steps, from the last one to the first one
+    num_steps = 0;
+    while (precision > 2 * GMP_NUMB_BITS) {
+        step_precision[num_steps++] = precision;
+        precision = precision / 2 + GMP_NUMB_BITS;
+    }
+
+    mpf_init2(y, precision);
+    mpf_init2(aux, precision);
+    mpf_init2(error, precision);
+    mpf_set(aux, v);
+    mpf_ui_div(y, 1, aux);
+
+    for (step = num_steps - 1; step >= 0; step--) {
+        mpf_set_prec(y, step_precision[step]);
+        mpf_set_prec(aux, step_precision[step]);
+        mpf_set_prec(error, step_precision[step]);
+        parallel_mul_gmp(aux, v, y, num_threads);
+        mpf_ui_sub(error, 1, aux);
+        parallel_mul_gmp(aux, y, error, num_threads);
+        mpf_add(y, y, aux);
+    }
+    parallel_mul_gmp(result, u, y, num_threads);
+
+    mpf_clears(y, aux, error, NULL);
+}
+
+static void * sqrt_constant_thread_gmp(void *argument){
+    struct sqrt_constant_gmp *constant = argument;
+
+    mpf_sqrt_ui(constant -> value, constant -> radicand);
+    mpf_mul_ui(constant -> value, constant -> value, constant -> factor);
+    return NULL;
+}
+
+/*
+ * Starts computing factor sqrt(radicand) with precision bits in a new thread,
+ * so it is ready when the series has been summed
+ */
+void start_sqrt_constant_gmp(struct sqrt_constant_gmp *constant, unsigned long factor, unsigned long radicand, mp_bitcnt_t precision){
+    constant -> factor = factor;
+    constant -> radicand = radicand;
+    mpf_init2(constant -> value, precision);
+    if (pthread_create(&constant -> thread, NULL, sqrt_constant_thread_gmp, constant) != 0) {
+        sqrt_constant_thread_gmp(constant);
+        constant -> thread = pthread_self();
+    }
+}
+
+/*
+ * Waits for the constant started with start_sqrt_constant_gmp and sets result to it
+ */
+void wait_sqrt_constant_gmp(mpf_t result, struct sqrt_constant_gmp *constant){
+    if (!pthread_equal(constant -> thread, pthread_self())) pthread_join(constant -> thread, NULL);
+    mpf_set(result, constant -> value);
+    mpf_clear(constant -> value);
+}
+
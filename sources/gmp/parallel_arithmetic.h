@@ -0,0 +1,21 @@
+#ifndef PARALLEL_ARITHMETIC_GMP
+#define PARALLEL_ARITHMETIC_GMP
+
+#include <pthread.h>
+
+struct sqrt_constant_gmp {
+    pthread_t thread;
+    mpf_t value;
+    unsigned long factor;
+    unsigned long radicand;
+};
+
+void parallel_mpz_mul_gmp(mpz_t, mpz_t, mpz_t, int);
+void parallel_mul_gmp(mpf_t, mpf_t, mpf_t, int);
+void parallel_sqrt_gmp(mpf_t, mpf_t, int);
+void parallel_div_gmp(mpf_t, mpf_t, mpf_t, int);
+void start_sqrt_constant_gmp(struct sqrt_constant_gmp *, unsigned long, unsigned long, mp_bitcnt_t);
+void wait_sqrt_constant_gmp(mpf_t, struct sqrt_constant_gmp *);
+
+#endif
+
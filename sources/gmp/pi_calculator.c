@@ -1,102 +1,290 @@
-#include <stdio.h>
-#include <stdlib.h>
-#include <gmp.h>
-#include <time.h>
-#include <stdbool.h>
-#include "mpi.h"
-#include "algorithms/bbp_blocks_and_cyclic.h"
-#include "algorithms/bellard_blocks_and_cyclic.h"
-#include "algorithms/chudnovsky_blocks_and_blocks.h"
-#include "algorithms/chudnovsky_snake_like_and_blocks.h"
-#include "algorithms/chudnovsky_non_uniform_and_blocks.h"
-#include "check_decimals.h"
-#include "../common/printer.h"
-
-
-double gettimeofday();
-
-
-void calculate_pi_gmp(int num_procs, int proc_id, int algorithm, int precision, int num_threads, bool print_in_csv_format){
-    double execution_time;
-    struct timeval t1, t2;
-    int num_iterations, decimals_computed; 
-    mpf_t pi;
-    char *algorithm_tag;
-
-
-    //Get init time 
-    if(proc_id == 0){
-        gettimeofday(&t1, NULL);
-    }
-
-    //Set gmp float precision (in bits) and init pi
-    mpf_set_default_prec(precision * 8); 
-    if (proc_id == 0){
-        mpf_init_set_ui(pi, 0);
-    }
-    
-    
-    switch (algorithm)
-    {
-    case 0:
-        num_iterations = precision * 0.84;
-        check_errors(num_procs, precision, num_iterations, num_threads, proc_id);
-        algorithm_tag = "GMP-BBP-BLC-CYC";
-        bbp_blocks_and_cyclic_algorithm_gmp(num_procs, proc_id, pi, num_iterations, num_threads);
-        break;
-
-    case 1:
-        num_iterations = precision / 3;
-        check_errors(num_procs, precision, num_iterations, num_threads, proc_id);
-        algorithm_tag = "GMP-BEL-BLC-CYC";
-        bellard_blocks_and_cyclic_algorithm_gmp(num_procs, proc_id, pi, num_iterations, num_threads);
-        break;
-
-    case 2:
-        num_iterations = (precision + 14 - 1) / 14;  //Division por exceso
-        check_errors(num_procs, precision, num_iterations, num_threads, proc_id);
-        algorithm_tag = "GMP-CHD-SME-BLC-BLC";
-        chudnovsky_blocks_and_blocks_algorithm_gmp(num_procs, proc_id, pi, num_iterations, num_threads);
-        break;
-    
-    case 3:
-        num_iterations = (precision + 14 - 1) / 14;  //Division por exceso
-        check_errors(num_procs, precision, num_iterations, num_threads, proc_id);
-        algorithm_tag = "GMP-CHD-SME-SNK-BLC";
-        chudnovsky_snake_like_and_blocks_algorithm_gmp(num_procs, proc_id, pi, num_iterations, num_threads);
-        break;
-
-    case 4:
-        num_iterations = (precision + 14 - 1) / 14;  //Division por exceso
-        check_errors(num_procs, precision, num_iterations, num_threads, proc_id);
-        algorithm_tag = "GMP-CHD-SME-CHT-BLC";
-        chudnovsky_non_uniform_and_blocks_algorithm_gmp(num_procs, proc_id, pi, num_iterations, num_threads);
-        break;
-
-    default:
-        if (proc_id == 0){
-            printf("  Algorithm number selected not availabe, try with another number. \n");
-            printf("\n");
-        } 
-        MPI_Finalize();
-        exit(-1);
-        break;
-    }
-
-    //Get time, check decimals, free pi and print the results
-    if (proc_id == 0) {  
-        gettimeofday(&t2, NULL);
-        execution_time = ((t2.tv_sec - t1.tv_sec) * 1000000u +  t2.tv_usec - t1.tv_usec)/1.e6; 
-        decimals_computed = check_decimals_gmp(pi);
-        if (print_in_csv_format) { 
-            print_results_csv("GMP", algorithm_tag, precision, num_iterations, num_procs, num_threads, decimals_computed, execution_time); 
-        } else { 
-            print_results("GMP", algorithm_tag, precision, num_iterations, num_procs, num_threads, decimals_computed, execution_time); 
-        }
-        mpf_clear(pi);
-    }
-
-}
-
-
-
+#include <stdio.h>
+#include <stdlib.h>
+#include <gmp.h>
+#include <time.h>
+#include <stdbool.h>
+#include "mpi.h"
+#include "algorithms/bbp_blocks_and_cyclic.h"
+#include "algorithms/bellard_blocks_and_cyclic.h"
+#include "algorithms/chudnovsky_blocks_and_blocks.h"
+#include "algorithms/chudnovsky_binary_splitting.h"
+#include "algorithms/bbp_fixed_point.h"
+#include "algorithms/bellard_fixed_point.h"
+#include "algorithms/bbp_hex_window.h"
+#include "algorithms/gauss_legendre.h"
+#include "algorithms/machin.h"
+#include "check_decimals.h"
+#include "radix_conversion.h"
+#include "../common/printer.h"
+#include "../common/planner.h"
+#include "../common/options.h"
+#include "../common/phase_timer.h"
+#include "../common/progress.h"
+#include "../common/checkpoint.h"
+#include "../common/sweep.h"
+#include "../common/chudnovsky_schedules.h"
+#include "../common/dynamic_schedules.h"
+#include "backend.h"
+#include "result_dump.h"
+
+
+double gettimeofday();
+
+
+/*
+ * Sets the gmp float precision (in bits) and inits pi in process 0
+ */
+void init_pi_gmp(mpf_t pi, long precision_bits, int proc_id){
+    mpf_set_default_prec(precision_bits);
+    if (proc_id == 0){
+        mpf_init_set_ui(pi, 0);
+    }
+}
+
+
+void calculate_pi_gmp(MPI_Comm comm, int num_procs, int proc_id, int algorithm, long precision, int num_threads, bool print_in_csv_format, struct run_result *result){
+    double execution_time;
+    struct timeval t1, t2;
+    long num_iterations, decimals_computed = 0; 
+    struct plan plan;
+    mpf_t pi;
+    char *algorithm_tag;
+    bool hex_window = false;
+
+
+    //Get init time 
+    if(proc_id == 0){
+        gettimeofday(&t1, NULL);
+    }
+    init_phase_times(comm, num_threads);
+
+
+    switch (algorithm)
+    {
+    case 0:
+        plan = plan_pi(precision, BBP_SERIES);
+        num_iterations = plan.num_iterations;
+        check_errors(comm, num_procs, precision, num_iterations, num_threads, proc_id);
+        start_progress(comm, num_iterations, num_threads, proc_id);
+        algorithm_tag = "GMP-BBP-BLC-CYC";
+        init_pi_gmp(pi, plan.precision_bits, proc_id);
+        if (!load_cached_pi_gmp(comm, pi, proc_id)) bbp_blocks_and_cyclic_algorithm_gmp(comm, num_procs, proc_id, pi, num_iterations, num_threads);
+        break;
+
+    case 1:
+        plan = plan_pi(precision, BELLARD_SERIES);
+        num_iterations = plan.num_iterations;
+        check_errors(comm, num_procs, precision, num_iterations, num_threads, proc_id);
+        start_progress(comm, num_iterations, num_threads, proc_id);
+        algorithm_tag = "GMP-BEL-BLC-CYC";
+        init_pi_gmp(pi, plan.precision_bits, proc_id);
+        if (!load_cached_pi_gmp(comm, pi, proc_id)) bellard_blocks_and_cyclic_algorithm_gmp(comm, num_procs, proc_id, pi, num_iterations, num_threads);
+        break;
+
+    case 2:
+        plan = plan_pi(precision, CHUDNOVSKY_SERIES);
+        num_iterations = plan.num_iterations;
+        check_errors(comm, num_procs, precision, num_iterations, num_threads, proc_id);
+        start_progress(comm, num_iterations, num_threads, proc_id);
+        algorithm_tag = "GMP-CHD-SME-BLC-BLC";
+        init_pi_gmp(pi, plan.precision_bits, proc_id);
+        if (!load_cached_pi_gmp(comm, pi, proc_id)) chudnovsky_blocks_and_blocks_algorithm_gmp(comm, num_procs, proc_id, pi, num_iterations, num_threads);
+        break;
+    
+    case 3:
+        plan = plan_pi(precision, CHUDNOVSKY_SERIES);
+        num_iterations = plan.num_iterations;
+        check_errors(comm, num_procs, precision, num_iterations, num_threads, proc_id);
+        check_option(comm, options.checkpoint_dir == NULL, "-checkpoint", proc_id);
+        start_progress(comm, num_iterations, num_threads, proc_id);
+        algorithm_tag = "GMP-CHD-SME-SNK-BLC";
+        init_pi_gmp(pi, plan.precision_bits, proc_id);
+        if (!load_cached_pi_gmp(comm, pi, proc_id)) chudnovsky_snake_like_and_blocks_algorithm(&backend_gmp, comm, num_procs, proc_id, pi, num_iterations, num_threads, plan.precision_bits);
+        break;
+
+    case 4:
+        plan = plan_pi(precision, CHUDNOVSKY_SERIES);
+        num_iterations = plan.num_iterations;
+        check_errors(comm, num_procs, precision, num_iterations, num_threads, proc_id);
+        check_option(comm, options.checkpoint_dir == NULL, "-checkpoint", proc_id);
+        start_progress(comm, num_iterations, num_threads, proc_id);
+        algorithm_tag = "GMP-CHD-SME-CHT-BLC";
+        init_pi_gmp(pi, plan.precision_bits, proc_id);
+        if (!load_cached_pi_gmp(comm, pi, proc_id)) chudnovsky_non_uniform_and_blocks_algorithm(&backend_gmp, comm, num_procs, proc_id, pi, num_iterations, num_threads, plan.precision_bits);
+        break;
+
+    case 5:
+        plan = plan_pi(precision, CHUDNOVSKY_SERIES);
+        num_iterations = plan.num_iterations;
+        check_errors(comm, num_procs, precision, num_iterations, num_threads, proc_id);
+        check_option(comm, options.checkpoint_dir == NULL, "-checkpoint", proc_id);
+        start_progress(comm, num_iterations, num_threads, proc_id);
+        algorithm_tag = "GMP-CHD-BSP-BLC-BLC";
+        init_pi_gmp(pi, plan.precision_bits, proc_id);
+        if (!load_cached_pi_gmp(comm, pi, proc_id)) chudnovsky_binary_splitting_algorithm_gmp(comm, num_procs, proc_id, pi, num_iterations, num_threads);
+        break;
+
+    case 6:
+        plan = plan_pi(precision, BBP_SERIES);
+        num_iterations = plan.num_iterations;
+        check_errors(comm, num_procs, precision, num_iterations, num_threads, proc_id);
+        check_option(comm, options.checkpoint_dir == NULL, "-checkpoint", proc_id);
+        start_progress(comm, num_iterations, num_threads, proc_id);
+        algorithm_tag = "GMP-BBP-DYN-STL";
+        init_pi_gmp(pi, plan.precision_bits, proc_id);
+        if (!load_cached_pi_gmp(comm, pi, proc_id)) dynamic_and_stealing_algorithm(&backend_gmp, BBP_SERIES, comm, num_procs, proc_id, pi, num_iterations, num_threads, plan.precision_bits, plan.target_bits);
+        break;
+
+    case 7:
+        plan = plan_pi(precision, BELLARD_SERIES);
+        num_iterations = plan.num_iterations;
+        check_errors(comm, num_procs, precision, num_iterations, num_threads, proc_id);
+        check_option(comm, options.checkpoint_dir == NULL, "-checkpoint", proc_id);
+        start_progress(comm, num_iterations, num_threads, proc_id);
+        algorithm_tag = "GMP-BEL-DYN-STL";
+        init_pi_gmp(pi, plan.precision_bits, proc_id);
+        if (!load_cached_pi_gmp(comm, pi, proc_id)) dynamic_and_stealing_algorithm(&backend_gmp, BELLARD_SERIES, comm, num_procs, proc_id, pi, num_iterations, num_threads, plan.precision_bits, plan.target_bits);
+        break;
+
+    case 8:
+        plan = plan_pi(precision, CHUDNOVSKY_SERIES);
+        num_iterations = plan.num_iterations;
+        check_errors(comm, num_procs, precision, num_iterations, num_threads, proc_id);
+        check_option(comm, options.checkpoint_dir == NULL, "-checkpoint", proc_id);
+        start_progress(comm, num_iterations, num_threads, proc_id);
+        algorithm_tag = "GMP-CHD-SME-DYN-STL";
+        init_pi_gmp(pi, plan.precision_bits, proc_id);
+        if (!load_cached_pi_gmp(comm, pi, proc_id)) dynamic_and_stealing_algorithm(&backend_gmp, CHUDNOVSKY_SERIES, comm, num_procs, proc_id, pi, num_iterations, num_threads, plan.precision_bits, plan.target_bits);
+        break;
+
+    case 9:
+        plan = plan_pi(precision, BBP_SERIES);
+        num_iterations = plan.num_iterations;
+        check_errors(comm, num_procs, precision, num_iterations, num_threads, proc_id);
+        check_option(comm, options.checkpoint_dir == NULL, "-checkpoint", proc_id);
+        check_option(comm, !options.decreasing_precision, "-decreasing_precision", proc_id);
+        start_progress(comm, num_iterations, num_threads, proc_id);
+        algorithm_tag = "GMP-BBP-FXP-CYC-CYC";
+        init_pi_gmp(pi, plan.precision_bits, proc_id);
+        if (!load_cached_pi_gmp(comm, pi, proc_id)) bbp_fixed_point_algorithm_gmp(comm, num_procs, proc_id, pi, num_iterations, num_threads);
+        break;
+
+    case 10:
+        plan = plan_pi(precision, BELLARD_SERIES);
+        num_iterations = plan.num_iterations;
+        check_errors(comm, num_procs, precision, num_iterations, num_threads, proc_id);
+        check_option(comm, options.checkpoint_dir == NULL, "-checkpoint", proc_id);
+        check_option(comm, !options.decreasing_precision, "-decreasing_precision", proc_id);
+        start_progress(comm, num_iterations, num_threads, proc_id);
+        algorithm_tag = "GMP-BEL-FXP-CYC-CYC";
+        init_pi_gmp(pi, plan.precision_bits, proc_id);
+        if (!load_cached_pi_gmp(comm, pi, proc_id)) bellard_fixed_point_algorithm_gmp(comm, num_procs, proc_id, pi, num_iterations, num_threads);
+        break;
+
+    case 11:
+        plan = plan_hex_window(precision, options.hex_start);
+        num_iterations = plan.num_iterations;
+        check_errors(comm, num_procs, precision, num_iterations, num_threads, proc_id);
+        check_option(comm, options.checkpoint_dir == NULL, "-checkpoint", proc_id);
+        start_progress(comm, num_iterations, num_threads, proc_id);
+        algorithm_tag = "GMP-BBP-HEX-CYC-CYC";
+        hex_window = true;
+        init_pi_gmp(pi, plan.precision_bits, proc_id);
+        bbp_hex_window_algorithm_gmp(comm, num_procs, proc_id, pi, options.hex_start, num_iterations, num_threads);
+        break;
+
+    case 12:
+        plan = plan_pi(precision, GAUSS_LEGENDRE_AGM);
+        num_iterations = plan.num_iterations;
+        check_errors(comm, 1, precision, num_iterations, 1, proc_id);       // only process 0 iterates
+        check_option(comm, options.checkpoint_dir == NULL, "-checkpoint", proc_id);
+        start_progress(comm, num_iterations, num_threads, proc_id);
+        algorithm_tag = "GMP-GLE-ONE-PML";
+        init_pi_gmp(pi, plan.precision_bits, proc_id);
+        if (!load_cached_pi_gmp(comm, pi, proc_id)) gauss_legendre_algorithm_gmp(comm, num_procs, proc_id, pi, num_iterations, num_threads);
+        break;
+
+    case 13:
+        plan = plan_pi(precision, TAKANO_SERIES);
+        num_iterations = plan.num_iterations;
+        check_errors(comm, num_procs, precision, num_iterations, num_threads, proc_id);
+        check_option(comm, options.checkpoint_dir == NULL, "-checkpoint", proc_id);
+        start_progress(comm, num_iterations, num_threads, proc_id);
+        algorithm_tag = "GMP-MCH-TAK-GRP-BLC";
+        init_pi_gmp(pi, plan.precision_bits, proc_id);
+        if (!load_cached_pi_gmp(comm, pi, proc_id)) machin_algorithm_gmp(comm, num_procs, proc_id, pi, &takano_formula, num_threads);
+        break;
+
+    case 14:
+        plan = plan_pi(precision, STORMER_SERIES);
+        num_iterations = plan.num_iterations;
+        check_errors(comm, num_procs, precision, num_iterations, num_threads, proc_id);
+        check_option(comm, options.checkpoint_dir == NULL, "-checkpoint", proc_id);
+        start_progress(comm, num_iterations, num_threads, proc_id);
+        algorithm_tag = "GMP-MCH-STO-GRP-BLC";
+        init_pi_gmp(pi, plan.precision_bits, proc_id);
+        if (!load_cached_pi_gmp(comm, pi, proc_id)) machin_algorithm_gmp(comm, num_procs, proc_id, pi, &stormer_formula, num_threads);
+        break;
+
+    case 15:
+        plan = plan_pi(precision, CHUDNOVSKY_SERIES);
+        num_iterations = plan.num_iterations;
+        check_errors(comm, num_procs, precision, num_iterations, num_threads, proc_id);
+        check_option(comm, options.checkpoint_dir == NULL, "-checkpoint", proc_id);
+        start_progress(comm, num_iterations, num_threads, proc_id);
+        algorithm_tag = "GMP-CHD-SME-BLC-CYC";
+        init_pi_gmp(pi, plan.precision_bits, proc_id);
+        if (!load_cached_pi_gmp(comm, pi, proc_id)) chudnovsky_blocks_and_cyclic_algorithm(&backend_gmp, comm, num_procs, proc_id, pi, num_iterations, num_threads, plan.precision_bits);
+        break;
+
+    default:
+        if (result != NULL) {
+            result -> available = false;
+            return;
+        }
+        if (proc_id == 0){
+            printf("  Algorithm number selected not availabe, try with another number. \n");
+            printf("\n");
+        } 
+        MPI_Finalize();
+        exit(-1);
+        break;
+    }
+
+    //Get time, check decimals, free pi and print the results
+    if (proc_id == 0) gettimeofday(&t2, NULL);
+    stop_progress();
+    mark_phase(FINAL_PHASE);
+    gather_phase_times(comm, num_procs, proc_id);
+    if (result != NULL) result -> available = true;
+    if (options.spot_checks > 0 && !hex_window) decimals_computed = spot_check_decimals_gmp(comm, pi, precision, num_procs, proc_id);
+    if (proc_id == 0) {  
+        execution_time = ((t2.tv_sec - t1.tv_sec) * 1000000u +  t2.tv_usec - t1.tv_usec)/1.e6; 
+        if (hex_window) decimals_computed = check_hex_window_gmp(pi, precision, options.hex_start);
+        else if (options.spot_checks == 0) decimals_computed = check_decimals_gmp(pi);
+        if (result != NULL) { 
+            result -> algorithm_tag = algorithm_tag;
+            result -> num_iterations = num_iterations;
+            result -> decimals_computed = decimals_computed;
+            result -> execution_time = execution_time;
+        } else if (print_in_csv_format) { 
+            print_results_csv("GMP", algorithm_tag, precision, num_iterations, num_procs, num_threads, decimals_computed, execution_time); 
+        } else { 
+            print_results("GMP", algorithm_tag, precision, num_iterations, num_procs, num_threads, decimals_computed, execution_time); 
+        }
+        if (hex_window && (options.output_file != NULL || !print_in_csv_format)) {
+            write_hex_window_gmp(pi, precision, options.output_file);
+        } else if (options.output_file != NULL) {
+            write_decimals_file_gmp(pi, precision, options.output_file);
+        }
+        if (options.dump_file != NULL) dump_pi_gmp(pi, options.dump_file);
+        if (options.cache_dir != NULL && !hex_window && decimals_computed >= precision) cache_pi_gmp(pi);
+        if (options.phase_report != NULL) write_phase_times_json(options.phase_report, "GMP", algorithm_tag, precision, execution_time);
+        mpf_clear(pi);
+    }
+    remove_checkpoints();        // pi is reduced and checked, the checkpoints of the run are not needed
+
+}
+
+
+
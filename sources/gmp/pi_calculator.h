@@ -1,7 +1,9 @@
 #ifndef PI_CALCULATOR_GMP
 #define PI_CALCULATOR_GMP
 
-void calculate_pi_gmp(int, int, int, int, int, bool);
+#include "../common/sweep.h"
+
+void calculate_pi_gmp(MPI_Comm, int, int, int, long, int, bool, struct run_result *);
 
 #endif
 
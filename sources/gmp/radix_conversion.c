@@ -0,0 +1,311 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <gmp.h>
+#include <omp.h>
+#include "radix_conversion.h"
+#include "../common/large_buffer.h"
+
+#define LEAF_DIGITS 8192                // digits converted with mpz_get_str and written at once
+#define TASK_DIGITS 262144              // blocks above this size are split in OpenMP tasks
+#define COMPARE_BYTES 256               // bytes compared at once with memcmp to find a mismatch
+
+
+/************************************************************************************
+ * Divide and conquer conversion to decimal                                         *
+ *                                                                                  *
+ ************************************************************************************
+ * The decimals of x are the integer f = floor(x 10^d) mod 10^d. A block of n       *
+ * digits of f is split with one division by a power of ten:                        *
+ *                                                                                  *
+ *        f = high 10^m + low,     m = LEAF_DIGITS 2^k < n <= 2m                    *
+ *                                                                                  *
+ * and the two halves are converted independently (in parallel OpenMP tasks for     *
+ * the large blocks) until they have LEAF_DIGITS digits. The powers 10^m are        *
+ * computed once by squaring. GMP divides with a subquadratic algorithm, so the     *
+ * conversion costs O(M(d) log d) instead of the quadratic cost of a sequential     *
+ * conversion.                                                                      *
+ *                                                                                  *
+ * Every leaf is written directly at its offset of the output, a memory buffer or   *
+ * a file written with pwrite in chunks of LEAF_DIGITS, so the digits are never     *
+ * stored together in one string.                                                   *
+ *                                                                                  *
+ * The output can also be a reference file mapped in memory: every leaf is          *
+ * compared with memcmp against the reference at its offset and the writer keeps   *
+ * the first offset that does not match. The blocks after that offset are not       *
+ * converted.                                                                       *
+ *                                                                                  *
+ ************************************************************************************/
+
+
+/*
+ * Compares length chars of chunk with the reference at offset and
+ * updates the first mismatching offset of writer
+ */
+static void compare_chunk(struct digit_writer *writer, char *chunk, long length, long offset){
+    long i, compared;
+
+    if (offset + length > writer -> reference_length) length = writer -> reference_length - offset;
+    for (i = 0; i < length; i += COMPARE_BYTES) {
+        compared = (length - i < COMPARE_BYTES) ? length - i : COMPARE_BYTES;
+        if (memcmp(chunk + i, writer -> reference + offset + i, compared) != 0) {
+            while (chunk[i] == writer -> reference[offset + i]) i++;
+            #pragma omp critical (digit_mismatch)
+            if (offset + i < writer -> mismatch) writer -> mismatch = offset + i;
+            return;
+        }
+    }
+}
+
+/*
+ * Writes length chars of chunk at offset of the output of writer
+ */
+static void write_chunk(struct digit_writer *writer, char *chunk, long length, long offset){
+    ssize_t written;
+
+    if (writer -> reference != NULL) {
+        if (offset < writer -> reference_length) compare_chunk(writer, chunk, length, offset);
+        return;
+    }
+    if (writer -> fd < 0) {
+        memcpy(writer -> buffer + offset, chunk, length);
+        return;
+    }
+    while (length > 0) {
+        written = pwrite(writer -> fd, chunk, length, offset);
+        if (written <= 0) {
+            printf("  Error writing the digits of pi \n");
+            exit(-1);
+        }
+        chunk += written;
+        offset += written;
+        length -= written;
+    }
+}
+
+/*
+ * Writes value (< 10^num_digits, num_digits <= LEAF_DIGITS) with leading zeros
+ */
+static void write_leaf(mpz_t value, long num_digits, long offset, struct digit_writer *writer){
+    char chunk[LEAF_DIGITS + 2];
+    long length;
+
+    mpz_get_str(chunk, 10, value);
+    length = strlen(chunk);
+    if (mpz_sgn(value) == 0) length = 0;
+    memmove(chunk + num_digits - length, chunk, length);
+    memset(chunk, '0', num_digits - length);
+    write_chunk(writer, chunk, num_digits, offset);
+}
+
+/*
+ * Writes the num_digits decimal digits of value (< 10^num_digits) at offset.
+ * powers[k] should be 10^(LEAF_DIGITS 2^k)
+ */
+static void write_block(mpz_t value, long num_digits, long offset, struct digit_writer *writer, mpz_t *powers){
+    int k;
+    long low_digits, mismatch;
+    mpz_t high, low;
+
+    //The digits after the first mismatch with the reference are not needed
+    if (writer -> reference != NULL) {
+        #pragma omp atomic read
+        mismatch = writer -> mismatch;
+        if (offset >= mismatch) return;
+    }
+
+    if (num_digits <= LEAF_DIGITS) {
+        write_leaf(value, num_digits, offset, writer);
+        return;
+    }
+
+    k = 0;
+    while (((long) LEAF_DIGITS << (k + 1)) < num_digits) k++;
+    low_digits = (long) LEAF_DIGITS << k;
+
+    mpz_inits(high, low, NULL);
+    mpz_tdiv_qr(high, low, value, powers[k]);
+
+    if (num_digits > TASK_DIGITS) {
+        #pragma omp task shared(high, writer, powers)
+        write_block(high, num_digits - low_digits, offset, writer, powers);
+        write_block(low, low_digits, offset + num_digits - low_digits, writer, powers);
+        #pragma omp taskwait
+    } else {
+        write_block(high, num_digits - low_digits, offset, writer, powers);
+        write_block(low, low_digits, offset + num_digits - low_digits, writer, powers);
+    }
+
+    mpz_clears(high, low, NULL);
+}
+
+/*
+ * Writes integer_part, the point and the num_decimals digits of decimals (< 10^num_decimals).
+ * It returns the number of chars written.
+ */
+long write_decimals_z_gmp(mpz_t integer_part, mpz_t decimals, long num_decimals, struct digit_writer *writer){
+    int k, num_powers;
+    long length;
+    char *integer_string;
+    mpz_t *powers;
+
+    //The string is allocated here: with -arena the allocations of GMP come from the arena
+    integer_string = malloc(mpz_sizeinbase(integer_part, 10) + 2);
+    mpz_get_str(integer_string, 10, integer_part);
+    length = strlen(integer_string);
+    write_chunk(writer, integer_string, length, 0);
+    write_chunk(writer, ".", 1, length);
+    length++;
+    free(integer_string);
+
+    //Powers of ten used to split the blocks
+    num_powers = 1;
+    while (((long) LEAF_DIGITS << num_powers) < num_decimals) num_powers++;
+    powers = malloc(num_powers * sizeof(mpz_t));
+    mpz_init(powers[0]);
+    mpz_ui_pow_ui(powers[0], 10, LEAF_DIGITS);
+    for (k = 1; k < num_powers; k++) {
+        mpz_init(powers[k]);
+        mpz_mul(powers[k], powers[k - 1], powers[k - 1]);
+    }
+
+    #pragma omp parallel
+    {
+        #pragma omp single
+        write_block(decimals, num_decimals, length, writer, powers);
+    }
+
+    for (k = 0; k < num_powers; k++) mpz_clear(powers[k]);
+    free(powers);
+
+    return length + num_decimals;
+}
+
+/*
+ * Writes x (x >= 0) with num_decimals decimals (truncated).
+ * It returns the number of chars written.
+ */
+long write_decimals_gmp(mpf_t x, long num_decimals, struct digit_writer *writer){
+    long length;
+    mp_bitcnt_t fraction_bits;
+    mpz_t integer_part, decimals, power;
+    mpf_t aux;
+
+    fraction_bits = (mp_bitcnt_t) (x -> _mp_prec + 1) * GMP_NUMB_BITS;
+    mpz_inits(integer_part, decimals, power, NULL);
+    mpf_init2(aux, mpf_get_prec(x));
+
+    // decimals = floor(x 2^fraction_bits) 10^num_decimals / 2^fraction_bits mod 10^num_decimals
+    mpf_mul_2exp(aux, x, fraction_bits);
+    mpz_set_f(decimals, aux);
+    mpz_ui_pow_ui(power, 10, num_decimals);
+    mpz_mul(decimals, decimals, power);
+    mpz_tdiv_q_2exp(decimals, decimals, fraction_bits);
+    mpz_tdiv_qr(integer_part, decimals, decimals, power);
+
+    length = write_decimals_z_gmp(integer_part, decimals, num_decimals, writer);
+
+    mpz_clears(integer_part, decimals, power, NULL);
+    mpf_clear(aux);
+
+    return length;
+}
+
+/*
+ * Opens the file path to write digits, truncating its previous content
+ */
+void open_digit_file(struct digit_writer *writer, char *path){
+    writer -> buffer = NULL;
+    writer -> reference = NULL;
+    writer -> fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (writer -> fd < 0) {
+        printf("  The file %s can not be written \n", path);
+        exit(-1);
+    }
+}
+
+void close_digit_file(struct digit_writer *writer){
+    close(writer -> fd);
+}
+
+/*
+ * Maps the file path in memory to compare the digits written with it.
+ * It returns false if the file can not be read.
+ */
+bool open_reference_file(struct digit_writer *writer, char *path){
+    int fd;
+    struct stat file_status;
+
+    fd = open(path, O_RDONLY);
+    if (fd < 0) return false;
+    if (fstat(fd, &file_status) != 0 || file_status.st_size == 0) {
+        close(fd);
+        return false;
+    }
+    writer -> reference = mmap(NULL, file_status.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (writer -> reference == MAP_FAILED) return false;
+    madvise(writer -> reference, file_status.st_size, MADV_SEQUENTIAL);
+
+    writer -> fd = -1;
+    writer -> buffer = NULL;
+    writer -> reference_length = file_status.st_size;
+    writer -> mismatch = file_status.st_size;
+    return true;
+}
+
+void close_reference_file(struct digit_writer *writer){
+    munmap(writer -> reference, writer -> reference_length);
+}
+
+/*
+ * Writes x with num_decimals decimals in the file path
+ */
+void write_decimals_file_gmp(mpf_t x, long num_decimals, char *path){
+    struct digit_writer writer;
+
+    open_digit_file(&writer, path);
+    write_decimals_gmp(x, num_decimals, &writer);
+    close_digit_file(&writer);
+}
+
+/*
+ * Writes the length hex digits of the fraction x (0 <= x < 1) in the file path,
+ * or in the standard output if path is NULL
+ */
+void write_hex_window_gmp(mpf_t x, long length, char *path){
+    long digits_length;
+    char *digits;
+    mpz_t value;
+    mpf_t aux;
+    struct digit_writer writer;
+
+    mpz_init(value);
+    mpf_init2(aux, mpf_get_prec(x));
+    mpf_mul_2exp(aux, x, 4 * length);
+    mpz_set_f(value, aux);
+
+    //Leading zeros of the fraction
+    digits = allocate_large_buffer(length + 2);
+    mpz_get_str(digits + 1, 16, value);
+    digits_length = (mpz_sgn(value) == 0) ? 0 : strlen(digits + 1);
+    memmove(digits + length - digits_length, digits + 1, digits_length);
+    memset(digits, '0', length - digits_length);
+
+    if (path != NULL) {
+        open_digit_file(&writer, path);
+        write_chunk(&writer, digits, length, 0);
+        close_digit_file(&writer);
+    } else {
+        printf("  Hex digits: %.*s \n", (int) length, digits);
+    }
+
+    free_large_buffer(digits);
+    mpz_clear(value);
+    mpf_clear(aux);
+}
+
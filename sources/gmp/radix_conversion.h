@@ -0,0 +1,24 @@
+#ifndef RADIX_CONVERSION_GMP
+#define RADIX_CONVERSION_GMP
+
+#include <stdbool.h>
+
+struct digit_writer {
+    int fd;
+    char *buffer;
+    char *reference;
+    long reference_length;
+    long mismatch;
+};
+
+long write_decimals_z_gmp(mpz_t, mpz_t, long, struct digit_writer *);
+long write_decimals_gmp(mpf_t, long, struct digit_writer *);
+void write_decimals_file_gmp(mpf_t, long, char *);
+void write_hex_window_gmp(mpf_t, long, char *);
+void open_digit_file(struct digit_writer *, char *);
+void close_digit_file(struct digit_writer *);
+bool open_reference_file(struct digit_writer *, char *);
+void close_reference_file(struct digit_writer *);
+
+#endif
+
@@ -0,0 +1,57 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <sys/stat.h>
+#include <gmp.h>
+#include "mpi.h"
+#include "../common/options.h"
+#include "../common/result_dump.h"
+#include "result_dump.h"
+
+
+/*
+ * Writes the binary dump of pi in path (see common/result_dump.c)
+ */
+void dump_pi_gmp(mpf_t pi, char *path){
+    write_result_dump(path, "GMP", mpf_get_prec(pi), pi -> _mp_exp, mpf_sgn(pi), pi -> _mp_d, abs(pi -> _mp_size));
+}
+
+/*
+ * Sets pi (process 0) from the smallest result of the cache with the same or more
+ * precision, truncated to the precision of pi. Every process should call it.
+ * It returns false if the cache is not used or it has no result for this precision.
+ */
+bool load_cached_pi_gmp(MPI_Comm comm, mpf_t pi, int proc_id){
+    int found = 0;
+    char path[4096];
+    mpf_t cached;
+    struct mapped_result_dump dump;
+
+    if (options.cache_dir == NULL) return false;
+    if (proc_id == 0 && find_cached_result(options.cache_dir, "GMP", mpf_get_prec(pi), path, sizeof(path))
+            && map_result_dump(&dump, path, "GMP", pi -> _mp_prec + 1)) {
+        //Read only view of the checked limbs: the most significant limbs that pi keeps
+        cached -> _mp_prec = dump.used_limbs;
+        cached -> _mp_size = (dump.header.sign < 0) ? -dump.used_limbs : dump.used_limbs;
+        cached -> _mp_exp = dump.header.exponent;
+        cached -> _mp_d = (mp_limb_t *) dump.limbs + (dump.header.num_limbs - dump.used_limbs);
+        mpf_set(pi, cached);
+        unmap_result_dump(&dump);
+        found = 1;
+    }
+    MPI_Bcast(&found, 1, MPI_INT, 0, comm);
+    return found;
+}
+
+/*
+ * Stores pi (process 0) in the cache unless it has a result with the same or more precision
+ */
+void cache_pi_gmp(mpf_t pi){
+    char path[4096];
+
+    if (find_cached_result(options.cache_dir, "GMP", mpf_get_prec(pi), path, sizeof(path))) return;
+    mkdir(options.cache_dir, 0755);
+    cache_result_path(options.cache_dir, "GMP", mpf_get_prec(pi), path, sizeof(path));
+    dump_pi_gmp(pi, path);
+}
+
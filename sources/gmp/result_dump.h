@@ -0,0 +1,11 @@
+#ifndef RESULT_DUMP_GMP
+#define RESULT_DUMP_GMP
+
+#include <stdbool.h>
+
+void dump_pi_gmp(mpf_t, char *);
+bool load_cached_pi_gmp(MPI_Comm, mpf_t, int);
+void cache_pi_gmp(mpf_t);
+
+#endif
+
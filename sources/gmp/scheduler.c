@@ -0,0 +1,163 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <gmp.h>
+#include "mpi.h"
+#include "working_precision.h"
+#include "scheduler.h"
+
+#define DEP_A_BITS_PER_TERM 10.75       // log2(12^3)
+#define DEP_B_BITS_PER_TERM 57.94       // log2(640320^3)
+#define BITS_PER_TERM 47.11             // log2(640320^3 / 12^3)
+#define CALIBRATION_TIME 0.01           // seconds per measure
+
+
+/************************************************************************************
+ * Cost model of the Chudnovsky iterations                                          *
+ *                                                                                  *
+ ************************************************************************************
+ * The iteration n works with quotients of w(n) bits (the working precision) and    *
+ * its cost is dominated by the products and divisions by dep_a and dep_b, whose    *
+ * sizes grow with n until they reach the working precision:                        *
+ *                                                                                  *
+ *      s(n) = (min(10.75n, w(n)) + min(57.94n, w(n))) / 64     limbs               *
+ *                                                                                  *
+ *                w(n)                                                              *
+ *   cost(n) = ------ (fixed + scale s(n)^exponent)                                 *
+ *                P                                                                 *
+ *                                                                                  *
+ * By default the coefficients are the ones of the GMP division of w(n) by s(n)     *
+ * limbs measured in an x86-64 node: the fixed cost is four linear passes and the   *
+ * cost grows as s(n)^0.4 because the large divisions are subquadratic.             *
+ * They can be fitted to the local hardware with calibrate_cost_model_gmp.          *
+ *                                                                                  *
+ ************************************************************************************/
+
+
+void init_cost_model_gmp(struct cost_model_gmp *model){
+    model -> fixed = 4;
+    model -> scale = 3;
+    model -> exponent = 0.4;
+}
+
+/*
+ * Average time of the division of a number of the default precision by a number of size limbs
+ */
+double time_division_gmp(int size){
+    int repetitions;
+    double start, elapsed;
+    mpz_t random;
+    mpf_t dividend, divisor, quotient;
+    gmp_randstate_t state;
+
+    gmp_randinit_default(state);
+    mpz_init(random);
+    mpf_inits(dividend, divisor, quotient, NULL);
+    mpz_urandomb(random, state, mpf_get_default_prec());
+    mpf_set_z(dividend, random);
+    mpz_urandomb(random, state, (mp_bitcnt_t) size * GMP_NUMB_BITS);
+    mpz_setbit(random, (mp_bitcnt_t) size * GMP_NUMB_BITS - 1);
+    mpf_set_z(divisor, random);
+
+    repetitions = 0;
+    start = MPI_Wtime();
+    do {
+        mpf_div(quotient, dividend, divisor);
+        repetitions++;
+        elapsed = MPI_Wtime() - start;
+    } while (elapsed < CALIBRATION_TIME);
+
+    mpz_clear(random);
+    mpf_clears(dividend, divisor, quotient, NULL);
+    gmp_randclear(state);
+
+    return elapsed / repetitions;
+}
+
+/*
+ * Fits the coefficients of the model to the local hardware measuring the divisions
+ * of the default precision by divisors of 1, P/4 and P limbs in process 0.
+ * The coefficients are sent to every process, so all of them compute the same schedule.
+ * If the measures are not consistent the model is not changed.
+ */
+void calibrate_cost_model_gmp(MPI_Comm comm, struct cost_model_gmp *model, int proc_id){
+    int limbs;
+    double time_fixed, time_quarter, time_full, coefficients[3];
+
+    coefficients[0] = model -> fixed;
+    coefficients[1] = model -> scale;
+    coefficients[2] = model -> exponent;
+
+    limbs = mpf_get_default_prec() / GMP_NUMB_BITS;
+    if (proc_id == 0 && limbs >= 16) {
+        time_fixed = time_division_gmp(1);
+        time_quarter = time_division_gmp(limbs / 4) - time_fixed;
+        time_full = time_division_gmp(limbs) - time_fixed;
+        if (time_quarter > 0 && time_full > time_quarter) {
+            coefficients[2] = log(time_full / time_quarter) / log(4.0);
+            coefficients[1] = time_full / pow(limbs, coefficients[2]);
+            coefficients[0] = 4 * time_fixed;
+        }
+    }
+    MPI_Bcast(coefficients, 3, MPI_DOUBLE, 0, comm);
+
+    model -> fixed = coefficients[0];
+    model -> scale = coefficients[1];
+    model -> exponent = coefficients[2];
+}
+
+/*
+ * Cost of the Chudnovsky iteration n computed with precision bits
+ */
+double chudnovsky_term_cost_gmp(struct cost_model_gmp *model, mp_bitcnt_t precision, long n){
+    double working_bits, size;
+
+    working_bits = working_precision_gmp(precision, BITS_PER_TERM, n);
+    size = fmin(DEP_A_BITS_PER_TERM * n, working_bits) + fmin(DEP_B_BITS_PER_TERM * n, working_bits);
+    size = size / GMP_NUMB_BITS + 1;
+
+    return working_bits / precision * (model -> fixed + model -> scale * pow(size, model -> exponent));
+}
+
+/*
+ * Splits the Chudnovsky iterations computed with precision bits in num_workers contiguous
+ * ranges whose cost is proportional to the weights of the workers, or the same cost if
+ * weights is NULL. It returns an array of num_workers + 1 longs: the range of the worker w
+ * is [schedule[w], schedule[w + 1]). The array should be freed by the caller.
+ */
+long * chudnovsky_schedule_gmp(struct cost_model_gmp *model, long num_iterations, int num_workers, double *weights, mp_bitcnt_t precision){
+    long *schedule, n;
+    int worker;
+    double total_cost, accumulated_cost, total_weight, accumulated_weight;
+
+    schedule = malloc(sizeof(long) * (num_workers + 1));
+
+    total_cost = 0;
+    for (n = 0; n < num_iterations; n++) {
+        total_cost += chudnovsky_term_cost_gmp(model, precision, n);
+    }
+    total_weight = 0;
+    for (worker = 0; worker < num_workers; worker++) {
+        total_weight += (weights == NULL) ? 1 : weights[worker];
+    }
+
+    //Every worker starts where the accumulated cost reaches the share of the previous workers
+    schedule[0] = 0;
+    worker = 1;
+    accumulated_cost = 0;
+    accumulated_weight = (weights == NULL) ? 1 : weights[0];
+    for (n = 0; n < num_iterations && worker < num_workers; n++) {
+        accumulated_cost += chudnovsky_term_cost_gmp(model, precision, n);
+        while (worker < num_workers && accumulated_cost >= total_cost * accumulated_weight / total_weight) {
+            schedule[worker] = n + 1;
+            accumulated_weight += (weights == NULL) ? 1 : weights[worker];
+            worker++;
+        }
+    }
+    while (worker <= num_workers) {
+        schedule[worker] = num_iterations;
+        worker++;
+    }
+
+    return schedule;
+}
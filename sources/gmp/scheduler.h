@@ -0,0 +1,15 @@
+#ifndef SCHEDULER_GMP
+#define SCHEDULER_GMP
+
+struct cost_model_gmp {
+    double fixed;
+    double scale;
+    double exponent;
+};
+
+void init_cost_model_gmp(struct cost_model_gmp *);
+void calibrate_cost_model_gmp(MPI_Comm, struct cost_model_gmp *, int);
+double chudnovsky_term_cost_gmp(struct cost_model_gmp *, mp_bitcnt_t, long);
+long * chudnovsky_schedule_gmp(struct cost_model_gmp *, long, int, double *, mp_bitcnt_t);
+
+#endif
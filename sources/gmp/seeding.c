@@ -0,0 +1,82 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <gmp.h>
+
+#define A 13591409
+#define B 545140134
+#define C_ODD 10005                     // 640320 = 2^6 * 10005
+
+
+/************************************************************************************
+ * Seeding of the dependencies of the series at an arbitrary iteration n            *
+ * They are computed from their closed form, so a block, a chunk or a cyclic        *
+ * distribution can start at any n without walking the previous iterations.         *
+ *                                                                                  *
+ ************************************************************************************
+ * BBP and Bellard: the powers of two only set the exponent                         *
+ *                                                                                  *
+ *           dep_m(n) = 2^-4n                    (BBP)                              *
+ *           dep_m(n) = (-1)^n 2^-10n            (Bellard)                          *
+ *                                                                                  *
+ ************************************************************************************
+ * Chudnovsky: dep_a is the product of three binomial coefficients, computed by     *
+ * GMP without any division, and dep_b splits its power of two:                     *
+ *                                                                                  *
+ *                    (6n)!          / 6n \ / 3n \ / 2n \                           *
+ *      dep_a(n) = ------------- =  |    | |    | |    |                            *
+ *                 (n!)^3 (3n)!      \ 3n / \ n  / \ n  /                           *
+ *                                                                                  *
+ *      dep_b(n) = (-640320)^3n = (-1)^n 10005^3n 2^18n                             *
+ *                                                                                  *
+ *      dep_c(n) = 545140134n + 13591409                                            *
+ *                                                                                  *
+ ************************************************************************************/
+
+
+/*
+ * dep_m = (1/16)^n
+ */
+void seed_bbp_gmp(mpf_t dep_m, long n){
+    mpf_set_ui(dep_m, 1);
+    mpf_div_2exp(dep_m, dep_m, 4 * (mp_bitcnt_t) n);
+}
+
+/*
+ * dep_m = (-1)^n / 1024^n
+ */
+void seed_bellard_gmp(mpf_t dep_m, long n){
+    mpf_set_ui(dep_m, 1);
+    mpf_div_2exp(dep_m, dep_m, 10 * (mp_bitcnt_t) n);
+    if (n % 2 != 0) mpf_neg(dep_m, dep_m);
+}
+
+/*
+ * dep_a, dep_b and dep_c of the Chudnovsky iteration n
+ */
+void seed_chudnovsky_gmp(mpf_t dep_a, mpf_t dep_b, mpf_t dep_c, long n){
+    mpz_t binomial, product;
+
+    mpz_inits(binomial, product, NULL);
+
+    //dep_a = binom(6n, 3n) * binom(3n, n) * binom(2n, n)
+    mpz_bin_uiui(product, 6 * (unsigned long) n, 3 * (unsigned long) n);
+    mpz_bin_uiui(binomial, 3 * (unsigned long) n, n);
+    mpz_mul(product, product, binomial);
+    mpz_bin_uiui(binomial, 2 * (unsigned long) n, n);
+    mpz_mul(product, product, binomial);
+    mpf_set_z(dep_a, product);
+
+    //dep_b = (-1)^n 10005^3n 2^18n
+    mpz_ui_pow_ui(product, C_ODD, 3 * (unsigned long) n);
+    mpf_set_z(dep_b, product);
+    mpf_mul_2exp(dep_b, dep_b, 18 * (mp_bitcnt_t) n);
+    if (n % 2 != 0) mpf_neg(dep_b, dep_b);
+
+    //dep_c = B n + A
+    mpf_set_ui(dep_c, B);
+    mpf_mul_ui(dep_c, dep_c, n);
+    mpf_add_ui(dep_c, dep_c, A);
+
+    mpz_clears(binomial, product, NULL);
+}
+
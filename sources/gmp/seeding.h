@@ -0,0 +1,9 @@
+#ifndef SEEDING_GMP
+#define SEEDING_GMP
+
+void seed_bbp_gmp(mpf_t, long);
+void seed_bellard_gmp(mpf_t, long);
+void seed_chudnovsky_gmp(mpf_t, mpf_t, mpf_t, long);
+
+#endif
+
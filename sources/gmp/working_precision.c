@@ -0,0 +1,41 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <gmp.h>
+#include "../common/options.h"
+
+#define GUARD_BITS 64
+
+
+/*
+ * Precision in bits needed to compute the term n of a series whose terms are
+ * bits_per_term bits smaller each iteration. The error of the term is then below
+ * the error of the full precision sum.
+ * If the -decreasing_precision option is not used it is always the full precision.
+ */
+mp_bitcnt_t working_precision_gmp(mp_bitcnt_t precision, double bits_per_term, long n){
+    double bits;
+
+    if (!options.decreasing_precision) return precision;
+    bits = (double) precision + GUARD_BITS - bits_per_term * n;
+    if (bits >= precision) return precision;
+    if (bits < 2 * GUARD_BITS) return 2 * GUARD_BITS;
+    return (mp_bitcnt_t) bits;
+}
+
+/*
+ * Sets the precision of a NULL-terminated list of mpf_t without changing their values.
+ * It is used to reduce the precision of the variables of the terms as the series advances.
+ * IMPORTANT: precision should not be greater than the precision used to init the variables,
+ * and that precision should be set again before clearing them.
+ */
+void set_working_precision_gmp(mp_bitcnt_t precision, mpf_ptr x, ...){
+    va_list variables;
+
+    va_start(variables, x);
+    while (x != NULL) {
+        mpf_set_prec_raw(x, precision);
+        x = va_arg(variables, mpf_ptr);
+    }
+    va_end(variables);
+}
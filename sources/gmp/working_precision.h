@@ -0,0 +1,7 @@
+#ifndef WORKING_PRECISION_GMP
+#define WORKING_PRECISION_GMP
+
+mp_bitcnt_t working_precision_gmp(mp_bitcnt_t, double, long);
+void set_working_precision_gmp(mp_bitcnt_t, mpf_ptr, ...);
+
+#endif
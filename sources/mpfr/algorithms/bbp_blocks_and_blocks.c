@@ -5,8 +5,15 @@
 #include <math.h>
 #include "mpi.h"
 #include "../mpi_operations.h"
+#include "../omp_operations.h"
+#include "../working_precision.h"
+#include "../seeding.h"
+#include "../../common/checkpoint.h"
+#include "../checkpoint.h"
+#include "../../common/phase_timer.h"
+#include "../../common/progress.h"
 
-#define QUOTIENT 0.0625
+#define BITS_PER_TERM 4                 // log2(16)
 
 /************************************************************************************
  * Miguel Pardo Navarro. 17/07/2021                                                 *
@@ -40,14 +47,14 @@
  /*
  * An iteration of Bailey Borwein Plouffe formula
  */
-void bbp_iteration_mpfr(mpfr_t pi, int n, mpfr_t dep_m, mpfr_t quot_a, mpfr_t quot_b, mpfr_t quot_c, mpfr_t quot_d, mpfr_t aux){
+void bbp_iteration_mpfr(mpfr_t pi, long n, mpfr_t dep_m, mpfr_t quot_a, mpfr_t quot_b, mpfr_t quot_c, mpfr_t quot_d, mpfr_t aux){
     mpfr_set_ui(quot_a, 4, MPFR_RNDN);              // quot_a = ( 4 / (8n + 1))
     mpfr_set_ui(quot_b, 2, MPFR_RNDN);              // quot_b = (-2 / (8n + 4))
     mpfr_set_ui(quot_c, 1, MPFR_RNDN);              // quot_c = (-1 / (8n + 5))
     mpfr_set_ui(quot_d, 1, MPFR_RNDN);              // quot_d = (-1 / (8n + 6))
     mpfr_set_ui(aux, 0, MPFR_RNDN);                 // aux = a + b + c + d  
 
-    int i = n << 3;                     // i = 8n
+    unsigned long i = (unsigned long) n << 3;   // i = 8n
     mpfr_div_ui(quot_a, quot_a, i | 1, MPFR_RNDN);  // 4 / (8n + 1)
     mpfr_div_ui(quot_b, quot_b, i | 4, MPFR_RNDN);  // 2 / (8n + 4)
     mpfr_div_ui(quot_c, quot_c, i | 5, MPFR_RNDN);  // 1 / (8n + 5)
@@ -62,21 +69,20 @@ void bbp_iteration_mpfr(mpfr_t pi, int n, mpfr_t dep_m, mpfr_t quot_a, mpfr_t qu
     mpfr_mul(aux, aux, dep_m, MPFR_RNDN);   
     
     mpfr_add(pi, pi, aux, MPFR_RNDN);  
+    add_progress(1);
 }
 
 
-void bbp_blocks_and_blocks_algorithm_mpfr(int num_procs, int proc_id, mpfr_t pi, int num_iterations, int num_threads, int precision_bits){
-    int block_size, block_start, block_end, position, packet_size, d_elements;
-    mpfr_t local_proc_pi, quotient;
+void bbp_blocks_and_blocks_algorithm_mpfr(MPI_Comm comm, int num_procs, int proc_id, mpfr_t pi, long num_iterations, int num_threads, long precision_bits){
+    long block_size, block_start, block_end;
+    mpfr_t local_proc_pi;
 
     block_size = (num_iterations + num_procs - 1) / num_procs;
     block_start = proc_id * block_size;
     block_end = block_start + block_size;
     if (block_end > num_iterations) block_end = num_iterations;
 
-    mpfr_inits2(precision_bits, local_proc_pi, quotient, NULL);
-    mpfr_set_d(quotient, QUOTIENT, MPFR_RNDN);
-    mpfr_set_ui(local_proc_pi, 0, MPFR_RNDN);
+    init_transport_mpfr(local_proc_pi, precision_bits);
 
 
     //Set the number of threads 
@@ -84,8 +90,11 @@ void bbp_blocks_and_blocks_algorithm_mpfr(int num_procs, int proc_id, mpfr_t pi,
 
     #pragma omp parallel 
     {
-        int thread_id, i, thread_block_size, thread_block_start, thread_block_end;
+        int thread_id;
+        long i, thread_block_size, thread_block_start, thread_block_end;
+        mpfr_prec_t working_precision;
         mpfr_t local_thread_pi, dep_m, quot_a, quot_b, quot_c, quot_d, aux;
+        struct checkpoint checkpoint;
 
         thread_id = omp_get_thread_num();
         thread_block_size = (block_size + num_threads - 1) / num_threads;
@@ -95,51 +104,39 @@ void bbp_blocks_and_blocks_algorithm_mpfr(int num_procs, int proc_id, mpfr_t pi,
         
         mpfr_init2(local_thread_pi, precision_bits);               // private thread pi
         mpfr_set_ui(local_thread_pi, 0, MPFR_RNDN);
+        init_checkpoint(&checkpoint, "MPFR-BBP-BLC-BLC", num_procs, proc_id, num_threads, thread_id, num_iterations, precision_bits);
+        load_checkpoint_mpfr(&checkpoint, &thread_block_start, local_thread_pi);
         mpfr_init2(dep_m, precision_bits);
-        mpfr_pow_ui(dep_m, quotient, thread_block_start, MPFR_RNDN);    // m = (1/16)^n                  
+        seed_bbp_mpfr(dep_m, thread_block_start);                       // m = (1/16)^n
         mpfr_inits2(precision_bits, quot_a, quot_b, quot_c, quot_d, aux, NULL);
         
 
+        mark_phase(SEED_PHASE);
         //First Phase -> Working on a local variable        
         for(i = thread_block_start; i < thread_block_end; i++){
+            //Work with the precision needed by the term i
+            working_precision = working_precision_mpfr(precision_bits, BITS_PER_TERM, i);
+            set_working_precision_mpfr(working_precision, quot_a, quot_b, quot_c, quot_d, aux, NULL);
+            round_working_precision_mpfr(working_precision, dep_m, NULL);
             bbp_iteration_mpfr(local_thread_pi, i, dep_m, quot_a, quot_b, quot_c, quot_d, aux);
             // Update dependencies:  
-            mpfr_mul(dep_m, dep_m, quotient, MPFR_RNDN);
+            mpfr_div_2ui(dep_m, dep_m, 4, MPFR_RNDN);
+            if (checkpoint_due(&checkpoint)) save_checkpoint_mpfr(&checkpoint, i + 1, local_thread_pi);
         }
 
         //Second Phase -> Accumulate the result in the global variable
-        #pragma omp critical
-        mpfr_add(local_proc_pi, local_proc_pi, local_thread_pi, MPFR_RNDN);
+        reduce_threads_mpfr(local_proc_pi, local_thread_pi);
 
         //Clear thread memory
         mpfr_free_cache();
         mpfr_clears(local_thread_pi, dep_m, quot_a, quot_b, quot_c, quot_d, aux, NULL);   
     }
 
-    //Create user defined operation
-    MPI_Op add_op;
-    MPI_Op_create((MPI_User_function *)add_mpfr, 0, &add_op);
-
-    //Set buffers for cumunications and position for pack and unpack information
-    d_elements = (int) ceil((float) local_proc_pi -> _mpfr_prec / (float) GMP_NUMB_BITS);
-    packet_size = 8 + sizeof(mpfr_exp_t) + (d_elements * sizeof(mp_limb_t));
-    char recbuffer[packet_size];
-    char sendbuffer[packet_size];
-
-    //Pack local_proc_pi in sendbuffuer
-    position = pack_mpfr(sendbuffer, local_proc_pi);
-
-    //Reduce piLocal
-    MPI_Reduce(sendbuffer, recbuffer, position, MPI_PACKED, add_op, 0, MPI_COMM_WORLD);
-
-    //Unpack recbuffer in global Pi and do the last operation
-    if (proc_id == 0){
-        unpack_mpfr(recbuffer, pi);
-    }
+    //Reduce local_proc_pi in global Pi
+    reduce_add_mpfr(comm, pi, local_proc_pi, proc_id);
 
     //Clear memory
-    MPI_Op_free(&add_op);
-    mpfr_clears(local_proc_pi, quotient, NULL);       
+    clear_transport_mpfr(local_proc_pi);
 
 }
 
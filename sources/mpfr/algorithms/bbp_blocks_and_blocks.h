@@ -1,7 +1,9 @@
 #ifndef BBP_BLOCKS_AND_BLOCKS_MPFR
 #define BBP_BLOCKS_AND_BLOCKS_MPFR
 
-void bbp_blocks_and_blocks_algorithm_mpfr(int, int, mpfr_t, int, int, int);
+void bbp_blocks_and_blocks_algorithm_mpfr(MPI_Comm, int, int, mpfr_t, long, int, long);
+
+void bbp_iteration_mpfr(mpfr_t, long, mpfr_t, mpfr_t, mpfr_t, mpfr_t, mpfr_t, mpfr_t);
 
 #endif
 
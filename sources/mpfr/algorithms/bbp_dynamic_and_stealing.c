@@ -0,0 +1,75 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <mpfr.h>
+#include <omp.h>
+#include "mpi.h"
+#include "../working_precision.h"
+#include "../seeding.h"
+#include "../../common/dynamic_scheduler.h"
+#include "../../common/phase_timer.h"
+#include "bbp_blocks_and_blocks.h"
+
+#define BITS_PER_TERM 4                 // log2(16)
+#define SUM_EXPONENT 1                  // pi > 2
+
+
+/************************************************************************************
+ * Bailey Borwein Plouffe formula implementation                                    *
+ * This version distributes the iterations dynamically: processes take chunks of    *
+ * iterations from a shared counter and threads steal work from each other          *
+ * (see common/dynamic_scheduler.c and common/dynamic_schedules.c).                 *
+ *                                                                                  *
+ ************************************************************************************
+ * Bailey Borwein Plouffe formula:                                                  *
+ *                      1        4          2        1       1                      *
+ *    pi = SUMMATORY( ------ [ ------  - ------ - ------ - ------]),  n >=0         *
+ *                     16^n    8n + 1    8n + 4   8n + 5   8n + 6                   *
+ *                                                                                  *
+ ************************************************************************************
+ * Seed of the dependencies at the start of a chunk:                                *
+ *                                                                                  *
+ *                        1                                                         *
+ *           dep_m(n) = ----- = 2^-4n      (only the exponent is set)               *
+ *                       16^n                                                       *
+ *                                                                                  *
+ ************************************************************************************/
+
+
+/*
+ * Adds to local_thread_pi the terms of the chunks given to the thread thread_id by the
+ * scheduler, with precision_bits
+ */
+void bbp_dynamic_terms_mpfr(mpfr_t local_thread_pi, struct dynamic_scheduler *scheduler, int thread_id, long precision_bits){
+    long i, chunk_start, chunk_end, previous_end;
+    mpfr_prec_t working_precision;
+    mpfr_t dep_m, quot_a, quot_b, quot_c, quot_d, aux;
+
+    mpfr_inits2(precision_bits, dep_m, quot_a, quot_b, quot_c, quot_d, aux, NULL);
+    previous_end = -1;
+
+    mark_phase(SEED_PHASE);
+    while (next_chunk(scheduler, thread_id, &chunk_start, &chunk_end)) {
+        if (chunk_start != previous_end) {
+            //Seed dep_m = (1/16)^n
+            working_precision = working_precision_mpfr(precision_bits, BITS_PER_TERM, chunk_start);
+            set_working_precision_mpfr(working_precision, dep_m, NULL);
+            seed_bbp_mpfr(dep_m, chunk_start);
+        }
+        for (i = chunk_start; i < chunk_end; i++) {
+            //Work with the precision needed by the term i
+            working_precision = working_precision_mpfr(precision_bits, BITS_PER_TERM, i);
+            set_working_precision_mpfr(working_precision, quot_a, quot_b, quot_c, quot_d, aux, NULL);
+            round_working_precision_mpfr(working_precision, dep_m, NULL);
+            bbp_iteration_mpfr(local_thread_pi, i, dep_m, quot_a, quot_b, quot_c, quot_d, aux);
+            report_term_exponent(scheduler, i, mpfr_get_exp(aux) - SUM_EXPONENT);
+            // Update dependencies:
+            mpfr_div_2ui(dep_m, dep_m, 4, MPFR_RNDN);
+        }
+        previous_end = chunk_end;
+    }
+
+    //Clear memory
+    mpfr_free_cache();
+    mpfr_clears(dep_m, quot_a, quot_b, quot_c, quot_d, aux, NULL);
+}
+
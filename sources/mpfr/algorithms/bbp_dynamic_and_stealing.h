@@ -0,0 +1,8 @@
+#ifndef BBP_DYNAMIC_AND_STEALING_MPFR
+#define BBP_DYNAMIC_AND_STEALING_MPFR
+
+#include "../../common/dynamic_scheduler.h"
+
+void bbp_dynamic_terms_mpfr(mpfr_t, struct dynamic_scheduler *, int, long);
+
+#endif
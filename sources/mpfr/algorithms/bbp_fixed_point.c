@@ -0,0 +1,61 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <mpfr.h>
+#include <omp.h>
+#include "mpi.h"
+#include "../mpi_operations.h"
+#include "../omp_operations.h"
+#include "../../gmp/algorithms/bbp_fixed_point.h"
+#include "../../common/phase_timer.h"
+
+
+/************************************************************************************
+ * Bailey Borwein Plouffe formula implementation                                    *
+ * This version adds the terms as fixed point integers                              *
+ * The sums are computed with GMP integers, see gmp/algorithms/bbp_fixed_point.c    *
+ * The iterations are distributed cyclically among all the threads of all the       *
+ * processes, as every term is computed without dependencies.                       *
+ *                                                                                  *
+ ************************************************************************************/
+
+
+void bbp_fixed_point_algorithm_mpfr(MPI_Comm comm, int num_procs, int proc_id, mpfr_t pi, long num_iterations, int num_threads, long precision_bits){
+    mpfr_t local_proc_pi;
+
+    init_transport_mpfr(local_proc_pi, precision_bits);
+
+    //Set the number of threads 
+    omp_set_num_threads(num_threads);
+
+    #pragma omp parallel
+    {
+        int thread_id;
+        mp_bitcnt_t bits;
+        mpz_t thread_sum;
+        mpfr_t local_thread_pi;
+
+        thread_id = omp_get_thread_num();
+        mpz_init(thread_sum);
+        mpfr_init2(local_thread_pi, precision_bits);
+
+        mark_phase(SEED_PHASE);
+        //First Phase -> Working on a local fixed point sum
+        bits = bbp_fixed_point_sum_gmp(thread_sum, proc_id * num_threads + thread_id, num_procs * num_threads, 
+                                        num_iterations, precision_bits);
+        mpfr_set_z_2exp(local_thread_pi, thread_sum, - (mpfr_exp_t) bits, MPFR_RNDN);
+
+        //Second Phase -> Accumulate the result in the global variable
+        reduce_threads_mpfr(local_proc_pi, local_thread_pi);
+
+        //Clear memory
+        mpz_clear(thread_sum);
+        mpfr_clear(local_thread_pi);
+    }
+
+    //Reduce local_proc_pi in global Pi
+    reduce_add_mpfr(comm, pi, local_proc_pi, proc_id);
+
+    //Clear memory
+    clear_transport_mpfr(local_proc_pi);
+}
+
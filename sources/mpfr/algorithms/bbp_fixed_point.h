@@ -0,0 +1,7 @@
+#ifndef BBP_FIXED_POINT_MPFR
+#define BBP_FIXED_POINT_MPFR
+
+void bbp_fixed_point_algorithm_mpfr(MPI_Comm, int, int, mpfr_t, long, int, long);
+
+#endif
+
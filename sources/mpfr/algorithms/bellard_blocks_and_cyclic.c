@@ -5,6 +5,15 @@
 #include <math.h>
 #include "mpi.h"
 #include "../mpi_operations.h"
+#include "../omp_operations.h"
+#include "../working_precision.h"
+#include "../seeding.h"
+#include "../../common/checkpoint.h"
+#include "../checkpoint.h"
+#include "../../common/phase_timer.h"
+#include "../../common/progress.h"
+
+#define BITS_PER_TERM 10                // log2(1024)
 
 
 /************************************************************************************
@@ -43,8 +52,8 @@
 /*
  * An iteration of Bellard formula
  */
-void bellard_iteration_mpfr(mpfr_t pi, int n, mpfr_t m, mpfr_t a, mpfr_t b, mpfr_t c, mpfr_t d, 
-                    mpfr_t e, mpfr_t f, mpfr_t g, mpfr_t aux, int dep_a, int dep_b){
+void bellard_iteration_mpfr(mpfr_t pi, long n, mpfr_t m, mpfr_t a, mpfr_t b, mpfr_t c, mpfr_t d, 
+                    mpfr_t e, mpfr_t f, mpfr_t g, mpfr_t aux, long dep_a, long dep_b){
     mpfr_set_ui(a, 32, MPFR_RNDN);              // a = ( 32 / ( 4n + 1))
     mpfr_set_ui(b, 1, MPFR_RNDN);               // b = (  1 / ( 4n + 3))
     mpfr_set_ui(c, 256, MPFR_RNDN);             // c = (256 / (10n + 1))
@@ -76,101 +85,96 @@ void bellard_iteration_mpfr(mpfr_t pi, int n, mpfr_t m, mpfr_t a, mpfr_t b, mpfr
     mpfr_mul(aux, aux, m, MPFR_RNDN);   
 
     mpfr_add(pi, pi, aux, MPFR_RNDN); 
+    add_progress(1);
 }
 
 
-void bellard_blocks_and_cyclic_algorithm_mpfr(int num_procs, int proc_id, mpfr_t pi, int num_iterations, int num_threads, int precision_bits){
-    int block_size, block_start, block_end, position, packet_size, d_elements;
-    mpfr_t local_proc_pi, jump;
+void bellard_blocks_and_cyclic_algorithm_mpfr(MPI_Comm comm, int num_procs, int proc_id, mpfr_t pi, long num_iterations, int num_threads, long precision_bits){
+    long block_size, block_start, block_end;
+    mpfr_t local_proc_pi;
 
     block_size = (num_iterations + num_procs - 1) / num_procs;
     block_start = proc_id * block_size;
     block_end = block_start + block_size;
     if (block_end > num_iterations) block_end = num_iterations;
 
-    mpfr_inits2(precision_bits, jump, local_proc_pi, NULL);
-    mpfr_set_ui(local_proc_pi, 0, MPFR_RNDN);
-    mpfr_set_ui(jump, 1, MPFR_RNDN); 
-    mpfr_div_ui(jump, jump, 1024, MPFR_RNDN);
-    mpfr_pow_ui(jump, jump, num_threads, MPFR_RNDN);
+    init_transport_mpfr(local_proc_pi, precision_bits);
 
     //Set the number of threads 
     omp_set_num_threads(num_threads);
 
     #pragma omp parallel 
     {
-        int thread_id, i, dep_a, dep_b, jump_dep_a, jump_dep_b;
+        int thread_id;
+        long i, dep_a, dep_b, jump_dep_a, jump_dep_b, first_i;
+        mpfr_prec_t working_precision;
         mpfr_t local_thread_pi, dep_m, a, b, c, d, e, f, g, aux;
+        struct checkpoint checkpoint;
 
         thread_id = omp_get_thread_num();
 
         mpfr_init2(local_thread_pi, precision_bits);               // private thread pi
         mpfr_set_ui(local_thread_pi, 0, MPFR_RNDN);
-        dep_a = (block_start + thread_id) * 4;
-        dep_b = (block_start + thread_id) * 10;
-        jump_dep_a = 4 * num_threads;
-        jump_dep_b = 10 * num_threads;
+        first_i = block_start + thread_id;
+        init_checkpoint(&checkpoint, "MPFR-BEL-BLC-CYC", num_procs, proc_id, num_threads, thread_id, num_iterations, precision_bits);
+        load_checkpoint_mpfr(&checkpoint, &first_i, local_thread_pi);
+        dep_a = first_i * 4;
+        dep_b = first_i * 10;
+        jump_dep_a = 4 * (long) num_threads;
+        jump_dep_b = 10 * (long) num_threads;
         mpfr_init2(dep_m, precision_bits);
-        mpfr_set_ui(dep_m, 1, MPFR_RNDN);
-        mpfr_div_ui(dep_m, dep_m, 1024, MPFR_RNDN);
-        mpfr_pow_ui(dep_m, dep_m, block_start + thread_id, MPFR_RNDN);        // dep_m = ((-1)^n)/1024)
-        if((block_start + thread_id) % 2 != 0) mpfr_neg(dep_m, dep_m, MPFR_RNDN);                   
+        seed_bellard_mpfr(dep_m, first_i);                                    // dep_m = ((-1)^n)/1024^n
         mpfr_inits2(precision_bits, a, b, c, d, e, f, g, aux, NULL);
 
+        mark_phase(SEED_PHASE);
         //First Phase -> Working on a local variable
         if(num_threads % 2 != 0){
-            for(i = block_start + thread_id; i < block_end; i+=num_threads){
+            for(i = first_i; i < block_end; i+=num_threads){
+                //Work with the precision needed by the term i
+                working_precision = working_precision_mpfr(precision_bits, BITS_PER_TERM, i);
+                set_working_precision_mpfr(working_precision, a, b, c, d, e, f, g, aux, NULL);
+                round_working_precision_mpfr(working_precision, dep_m, NULL);
                 bellard_iteration_mpfr(local_thread_pi, i, dep_m, a, b, c, d, e, f, g, aux, dep_a, dep_b);
                 // Update dependencies for next iteration:
-                mpfr_mul(dep_m, dep_m, jump, MPFR_RNDN); 
+                mpfr_div_2ui(dep_m, dep_m, 10 * num_threads, MPFR_RNDN);
                 mpfr_neg(dep_m, dep_m, MPFR_RNDN); 
                 dep_a += jump_dep_a;
                 dep_b += jump_dep_b;  
+                if (checkpoint_due(&checkpoint)) save_checkpoint_mpfr(&checkpoint, i + num_threads, local_thread_pi);
             }
         } else {
-            for(i = block_start + thread_id; i < block_end; i+=num_threads){
+            for(i = first_i; i < block_end; i+=num_threads){
+                //Work with the precision needed by the term i
+                working_precision = working_precision_mpfr(precision_bits, BITS_PER_TERM, i);
+                set_working_precision_mpfr(working_precision, a, b, c, d, e, f, g, aux, NULL);
+                round_working_precision_mpfr(working_precision, dep_m, NULL);
                 bellard_iteration_mpfr(local_thread_pi, i, dep_m, a, b, c, d, e, f, g, aux, dep_a, dep_b);
                 // Update dependencies for next iteration:
-                mpfr_mul(dep_m, dep_m, jump, MPFR_RNDN);    
+                mpfr_div_2ui(dep_m, dep_m, 10 * num_threads, MPFR_RNDN);
                 dep_a += jump_dep_a;
                 dep_b += jump_dep_b;  
+                if (checkpoint_due(&checkpoint)) save_checkpoint_mpfr(&checkpoint, i + num_threads, local_thread_pi);
             }
         }
 
         //Second Phase -> Accumulate the result in the global variable
-        #pragma omp critical
-        mpfr_add(local_proc_pi, local_proc_pi, local_thread_pi, MPFR_RNDN);
+        reduce_threads_mpfr(local_proc_pi, local_thread_pi);
 
         //Clear thread memory
         mpfr_free_cache();
         mpfr_clears(local_thread_pi, dep_m, a, b, c, d, e, f, g, aux, NULL);   
     }
 
-    //Create user defined operation
-    MPI_Op add_op;
-    MPI_Op_create((MPI_User_function *)add_mpfr, 0, &add_op);
-
-    //Set buffers for cumunications and position for pack and unpack information
-    d_elements = (int) ceil((float) local_proc_pi -> _mpfr_prec / (float) GMP_NUMB_BITS);
-    packet_size = 8 + sizeof(mpfr_exp_t) + (d_elements * sizeof(mp_limb_t));
-    char recbuffer[packet_size];
-    char sendbuffer[packet_size];
-
-    //Pack local_proc_pi in sendbuffuer
-    position = pack_mpfr(sendbuffer, local_proc_pi);
-
-    //Reduce piLocal
-    MPI_Reduce(sendbuffer, recbuffer, position, MPI_PACKED, add_op, 0, MPI_COMM_WORLD);
+    //Reduce local_proc_pi in global Pi
+    reduce_add_mpfr(comm, pi, local_proc_pi, proc_id);
 
-    //Unpack recbuffer in global Pi and do the last operation
+    //Do the last operations to get Pi
     if (proc_id == 0){
-        unpack_mpfr(recbuffer, pi);
         mpfr_div_ui(pi, pi, 64, MPFR_RNDN);
     }
 
     //Clear memory
-    MPI_Op_free(&add_op);
-    mpfr_clears(local_proc_pi, jump, NULL);       
+    clear_transport_mpfr(local_proc_pi);
 
 }
 
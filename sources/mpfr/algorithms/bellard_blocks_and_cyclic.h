@@ -1,9 +1,9 @@
 #ifndef BELLARD_BLOCKS_AND_CYCLIC_MPFR
 #define BELLARD_BLOCKS_AND_CYCLIC_MPFR
 
-void bellard_blocks_and_cyclic_algorithm_mpfr(int, int, mpfr_t, int, int, int);
+void bellard_blocks_and_cyclic_algorithm_mpfr(MPI_Comm, int, int, mpfr_t, long, int, long);
 
-void bellard_iteration_mpfr(mpfr_t, int, mpfr_t, mpfr_t, mpfr_t, mpfr_t, mpfr_t, mpfr_t, mpfr_t, mpfr_t, mpfr_t, int, int);
+void bellard_iteration_mpfr(mpfr_t, long, mpfr_t, mpfr_t, mpfr_t, mpfr_t, mpfr_t, mpfr_t, mpfr_t, mpfr_t, mpfr_t, long, long);
 
 #endif
 
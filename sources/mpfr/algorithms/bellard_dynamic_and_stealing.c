@@ -0,0 +1,81 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <mpfr.h>
+#include <omp.h>
+#include "mpi.h"
+#include "../working_precision.h"
+#include "../seeding.h"
+#include "../../common/dynamic_scheduler.h"
+#include "../../common/phase_timer.h"
+#include "bellard_blocks_and_cyclic.h"
+
+#define BITS_PER_TERM 10                // log2(1024)
+#define SUM_EXPONENT 7                  // 2^6 pi > 2^7
+
+
+/************************************************************************************
+ * Bellard formula implementation                                                   *
+ * This version distributes the iterations dynamically: processes take chunks of    *
+ * iterations from a shared counter and threads steal work from each other          *
+ * (see common/dynamic_scheduler.c and common/dynamic_schedules.c).                 *
+ *                                                                                  *
+ ************************************************************************************
+ * Bellard formula:                                                                 *
+ *                 (-1)^n     32     1      256     64       4       4       1      *
+ * 2^6 * pi = SUM( ------ [- ---- - ---- + ----- - ----- - ----- - ----- + -----])  *
+ *                 2^10n     4n+1   4n+3   10n+1   10n+3   10n+5   10n+7   10n+9    *
+ *                                                                                  *
+ ************************************************************************************
+ * Seed of the dependencies at the start of a chunk:                                *
+ *                                                                                  *
+ *              dep_m(n) = (-1)^n 2^-10n      (only the exponent and sign are set)  *
+ *              dep_a(n) = 4n                                                       *
+ *              dep_b(n) = 10n                                                      *
+ *                                                                                  *
+ ************************************************************************************/
+
+
+/*
+ * Adds to local_thread_pi the terms of the chunks given to the thread thread_id by the
+ * scheduler, with precision_bits. The sum is 2^6 pi.
+ */
+void bellard_dynamic_terms_mpfr(mpfr_t local_thread_pi, struct dynamic_scheduler *scheduler, int thread_id, long precision_bits){
+    long i, chunk_start, chunk_end, previous_end, dep_a, dep_b;
+    mpfr_prec_t working_precision;
+    mpfr_t dep_m, a, b, c, d, e, f, g, aux;
+
+    mpfr_inits2(precision_bits, dep_m, a, b, c, d, e, f, g, aux, NULL);
+    previous_end = -1;
+    dep_a = dep_b = 0;                  // seeded with the first chunk
+
+    mark_phase(SEED_PHASE);
+    while (next_chunk(scheduler, thread_id, &chunk_start, &chunk_end)) {
+        if (chunk_start != previous_end) {
+            //Seed dep_m = (-1)^n / 1024^n, dep_a = 4n and dep_b = 10n
+            working_precision = working_precision_mpfr(precision_bits, BITS_PER_TERM, chunk_start);
+            set_working_precision_mpfr(working_precision, dep_m, NULL);
+            seed_bellard_mpfr(dep_m, chunk_start);
+            dep_a = chunk_start * 4;
+            dep_b = chunk_start * 10;
+        }
+        for (i = chunk_start; i < chunk_end; i++) {
+            //Work with the precision needed by the term i
+            working_precision = working_precision_mpfr(precision_bits, BITS_PER_TERM, i);
+            set_working_precision_mpfr(working_precision, a, b, c, d, e, f, g, aux, NULL);
+            round_working_precision_mpfr(working_precision, dep_m, NULL);
+            bellard_iteration_mpfr(local_thread_pi, i, dep_m, a, b, c, d, e, f, g, aux, dep_a, dep_b);
+            report_term_exponent(scheduler, i, mpfr_get_exp(aux) - SUM_EXPONENT);
+            // Update dependencies for next iteration:
+            mpfr_div_2ui(dep_m, dep_m, 10, MPFR_RNDN);
+            mpfr_neg(dep_m, dep_m, MPFR_RNDN);
+            dep_a += 4;
+            dep_b += 10;
+        }
+        previous_end = chunk_end;
+    }
+
+    //Clear memory
+    mpfr_free_cache();
+    mpfr_clears(dep_m, a, b, c, d, e, f, g, aux, NULL);
+}
+
@@ -0,0 +1,8 @@
+#ifndef BELLARD_DYNAMIC_AND_STEALING_MPFR
+#define BELLARD_DYNAMIC_AND_STEALING_MPFR
+
+#include "../../common/dynamic_scheduler.h"
+
+void bellard_dynamic_terms_mpfr(mpfr_t, struct dynamic_scheduler *, int, long);
+
+#endif
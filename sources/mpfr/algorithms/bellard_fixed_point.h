@@ -0,0 +1,7 @@
+#ifndef BELLARD_FIXED_POINT_MPFR
+#define BELLARD_FIXED_POINT_MPFR
+
+void bellard_fixed_point_algorithm_mpfr(MPI_Comm, int, int, mpfr_t, long, int, long);
+
+#endif
+
@@ -6,6 +6,8 @@
 #include "mpi.h"
 #include "bellard_blocks_and_cyclic.h"
 #include "../mpi_operations.h"
+#include "../omp_operations.h"
+#include "../../common/phase_timer.h"
 
 
 /************************************************************************************
@@ -41,9 +43,9 @@
  ************************************************************************************/
 
 
-void bellard_slow_blocks_and_cyclic_algorithm_mpfr(int num_procs, int proc_id, mpfr_t pi, 
-                                int num_iterations, int num_threads, int precision_bits){
-    int block_size, block_start, block_end, position, packet_size, d_elements;
+void bellard_slow_blocks_and_cyclic_algorithm_mpfr(MPI_Comm comm, int num_procs, int proc_id, mpfr_t pi, 
+                                long num_iterations, int num_threads, long precision_bits){
+    long block_size, block_start, block_end;
     mpfr_t local_proc_pi, ONE;
 
     block_size = (num_iterations + num_procs - 1) / num_procs;
@@ -51,8 +53,8 @@ void bellard_slow_blocks_and_cyclic_algorithm_mpfr(int num_procs, int proc_id, m
     block_end = block_start + block_size;
     if (block_end > num_iterations) block_end = num_iterations;
 
-    mpfr_inits2(precision_bits, ONE, local_proc_pi, NULL);
-    mpfr_set_ui(local_proc_pi, 0, MPFR_RNDN);
+    init_transport_mpfr(local_proc_pi, precision_bits);
+    mpfr_inits2(precision_bits, ONE, NULL);
     mpfr_set_ui(ONE, 1, MPFR_RNDN); 
 
     //Set the number of threads 
@@ -60,7 +62,8 @@ void bellard_slow_blocks_and_cyclic_algorithm_mpfr(int num_procs, int proc_id, m
 
     #pragma omp parallel 
     {
-        int thread_id, i, dep_a, dep_b, jump_dep_a, jump_dep_b, next_i;
+        int thread_id;
+        long i, dep_a, dep_b, jump_dep_a, jump_dep_b, next_i;
         mpfr_t local_thread_pi, dep_m, a, b, c, d, e, f, g, aux;
 
         thread_id = omp_get_thread_num();
@@ -69,14 +72,15 @@ void bellard_slow_blocks_and_cyclic_algorithm_mpfr(int num_procs, int proc_id, m
         mpfr_set_ui(local_thread_pi, 0, MPFR_RNDN);
         dep_a = (block_start + thread_id) * 4;
         dep_b = (block_start + thread_id) * 10;
-        jump_dep_a = 4 * num_threads;
-        jump_dep_b = 10 * num_threads;
+        jump_dep_a = 4 * (long) num_threads;
+        jump_dep_b = 10 * (long) num_threads;
         mpfr_init2(dep_m, precision_bits);
         mpfr_mul_2exp(dep_m, ONE, 10 * (block_start + thread_id), MPFR_RNDN);
         mpfr_div(dep_m, ONE, dep_m, MPFR_RNDN);
         if((thread_id + block_start) % 2 != 0) mpfr_neg(dep_m, dep_m, MPFR_RNDN);                 
         mpfr_inits2(precision_bits, a, b, c, d, e, f, g, aux, NULL);
 
+        mark_phase(SEED_PHASE);
         //First Phase -> Working on a local variable
         for(i = block_start + thread_id; i < block_end; i+=num_threads){
             bellard_iteration_mpfr(local_thread_pi, i, dep_m, a, b, c, d, e, f, g, aux, dep_a, dep_b);
@@ -90,39 +94,24 @@ void bellard_slow_blocks_and_cyclic_algorithm_mpfr(int num_procs, int proc_id, m
         }
 
         //Second Phase -> Accumulate the result in the global variable
-        #pragma omp critical
-        mpfr_add(local_proc_pi, local_proc_pi, local_thread_pi, MPFR_RNDN);
+        reduce_threads_mpfr(local_proc_pi, local_thread_pi);
 
         //Clear thread memory
         mpfr_free_cache();
         mpfr_clears(local_thread_pi, dep_m, a, b, c, d, e, f, g, aux, NULL);   
     }
 
-    //Create user defined operation
-    MPI_Op add_op;
-    MPI_Op_create((MPI_User_function *)add_mpfr, 0, &add_op);
+    //Reduce local_proc_pi in global Pi
+    reduce_add_mpfr(comm, pi, local_proc_pi, proc_id);
 
-    //Set buffers for cumunications and position for pack and unpack information
-    d_elements = (int) ceil((float) local_proc_pi -> _mpfr_prec / (float) GMP_NUMB_BITS);
-    packet_size = 8 + sizeof(mpfr_exp_t) + (d_elements * sizeof(mp_limb_t));
-    char recbuffer[packet_size];
-    char sendbuffer[packet_size];
-
-    //Pack local_proc_pi in sendbuffuer
-    position = pack_mpfr(sendbuffer, local_proc_pi);
-
-    //Reduce piLocal
-    MPI_Reduce(sendbuffer, recbuffer, position, MPI_PACKED, add_op, 0, MPI_COMM_WORLD);
-
-    //Unpack recbuffer in global Pi and do the last operation
+    //Do the last operations to get Pi
     if (proc_id == 0){
-        unpack_mpfr(recbuffer, pi);
         mpfr_div_ui(pi, pi, 64, MPFR_RNDN);
     }
 
     //Clear memory
-    MPI_Op_free(&add_op);
-    mpfr_clears(local_proc_pi, ONE, NULL);       
+    clear_transport_mpfr(local_proc_pi);
+    mpfr_clears(ONE, NULL);       
 
 }
 
@@ -1,7 +1,7 @@
 #ifndef BELLARD_SLOW_BLOCKS_AND_CYCLIC_MPFR
 #define BELLARD_SLOW_BLOCKS_AND_CYCLIC_MPFR
 
-void bellard_slow_blocks_and_cyclic_algorithm_mpfr(int, int, mpfr_t, int, int, int);
+void bellard_slow_blocks_and_cyclic_algorithm_mpfr(MPI_Comm, int, int, mpfr_t, long, int, long);
 
 #endif
 
@@ -0,0 +1,53 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <mpfr.h>
+#include <omp.h>
+#include "mpi.h"
+#include "../../gmp/algorithms/chudnovsky_binary_splitting.h"
+#include "../parallel_arithmetic.h"
+
+#define D 426880
+#define E 10005
+
+
+/************************************************************************************
+ * Chudnovsky formula implementation                                                *
+ * This version computes the series with integer binary splitting                   *
+ * The (P, Q, T) triples are computed with GMP integers, see                        *
+ * gmp/algorithms/chudnovsky_binary_splitting.c                                     *
+ * This version allows computing Pi using processes and threads in hybrid way.      *
+ *                                                                                  *
+ ************************************************************************************
+ *                 426880 sqrt(10005) Q(0, N)                                       *
+ *          pi = ----------------------------                                       *
+ *                        T(0, N)                                                   *
+ *                                                                                  *
+ ************************************************************************************/
+
+
+void chudnovsky_binary_splitting_algorithm_mpfr(MPI_Comm comm, int num_procs, int proc_id, mpfr_t pi, long num_iterations, int num_threads, long precision_bits){
+    mpz_t P, Q, T;
+    mpfr_t e, aux;
+    struct sqrt_constant_mpfr constant;
+
+    mpz_inits(P, Q, T, NULL);
+    if (proc_id == 0) start_sqrt_constant_mpfr(&constant, D, E, precision_bits);   // e = D sqrt(E) in parallel
+
+    chudnovsky_binary_splitting_pqt_gmp(comm, num_procs, proc_id, P, Q, T, num_iterations, num_threads);
+
+    //Do the last operations to get Pi: one product and one division
+    if (proc_id == 0){
+        mpfr_inits2(precision_bits, e, aux, NULL);
+        wait_sqrt_constant_mpfr(e, &constant);
+        mpfr_set_z(aux, Q, MPFR_RNDN);
+        parallel_mul_mpfr(e, e, aux, num_threads);
+        mpfr_set_z(aux, T, MPFR_RNDN);
+        parallel_div_mpfr(pi, e, aux, num_threads);
+        mpfr_clears(e, aux, NULL);
+    }
+
+    //Clear process memory
+    mpz_clears(P, Q, T, NULL);
+}
+
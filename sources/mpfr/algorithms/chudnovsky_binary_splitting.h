@@ -0,0 +1,7 @@
+#ifndef CHUDNOVSKY_BINARY_SPLITTING_MPFR
+#define CHUDNOVSKY_BINARY_SPLITTING_MPFR
+
+void chudnovsky_binary_splitting_algorithm_mpfr(MPI_Comm, int, int, mpfr_t, long, int, long);
+
+#endif
+
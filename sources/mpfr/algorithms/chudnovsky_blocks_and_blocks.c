@@ -5,12 +5,23 @@
 #include <math.h>
 #include "mpi.h"
 #include "../mpi_operations.h"
+#include "../omp_operations.h"
+#include "../working_precision.h"
+#include "../seeding.h"
+#include "../parallel_arithmetic.h"
+#include "../../common/options.h"
+#include "../../common/checkpoint.h"
+#include "../checkpoint.h"
+#include "../../common/phase_timer.h"
+#include "../../common/progress.h"
+#include "chudnovsky_rational_blocks.h"
 
 #define A 13591409
 #define B 545140134
 #define C 640320
 #define D 426880
 #define E 10005
+#define BITS_PER_TERM 47.11             // log2(640320^3 / 12^3)
 
 
 /************************************************************************************
@@ -46,52 +57,28 @@
 /*
  * An iteration of Chudnovsky formula
  */
-void chudnovsky_iteration_mpfr(mpfr_t pi, int n, mpfr_t dep_a, mpfr_t dep_b, mpfr_t dep_c, mpfr_t aux){
+void chudnovsky_iteration_mpfr(mpfr_t pi, long n, mpfr_t dep_a, mpfr_t dep_b, mpfr_t dep_c, mpfr_t aux){
     mpfr_mul(aux, dep_a, dep_c, MPFR_RNDN);
     mpfr_div(aux, aux, dep_b, MPFR_RNDN);
     
     mpfr_add(pi, pi, aux, MPFR_RNDN);
+    add_progress(1);
 }
 
-/*
- * This method is used by Chudnovsky_algorithm_MPI threads
- * for computing the first value of dep_a
- */
-void init_dep_a_mpfr(mpfr_t dep_a, int block_start, int precision_bits){
-    mpz_t factorial_n, dividend, divisor;
-    mpfr_t float_dividend, float_divisor;
-    mpz_inits(factorial_n, dividend, divisor, NULL);
-    mpfr_inits2(precision_bits ,float_dividend, float_divisor, NULL);
-
-    mpz_fac_ui(factorial_n, block_start);
-    mpz_fac_ui(divisor, 3 * block_start);
-    mpz_fac_ui(dividend, 6 * block_start);
-
-    mpz_pow_ui(factorial_n, factorial_n, 3);
-    mpz_mul(divisor, divisor, factorial_n);
 
-    mpfr_set_z(float_dividend, dividend, MPFR_RNDN);
-    mpfr_set_z(float_divisor, divisor, MPFR_RNDN);
-
-    mpfr_div(dep_a, float_dividend, float_divisor, MPFR_RNDN);
-
-    mpz_clears(factorial_n, dividend, divisor, NULL);
-    mpfr_clears(float_dividend, float_divisor, NULL);
-}
-
-
-void chudnovsky_blocks_and_blocks_algorithm_mpfr(int num_procs, int proc_id, mpfr_t pi, int num_iterations, int num_threads, int precision_bits){
-    int block_size, block_start, block_end, position, packet_size, d_elements;
+void chudnovsky_blocks_and_blocks_algorithm_mpfr(MPI_Comm comm, int num_procs, int proc_id, mpfr_t pi, long num_iterations, int num_threads, long precision_bits){
+    long block_size, block_start, block_end;
     mpfr_t local_proc_pi, e, c;
+    struct sqrt_constant_mpfr constant;
 
     block_size = (num_iterations + num_procs - 1) / num_procs;
     block_start = proc_id * block_size;
     block_end = block_start + block_size;
     if (block_end > num_iterations) block_end = num_iterations;
 
-    mpfr_inits2(precision_bits, local_proc_pi, e, c, NULL);
-    mpfr_set_ui(local_proc_pi, 0, MPFR_RNDN);
-    mpfr_set_ui(e, E, MPFR_RNDN); 
+    init_transport_mpfr(local_proc_pi, precision_bits);
+    mpfr_inits2(precision_bits, e, c, NULL);
+    if (proc_id == 0) start_sqrt_constant_mpfr(&constant, D, E, precision_bits);   // e = D sqrt(E) in parallel
     mpfr_set_ui(c, C, MPFR_RNDN); 
     mpfr_neg(c, c, MPFR_RNDN);
     mpfr_pow_ui(c, c, 3, MPFR_RNDN);
@@ -101,8 +88,11 @@ void chudnovsky_blocks_and_blocks_algorithm_mpfr(int num_procs, int proc_id, mpf
 
     #pragma omp parallel 
     {
-        int thread_id, i, thread_block_size, thread_block_start, thread_block_end, factor_a;
+        int thread_id;
+        long i, thread_block_size, thread_block_start, thread_block_end, factor_a;
+        mpfr_prec_t working_precision;
         mpfr_t local_thread_pi, dep_a, dep_a_dividend, dep_a_divisor, dep_b, dep_c, aux;
+        struct checkpoint checkpoint;
 
         thread_id = omp_get_thread_num();
         thread_block_size = (block_size + num_threads - 1) / num_threads;
@@ -112,71 +102,66 @@ void chudnovsky_blocks_and_blocks_algorithm_mpfr(int num_procs, int proc_id, mpf
 
         mpfr_init2(local_thread_pi, precision_bits);    // private thread pi
         mpfr_set_ui(local_thread_pi, 0, MPFR_RNDN);
+        if (options.block_terms == 1) {
+            init_checkpoint(&checkpoint, "MPFR-CHD-SME-BLC-BLC", num_procs, proc_id, num_threads, thread_id, num_iterations, precision_bits);
+            load_checkpoint_mpfr(&checkpoint, &thread_block_start, local_thread_pi);
+        }
         mpfr_inits2(precision_bits, dep_a, dep_b, dep_c, dep_a_dividend, dep_a_divisor, aux, NULL);
-        init_dep_a_mpfr(dep_a, thread_block_start, precision_bits);
-        mpfr_pow_ui(dep_b, c, thread_block_start, MPFR_RNDN);
-        mpfr_set_ui(dep_c, B, MPFR_RNDN);
-        mpfr_mul_ui(dep_c, dep_c, thread_block_start, MPFR_RNDN);
-        mpfr_add_ui(dep_c, dep_c, A, MPFR_RNDN);
+        seed_chudnovsky_mpfr(dep_a, dep_b, dep_c, thread_block_start);
         factor_a = 12 * thread_block_start;
 
 
+        mark_phase(SEED_PHASE);
         //First Phase -> Working on a local variable        
-        for(i = thread_block_start; i < thread_block_end; i++){
-            chudnovsky_iteration_mpfr(local_thread_pi, i, dep_a, dep_b, dep_c, aux);
-            //Update dep_a:
-            mpfr_set_ui(dep_a_dividend, factor_a + 10, MPFR_RNDN);
-            mpfr_mul_ui(dep_a_dividend, dep_a_dividend, factor_a + 6, MPFR_RNDN);
-            mpfr_mul_ui(dep_a_dividend, dep_a_dividend, factor_a + 2, MPFR_RNDN);
-            mpfr_mul(dep_a_dividend, dep_a_dividend, dep_a, MPFR_RNDN);
-
-            mpfr_set_ui(dep_a_divisor, i + 1, MPFR_RNDN);
-            mpfr_pow_ui(dep_a_divisor, dep_a_divisor , 3, MPFR_RNDN);
-            mpfr_div(dep_a, dep_a_dividend, dep_a_divisor, MPFR_RNDN);
-            factor_a += 12;
-
-            //Update dep_b:
-            mpfr_mul(dep_b, dep_b, c, MPFR_RNDN);
-
-            //Update dep_c:
-            mpfr_add_ui(dep_c, dep_c, B, MPFR_RNDN);
+        if (options.block_terms > 1) {
+            mpfr_div(dep_a, dep_a, dep_b, MPFR_RNDN);     // x = dep_a / dep_b
+            chudnovsky_rational_blocks_mpfr(local_thread_pi, dep_a, thread_block_start, thread_block_end, options.block_terms, precision_bits);
+        } else {
+            for(i = thread_block_start; i < thread_block_end; i++){
+                //Work with the precision needed by the term i
+                working_precision = working_precision_mpfr(precision_bits, BITS_PER_TERM, i);
+                set_working_precision_mpfr(working_precision, dep_a_dividend, dep_a_divisor, aux, NULL);
+                round_working_precision_mpfr(working_precision, dep_a, dep_b, dep_c, NULL);
+                chudnovsky_iteration_mpfr(local_thread_pi, i, dep_a, dep_b, dep_c, aux);
+                //Update dep_a:
+                mpfr_set_ui(dep_a_dividend, factor_a + 10, MPFR_RNDN);
+                mpfr_mul_ui(dep_a_dividend, dep_a_dividend, factor_a + 6, MPFR_RNDN);
+                mpfr_mul_ui(dep_a_dividend, dep_a_dividend, factor_a + 2, MPFR_RNDN);
+                mpfr_mul(dep_a_dividend, dep_a_dividend, dep_a, MPFR_RNDN);
+
+                mpfr_set_ui(dep_a_divisor, i + 1, MPFR_RNDN);
+                mpfr_pow_ui(dep_a_divisor, dep_a_divisor , 3, MPFR_RNDN);
+                mpfr_div(dep_a, dep_a_dividend, dep_a_divisor, MPFR_RNDN);
+                factor_a += 12;
+
+                //Update dep_b:
+                mpfr_mul(dep_b, dep_b, c, MPFR_RNDN);
+
+                //Update dep_c:
+                mpfr_add_ui(dep_c, dep_c, B, MPFR_RNDN);
+                if (checkpoint_due(&checkpoint)) save_checkpoint_mpfr(&checkpoint, i + 1, local_thread_pi);
+            }
         }
 
         //Second Phase -> Accumulate the result in the global variable
-        #pragma omp critical
-        mpfr_add(local_proc_pi, local_proc_pi, local_thread_pi, MPFR_RNDN);
+        reduce_threads_mpfr(local_proc_pi, local_thread_pi);
 
         //Clear thread memory
         mpfr_free_cache();
         mpfr_clears(local_thread_pi, dep_a, dep_a_dividend, dep_a_divisor, dep_b, dep_c, aux, NULL); 
     }
 
-     //Create user defined operation
-    MPI_Op add_op;
-    MPI_Op_create((MPI_User_function *)add_mpfr, 0, &add_op);
-
-    //Set buffers for cumunications and position for pack and unpack information
-    d_elements = (int) ceil((float) local_proc_pi -> _mpfr_prec / (float) GMP_NUMB_BITS);
-    packet_size = 8 + sizeof(mpfr_exp_t) + (d_elements * sizeof(mp_limb_t));
-    char recbuffer[packet_size];
-    char sendbuffer[packet_size];
-
-    //Pack local_proc_pi in sendbuffuer
-    position = pack_mpfr(sendbuffer, local_proc_pi);
-
-    //Reduce piLocal
-    MPI_Reduce(sendbuffer, recbuffer, position, MPI_PACKED, add_op, 0, MPI_COMM_WORLD);
+    //Reduce local_proc_pi in global Pi
+    reduce_add_mpfr(comm, pi, local_proc_pi, proc_id);
 
-    //Unpack recbuffer in global Pi and do the last operation
+    //Do the last operations to get Pi
     if (proc_id == 0){
-        unpack_mpfr(recbuffer, pi);
-        mpfr_sqrt(e, e, MPFR_RNDN);
-        mpfr_mul_ui(e, e, D, MPFR_RNDN);
-        mpfr_div(pi, e, pi, MPFR_RNDN); 
+        wait_sqrt_constant_mpfr(e, &constant);
+        parallel_div_mpfr(pi, e, pi, num_threads);
     }
 
     //Clear memory
-    MPI_Op_free(&add_op);
-    mpfr_clears(local_proc_pi, e, c, NULL);       
+    clear_transport_mpfr(local_proc_pi);
+    mpfr_clears(e, c, NULL);       
 
 }
\ No newline at end of file
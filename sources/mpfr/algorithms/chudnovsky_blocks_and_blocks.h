@@ -1,7 +1,9 @@
 #ifndef CHUDNOVSKY_BLOCKS_AND_BLOCKS_MPFR
 #define CHUDNOVSKY_BLOCKS_AND_BLOCKS_MPFR
 
-void chudnovsky_blocks_and_blocks_algorithm_mpfr(int, int, mpfr_t, int, int, int);
+void chudnovsky_blocks_and_blocks_algorithm_mpfr(MPI_Comm, int, int, mpfr_t, long, int, long);
+
+void chudnovsky_iteration_mpfr(mpfr_t, long, mpfr_t, mpfr_t, mpfr_t, mpfr_t);
 
 #endif
 
@@ -0,0 +1,115 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <mpfr.h>
+#include <omp.h>
+#include "mpi.h"
+#include "../working_precision.h"
+#include "../seeding.h"
+#include "../../common/options.h"
+#include "../../common/dynamic_scheduler.h"
+#include "../../common/phase_timer.h"
+#include "chudnovsky_rational_blocks.h"
+#include "chudnovsky_blocks_and_blocks.h"
+
+#define A 13591409
+#define B 545140134
+#define C 640320
+#define BITS_PER_TERM 47.11             // log2(640320^3 / 12^3)
+#define SUM_EXPONENT 23                 // the sum is greater than its first term 13591409 > 2^23
+
+
+/************************************************************************************
+ * Chudnovsky formula implementation                                                *
+ * This version distributes the iterations dynamically: processes take chunks of    *
+ * iterations from a shared counter and threads steal work from each other          *
+ * (see common/dynamic_scheduler.c and common/dynamic_schedules.c).                 *
+ *                                                                                  *
+ ************************************************************************************
+ * Chudnovsky formula:                                                              *
+ *     426880 sqrt(10005)                 (6n)! (545140134n + 13591409)             *
+ *    --------------------  = SUMMATORY( ----------------------------- ),  n >=0    *
+ *            pi                            (n!)^3 (3n)! (-640320)^3n               *
+ *                                                                                  *
+ ************************************************************************************
+ * Chudnovsky formula dependencies:                                                 *
+ *                     (6n)!         (12n + 10)(12n + 6)(12n + 2)                   *
+ *      dep_a(n) = --------------- = ---------------------------- * dep_a(n-1)      *
+ *                 ((n!)^3 (3n)!)              (n + 1)^3                            *
+ *                                                                                  *
+ *      dep_b(n) = (-640320)^3n = (-640320)^3(n-1) * (-640320)^3)                   *
+ *                                                                                  *
+ *      dep_c(n) = (545140134n + 13591409) = dep_c(n - 1) + 545140134               *
+ *                                                                                  *
+ * They are only seeded with their closed form when a chunk does not start where    *
+ * the previous chunk of the thread ended.                                          *
+ *                                                                                  *
+ ************************************************************************************/
+
+
+/*
+ * Adds to local_thread_pi the terms of the chunks given to the thread thread_id by the
+ * scheduler, with precision_bits. Pi is 426880 sqrt(10005) divided by the sum.
+ */
+void chudnovsky_dynamic_terms_mpfr(mpfr_t local_thread_pi, struct dynamic_scheduler *scheduler, int thread_id, long precision_bits){
+    long i, chunk_start, chunk_end, previous_end, factor_a, block_start, block_end;
+    mpfr_prec_t working_precision;
+    mpfr_t dep_a, dep_a_dividend, dep_a_divisor, dep_b, dep_c, c, aux;
+
+    mpfr_inits2(precision_bits, dep_a, dep_b, dep_c, dep_a_dividend, dep_a_divisor, c, aux, NULL);
+    mpfr_set_si(c, -C, MPFR_RNDN);
+    mpfr_pow_ui(c, c, 3, MPFR_RNDN);
+    previous_end = -1;
+    factor_a = 0;                       // seeded with the first chunk
+
+    mark_phase(SEED_PHASE);
+    while (next_chunk(scheduler, thread_id, &chunk_start, &chunk_end)) {
+        if (chunk_start != previous_end) {
+            //Seed dep_a, dep_b and dep_c
+            working_precision = working_precision_mpfr(precision_bits, BITS_PER_TERM, chunk_start);
+            set_working_precision_mpfr(working_precision, dep_a, dep_b, dep_c, NULL);
+            seed_chudnovsky_mpfr(dep_a, dep_b, dep_c, chunk_start);
+            if (options.block_terms > 1) mpfr_div(dep_a, dep_a, dep_b, MPFR_RNDN);     // x = dep_a / dep_b
+            factor_a = 12 * chunk_start;
+        }
+        if (options.block_terms > 1) {
+            for (block_start = chunk_start; block_start < chunk_end; block_start = block_end) {
+                block_end = (chunk_end - block_start < options.block_terms) ? chunk_end : block_start + options.block_terms;
+                chudnovsky_rational_blocks_mpfr(local_thread_pi, dep_a, block_start, block_end, options.block_terms, precision_bits);
+                //dep_a is x(block_end), so the term block_end is dep_a dep_c(block_end)
+                mpfr_mul_ui(aux, dep_a, (unsigned long) B * block_end + A, MPFR_RNDN);
+                report_term_exponent(scheduler, block_end, mpfr_get_exp(aux) - SUM_EXPONENT);
+            }
+        } else {
+            for (i = chunk_start; i < chunk_end; i++) {
+                //Work with the precision needed by the term i
+                working_precision = working_precision_mpfr(precision_bits, BITS_PER_TERM, i);
+                set_working_precision_mpfr(working_precision, dep_a_dividend, dep_a_divisor, aux, NULL);
+                round_working_precision_mpfr(working_precision, dep_a, dep_b, dep_c, NULL);
+                chudnovsky_iteration_mpfr(local_thread_pi, i, dep_a, dep_b, dep_c, aux);
+                report_term_exponent(scheduler, i, mpfr_get_exp(aux) - SUM_EXPONENT);
+                //Update dep_a:
+                mpfr_set_ui(dep_a_dividend, factor_a + 10, MPFR_RNDN);
+                mpfr_mul_ui(dep_a_dividend, dep_a_dividend, factor_a + 6, MPFR_RNDN);
+                mpfr_mul_ui(dep_a_dividend, dep_a_dividend, factor_a + 2, MPFR_RNDN);
+                mpfr_mul(dep_a_dividend, dep_a_dividend, dep_a, MPFR_RNDN);
+
+                mpfr_set_ui(dep_a_divisor, i + 1, MPFR_RNDN);
+                mpfr_pow_ui(dep_a_divisor, dep_a_divisor, 3, MPFR_RNDN);
+                mpfr_div(dep_a, dep_a_dividend, dep_a_divisor, MPFR_RNDN);
+                factor_a += 12;
+
+                //Update dep_b:
+                mpfr_mul(dep_b, dep_b, c, MPFR_RNDN);
+
+                //Update dep_c:
+                mpfr_add_ui(dep_c, dep_c, B, MPFR_RNDN);
+            }
+        }
+        previous_end = chunk_end;
+    }
+
+    //Clear memory
+    mpfr_free_cache();
+    mpfr_clears(dep_a, dep_a_dividend, dep_a_divisor, dep_b, dep_c, c, aux, NULL);
+}
+
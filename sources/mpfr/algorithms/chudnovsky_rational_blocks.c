@@ -0,0 +1,57 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <gmp.h>
+#include <mpfr.h>
+#include "../working_precision.h"
+#include "../../gmp/algorithms/chudnovsky_rational_blocks.h"
+#include "../../common/progress.h"
+
+#define BITS_PER_TERM 47.11             // log2(640320^3 / 12^3)
+
+
+/************************************************************************************
+ * Chudnovsky formula evaluated in blocks of k terms                                *
+ * The exact rationals of the blocks are computed with GMP integers, see            *
+ * gmp/algorithms/chudnovsky_rational_blocks.c                                      *
+ *                                                                                  *
+ ************************************************************************************/
+
+
+/*
+ * Adds the terms [start, end) to pi in blocks of block_terms terms.
+ * x should be x(start) = dep_a(start) / dep_b(start) and it is left as x(end).
+ */
+void chudnovsky_rational_blocks_mpfr(mpfr_t pi, mpfr_t x, long start, long end, int block_terms, long precision_bits){
+    long n;
+    int k;
+    mpfr_prec_t working_precision;
+    mpz_t numerator, denominator, product;
+    mpfr_t y;
+
+    mpz_inits(numerator, denominator, product, NULL);
+    mpfr_init2(y, precision_bits);
+
+    for (n = start; n < end; n += k) {
+        k = (end - n < block_terms) ? (int) (end - n) : block_terms;
+        //Work with the precision needed by the first term of the block
+        working_precision = working_precision_mpfr(precision_bits, BITS_PER_TERM, n);
+        set_working_precision_mpfr(working_precision, y, NULL);
+        round_working_precision_mpfr(working_precision, x, NULL);
+        chudnovsky_rational_block_gmp(numerator, denominator, product, n, k);
+
+        // y = x / denominator
+        mpfr_div_z(y, x, denominator, MPFR_RNDN);
+
+        // pi = pi + y * numerator
+        mpfr_mul_z(x, y, numerator, MPFR_RNDN);
+        mpfr_add(pi, pi, x, MPFR_RNDN);
+
+        // x = y * product
+        mpfr_mul_z(x, y, product, MPFR_RNDN);
+        add_progress(k);
+    }
+
+    mpz_clears(numerator, denominator, product, NULL);
+    mpfr_clear(y);
+}
+
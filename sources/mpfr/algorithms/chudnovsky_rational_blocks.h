@@ -0,0 +1,7 @@
+#ifndef CHUDNOVSKY_RATIONAL_BLOCKS_MPFR
+#define CHUDNOVSKY_RATIONAL_BLOCKS_MPFR
+
+void chudnovsky_rational_blocks_mpfr(mpfr_t, mpfr_t, long, long, int, long);
+
+#endif
+
@@ -0,0 +1,71 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <mpfr.h>
+#include <omp.h>
+#include "mpi.h"
+#include "../parallel_arithmetic.h"
+#include "../../common/progress.h"
+
+
+/************************************************************************************
+ * Gauss-Legendre algorithm implementation                                          *
+ * The arithmetic-geometric mean converges quadratically, so there are only a few   *
+ * iterations and all of them depend on the previous one. The parallelism is in     *
+ * the products and square roots of full precision (see parallel_arithmetic.c),     *
+ * which are split among the threads of process 0.                                  *
+ *                                                                                  *
+ ************************************************************************************
+ * Gauss-Legendre algorithm:                                                        *
+ *                                                                                  *
+ *   a(0) = 1,   b(0) = 1 / sqrt(2),   t(0) = 1 / 4,   p(0) = 1                     *
+ *                                                                                  *
+ *             a(n) + b(n)                                                          *
+ *   a(n+1) = -------------,   b(n+1) = sqrt(a(n) b(n)),                            *
+ *                  2                                                               *
+ *                                                                                  *
+ *   t(n+1) = t(n) - p(n) (a(n) - a(n+1))^2,   p(n+1) = 2 p(n)                      *
+ *                                                                                  *
+ *             (a(n) + b(n))^2                                                      *
+ *   pi ~= -----------------                                                        *
+ *                4 t(n)                                                            *
+ *                                                                                  *
+ ************************************************************************************/
+
+
+void gauss_legendre_algorithm_mpfr(MPI_Comm comm, int num_procs, int proc_id, mpfr_t pi, long num_iterations, int num_threads, long precision_bits){
+    int i;
+    mpfr_t a, b, t, next_a, aux;
+
+    (void) comm;
+    (void) num_procs;
+
+    //The iterations are not distributed among the processes
+    if (proc_id != 0) return;
+
+    mpfr_inits2(precision_bits, a, b, t, next_a, aux, NULL);
+    mpfr_set_ui(a, 1, MPFR_RNDN);
+    mpfr_set_d(aux, 0.5, MPFR_RNDN);
+    parallel_sqrt_mpfr(b, aux, num_threads);                // b = sqrt(1/2)
+    mpfr_set_d(t, 0.25, MPFR_RNDN);
+
+    for (i = 0; i < num_iterations; i++) {
+        mpfr_add(next_a, a, b, MPFR_RNDN);
+        mpfr_div_2ui(next_a, next_a, 1, MPFR_RNDN);         // next_a = (a + b) / 2
+        parallel_mul_mpfr(aux, a, b, num_threads);
+        parallel_sqrt_mpfr(b, aux, num_threads);            // b = sqrt(a b)
+        mpfr_sub(aux, a, next_a, MPFR_RNDN);
+        parallel_mul_mpfr(aux, aux, aux, num_threads);
+        mpfr_mul_2ui(aux, aux, i, MPFR_RNDN);
+        mpfr_sub(t, t, aux, MPFR_RNDN);                     // t = t - p (a - next_a)^2
+        mpfr_swap(a, next_a);
+        add_progress(1);
+    }
+
+    mpfr_add(aux, a, b, MPFR_RNDN);
+    parallel_mul_mpfr(aux, aux, aux, num_threads);
+    mpfr_div_2ui(aux, aux, 2, MPFR_RNDN);
+    mpfr_div(pi, aux, t, MPFR_RNDN);                        // pi = (a + b)^2 / 4t
+
+    mpfr_clears(a, b, t, next_a, aux, NULL);
+}
+
@@ -0,0 +1,7 @@
+#ifndef GAUSS_LEGENDRE_MPFR
+#define GAUSS_LEGENDRE_MPFR
+
+void gauss_legendre_algorithm_mpfr(MPI_Comm, int, int, mpfr_t, long, int, long);
+
+#endif
+
@@ -0,0 +1,80 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <gmp.h>
+#include <mpfr.h>
+#include <omp.h>
+#include "mpi.h"
+#include "../mpi_operations.h"
+#include "../omp_operations.h"
+#include "../../common/phase_timer.h"
+#include "machin.h"
+
+
+/************************************************************************************
+ * Machin-like formulas implementation                                              *
+ * The arctans are given to groups of processes and summed as fixed point integers  *
+ * with GMP, see gmp/algorithms/machin.c                                            *
+ *                                                                                  *
+ ************************************************************************************/
+
+
+void machin_algorithm_mpfr(MPI_Comm comm, int num_procs, int proc_id, mpfr_t pi, const struct machin_formula *formula, int num_threads, long precision_bits){
+    int group, group_id, group_procs, arctan_groups[MACHIN_ARCTANS];
+    mpfr_t local_proc_pi;
+    MPI_Comm group_comm;
+
+    init_transport_mpfr(local_proc_pi, precision_bits);
+
+    //Every group of processes works on its arctans
+    group = machin_groups(formula, num_procs, proc_id, arctan_groups);
+    MPI_Comm_split(comm, group, proc_id, &group_comm);
+    MPI_Comm_rank(group_comm, &group_id);
+    MPI_Comm_size(group_comm, &group_procs);
+
+    //Set the number of threads 
+    omp_set_num_threads(num_threads);
+
+    #pragma omp parallel
+    {
+        int thread_id, arctan;
+        long first, last;
+        mp_bitcnt_t bits;
+        mpz_t thread_sum, arctan_sum;
+        mpfr_t local_thread_pi;
+
+        thread_id = omp_get_thread_num();
+        mpz_inits(thread_sum, arctan_sum, NULL);
+        mpfr_init2(local_thread_pi, precision_bits);
+
+        mark_phase(SEED_PHASE);
+        //First Phase -> Working on a local fixed point sum of every arctan of the group
+        bits = 0;
+        for (arctan = 0; arctan < MACHIN_ARCTANS; arctan++) {
+            if (arctan_groups[arctan] != group) continue;
+            machin_worker_terms(formula, arctan, precision_bits, group_id * num_threads + thread_id, 
+                                group_procs * num_threads, &first, &last);
+            bits = arctan_fixed_point_sum_gmp(arctan_sum, formula -> denominators[arctan], first, last, precision_bits);
+            if (formula -> coefficients[arctan] > 0) {
+                mpz_addmul_ui(thread_sum, arctan_sum, 4 * formula -> coefficients[arctan]);
+            } else {
+                mpz_submul_ui(thread_sum, arctan_sum, -4 * formula -> coefficients[arctan]);
+            }
+        }
+        mpfr_set_z_2exp(local_thread_pi, thread_sum, - (mpfr_exp_t) bits, MPFR_RNDN);
+
+        //Second Phase -> Accumulate the result in the global variable
+        reduce_threads_mpfr(local_proc_pi, local_thread_pi);
+
+        //Clear memory
+        mpz_clears(thread_sum, arctan_sum, NULL);
+        mpfr_clear(local_thread_pi);
+    }
+
+    //Reduce local_proc_pi in global Pi
+    reduce_add_mpfr(comm, pi, local_proc_pi, proc_id);
+
+    //Clear memory
+    MPI_Comm_free(&group_comm);
+    clear_transport_mpfr(local_proc_pi);
+}
+
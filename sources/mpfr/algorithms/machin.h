@@ -0,0 +1,9 @@
+#ifndef MACHIN_MPFR
+#define MACHIN_MPFR
+
+#include "../../gmp/algorithms/machin.h"
+
+void machin_algorithm_mpfr(MPI_Comm, int, int, mpfr_t, const struct machin_formula *, int, long);
+
+#endif
+
@@ -0,0 +1,209 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <gmp.h>
+#include <mpfr.h>
+#include "mpi.h"
+#include "mpi_operations.h"
+#include "omp_operations.h"
+#include "working_precision.h"
+#include "seeding.h"
+#include "parallel_arithmetic.h"
+#include "algorithms/chudnovsky_rational_blocks.h"
+#include "algorithms/chudnovsky_blocks_and_blocks.h"
+#include "algorithms/bbp_dynamic_and_stealing.h"
+#include "algorithms/bellard_dynamic_and_stealing.h"
+#include "algorithms/chudnovsky_dynamic_and_stealing.h"
+#include "../gmp/scheduler.h"
+#include "../common/options.h"
+#include "../common/phase_timer.h"
+#include "../common/dynamic_scheduler.h"
+#include "../common/backend.h"
+#include "backend.h"
+
+#define B 545140134
+#define C 640320
+#define D 426880
+#define E 10005
+#define BITS_PER_TERM 47.11             // log2(640320^3 / 12^3)
+
+
+/************************************************************************************
+ * MPFR backend of the schedules of common/chudnovsky_schedules.c and               *
+ * common/dynamic_schedules.c                                                       *
+ *                                                                                  *
+ ************************************************************************************
+ * The numbers are mpfr_ptr with the precision bits given by the schedules. The     *
+ * products and divisions of MPFR are done by the same mpn functions as the ones of *
+ * GMP, so the ranges of the non-uniform schedule come from the cost model of       *
+ * gmp/scheduler.c.                                                                 *
+ *                                                                                  *
+ ************************************************************************************/
+
+
+static void * init_number_mpfr(long precision_bits, bool transport){
+    mpfr_ptr number = malloc(sizeof(__mpfr_struct));
+
+    if (transport) {
+        init_transport_mpfr(number, precision_bits);
+    } else {
+        mpfr_init2(number, precision_bits);
+        mpfr_set_ui(number, 0, MPFR_RNDN);
+    }
+    return number;
+}
+
+static void clear_number_mpfr(void *number, bool transport){
+    if (transport) clear_transport_mpfr(number);
+    else mpfr_clear(number);
+    free(number);
+}
+
+static void reduce_threads_backend_mpfr(void *local_proc_pi, void *local_thread_pi){
+    reduce_threads_mpfr(local_proc_pi, local_thread_pi);
+}
+
+static void reduce_processes_mpfr(MPI_Comm comm, void *pi, void *local_proc_pi, int proc_id){
+    reduce_add_mpfr(comm, pi, local_proc_pi, proc_id);
+}
+
+static void div_ui_mpfr(void *x, void *y, unsigned long n){
+    mpfr_div_ui(x, y, n, MPFR_RNDN);
+}
+
+/*
+ * Jumps dep_a from the term current_i to the term next_i
+ */
+static void compute_portion_of_dep_a_mpfr(mpfr_t dep_a, long next_i, long current_i, mpfr_t dividend, mpfr_t divisor){
+    long i, factor_a;
+
+    for (i = current_i + 1; i <= next_i; i++){
+        factor_a = 12 * (i - 1);
+        mpfr_set_ui(dividend, factor_a + 10, MPFR_RNDN);
+        mpfr_mul_ui(dividend, dividend, factor_a + 6, MPFR_RNDN);
+        mpfr_mul_ui(dividend, dividend, factor_a + 2, MPFR_RNDN);
+        mpfr_mul(dep_a, dep_a, dividend, MPFR_RNDN);
+
+        mpfr_set_ui(divisor, i, MPFR_RNDN);
+        mpfr_pow_ui(divisor, divisor, 3, MPFR_RNDN);
+        mpfr_div(dep_a, dep_a, divisor, MPFR_RNDN);
+    }
+}
+
+/*
+ * Adds to local_thread_pi the Chudnovsky terms start, start + step, ... before end
+ */
+static void chudnovsky_terms_mpfr(void *local_thread_pi, long start, long end, long step, long precision_bits){
+    long i, factor_a;
+    mpfr_prec_t working_precision;
+    mpfr_t dep_a, dep_a_dividend, dep_a_divisor, dep_b, dep_c, jump, aux;
+
+    if (start >= end) return;
+    mpfr_inits2(precision_bits, dep_a, dep_b, dep_c, dep_a_dividend, dep_a_divisor, jump, aux, NULL);
+    mpfr_set_si(jump, -C, MPFR_RNDN);
+    mpfr_pow_ui(jump, jump, 3 * step, MPFR_RNDN);             // jump = (-640320)^(3 step)
+    seed_chudnovsky_mpfr(dep_a, dep_b, dep_c, start);
+    factor_a = 12 * start;
+
+    mark_phase(SEED_PHASE);
+    if (step == 1 && options.block_terms > 1) {
+        mpfr_div(dep_a, dep_a, dep_b, MPFR_RNDN);     // x = dep_a / dep_b
+        chudnovsky_rational_blocks_mpfr(local_thread_pi, dep_a, start, end, options.block_terms, precision_bits);
+    } else {
+        for (i = start; i < end; i += step) {
+            //Work with the precision needed by the term i
+            working_precision = working_precision_mpfr(precision_bits, BITS_PER_TERM, i);
+            set_working_precision_mpfr(working_precision, dep_a_dividend, dep_a_divisor, aux, NULL);
+            round_working_precision_mpfr(working_precision, dep_a, dep_b, dep_c, NULL);
+            chudnovsky_iteration_mpfr(local_thread_pi, i, dep_a, dep_b, dep_c, aux);
+            //Update dep_a:
+            if (step == 1) {
+                mpfr_set_ui(dep_a_dividend, factor_a + 10, MPFR_RNDN);
+                mpfr_mul_ui(dep_a_dividend, dep_a_dividend, factor_a + 6, MPFR_RNDN);
+                mpfr_mul_ui(dep_a_dividend, dep_a_dividend, factor_a + 2, MPFR_RNDN);
+                mpfr_mul(dep_a_dividend, dep_a_dividend, dep_a, MPFR_RNDN);
+
+                mpfr_set_ui(dep_a_divisor, i + 1, MPFR_RNDN);
+                mpfr_pow_ui(dep_a_divisor, dep_a_divisor, 3, MPFR_RNDN);
+                mpfr_div(dep_a, dep_a_dividend, dep_a_divisor, MPFR_RNDN);
+                factor_a += 12;
+            } else {
+                compute_portion_of_dep_a_mpfr(dep_a, i + step, i, dep_a_dividend, dep_a_divisor);
+            }
+
+            //Update dep_b:
+            mpfr_mul(dep_b, dep_b, jump, MPFR_RNDN);
+
+            //Update dep_c:
+            mpfr_add_ui(dep_c, dep_c, B * (unsigned long) step, MPFR_RNDN);
+        }
+    }
+
+    mpfr_free_cache();
+    mpfr_clears(dep_a, dep_a_dividend, dep_a_divisor, dep_b, dep_c, jump, aux, NULL);
+}
+
+static void * start_chudnovsky_constant_mpfr(long precision_bits){
+    struct sqrt_constant_mpfr *constant = malloc(sizeof(struct sqrt_constant_mpfr));
+
+    start_sqrt_constant_mpfr(constant, D, E, precision_bits);
+    return constant;
+}
+
+static void finish_chudnovsky_mpfr(void *pi, void *constant, int num_threads){
+    mpfr_t e;
+
+    mpfr_init2(e, mpfr_get_prec(pi));
+    wait_sqrt_constant_mpfr(e, constant);
+    parallel_div_mpfr(pi, e, pi, num_threads);
+    mpfr_clear(e);
+    free(constant);
+}
+
+static long * chudnovsky_schedule_mpfr(MPI_Comm comm, long num_iterations, int num_workers, double *weights, int proc_id, long precision_bits){
+    struct cost_model_gmp model;
+
+    init_cost_model_gmp(&model);
+    if (options.calibrate) {
+        mpf_set_default_prec(precision_bits);       // the divisions of the calibration
+        calibrate_cost_model_gmp(comm, &model, proc_id);
+    }
+    return chudnovsky_schedule_gmp(&model, num_iterations, num_workers, weights, precision_bits);
+}
+
+/*
+ * Adds to local_thread_pi the terms of series of the chunks given to the thread thread_id
+ */
+static void dynamic_terms_mpfr(enum series series, void *local_thread_pi, struct dynamic_scheduler *scheduler, int thread_id, long precision_bits){
+    switch (series)
+    {
+    case BBP_SERIES:
+        bbp_dynamic_terms_mpfr(local_thread_pi, scheduler, thread_id, precision_bits);
+        break;
+    case BELLARD_SERIES:
+        bellard_dynamic_terms_mpfr(local_thread_pi, scheduler, thread_id, precision_bits);
+        break;
+    case CHUDNOVSKY_SERIES:
+        chudnovsky_dynamic_terms_mpfr(local_thread_pi, scheduler, thread_id, precision_bits);
+        break;
+    default:
+        printf("  The series has no dynamic terms in the MPFR backend \n");
+        exit(-1);
+    }
+}
+
+
+struct backend backend_mpfr = {
+    .library = "MPFR",
+    .init_number = init_number_mpfr,
+    .clear_number = clear_number_mpfr,
+    .reduce_threads = reduce_threads_backend_mpfr,
+    .reduce_processes = reduce_processes_mpfr,
+    .div_ui = div_ui_mpfr,
+    .chudnovsky_terms = chudnovsky_terms_mpfr,
+    .start_chudnovsky_constant = start_chudnovsky_constant_mpfr,
+    .finish_chudnovsky = finish_chudnovsky_mpfr,
+    .dynamic_terms = dynamic_terms_mpfr,
+    .chudnovsky_schedule = chudnovsky_schedule_mpfr,
+};
+
@@ -0,0 +1,9 @@
+#ifndef BACKEND_MPFR
+#define BACKEND_MPFR
+
+#include "../common/backend.h"
+
+extern struct backend backend_mpfr;
+
+#endif
+
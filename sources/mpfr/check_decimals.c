@@ -2,35 +2,77 @@
 #include <stdlib.h>
 #include <math.h>
 #include <mpfr.h>
+#include "mpi.h"
+#include "../gmp/radix_conversion.h"
+#include "radix_conversion.h"
+#include "../common/options.h"
+#include "../common/digit_extraction.h"
 
 
-int check_decimals_mpfr(mpfr_t pi){
-    //Cast the number we want to check to string
-    int bytes_of_pi =  ( (int) ceil((float) pi -> _mpfr_prec / (float) GMP_NUMB_BITS) ) * sizeof(mp_limb_t);
-    char calculated_pi[bytes_of_pi * 8]; 
-    mpfr_sprintf(calculated_pi, "%Re", pi);
+long check_decimals_mpfr(mpfr_t pi){
+    long num_decimals, bytes_of_pi, correct_bytes;
+    struct digit_writer writer;
 
-    //Read the correct pi number from numeroPiCorrecto.txt file and compares the decimals to calculated pi
-    FILE * file;
-    file = fopen("resources/numero_pi_correcto.txt", "r");
-    if(file == NULL){
+    //The integer part of pi has one digit, otherwise no decimal is correct
+    if (!mpfr_number_p(pi) || mpfr_sgn(pi) < 0 || mpfr_cmp_ui(pi, 10) >= 0) return 0;
+
+    //Map the correct pi number of numero_pi_correcto.txt file in memory
+    if (!open_reference_file(&writer, "resources/numero_pi_correcto.txt")) {
         printf("numero_pi_correcto.txt not found \n");
         exit(-1);
-    } 
+    }
+
+    //Cast the number we want to check to decimal comparing every block of digits with the correct pi
+    num_decimals = (long) (mpfr_get_prec(pi) * 0.30103) + 1;      // log10(2)
+    if (num_decimals > writer.reference_length) num_decimals = writer.reference_length;
+    bytes_of_pi = write_decimals_mpfr(pi, num_decimals, &writer);
+    correct_bytes = (writer.mismatch < bytes_of_pi) ? writer.mismatch : bytes_of_pi;
+
+    close_reference_file(&writer);
+
+    return (correct_bytes < 2) ? 0 : correct_bytes - 2;
+}
+
+/*
+ * Checks SPOT_HEX_DIGITS hex digits of pi (computed in process 0) at options.spot_checks
+ * positions with the BBP digit extraction. Every process should call it.
+ * It returns the decimals that are correct according to the positions checked.
+ */
+long spot_check_decimals_mpfr(MPI_Comm comm, mpfr_t pi, long precision, int num_procs, int proc_id){
+    int i, num_positions;
+    long decimals;
+    long *positions, shift;
+    unsigned long *digits, *computed_digits;
+    mpfr_exp_t exponent;
+    mpz_t mantissa, aux;
+
+    num_positions = options.spot_checks;
+    positions = malloc(num_positions * sizeof(long));
+    digits = malloc(num_positions * sizeof(unsigned long));
+    computed_digits = malloc(num_positions * sizeof(unsigned long));
+
+    choose_spot_positions(comm, positions, num_positions, precision);
+    compute_spot_digits(comm, positions, digits, num_positions, num_procs, proc_id);
 
-    char correct_pi_char;
-    int i = 0;
-    while((correct_pi_char = fgetc(file)) != EOF){
-        if( (i >= (bytes_of_pi * 8)) || (correct_pi_char != calculated_pi[i])){
-            break;
+    decimals = 0;
+    if (proc_id == 0) {
+        //digits = floor(mantissa 2^(exponent + 4 (position + SPOT_HEX_DIGITS))) mod 16^SPOT_HEX_DIGITS
+        mpz_inits(mantissa, aux, NULL);
+        exponent = mpfr_get_z_2exp(mantissa, pi);
+        for (i = 0; i < num_positions; i++) {
+            shift = exponent + 4 * (positions[i] + SPOT_HEX_DIGITS);
+            if (shift < 0) mpz_fdiv_q_2exp(aux, mantissa, -shift);
+            else mpz_mul_2exp(aux, mantissa, shift);
+            mpz_fdiv_r_2exp(aux, aux, 4 * SPOT_HEX_DIGITS);
+            computed_digits[i] = mpz_get_ui(aux);
         }
-        i++;
+        decimals = spot_check_decimals(positions, digits, computed_digits, num_positions, precision);
+        mpz_clears(mantissa, aux, NULL);
     }
-    i = (i < 2) ? 0: i - 2;
-    
-    fclose(file);
 
-    //mpfr_printf("Pi: %Re \n", pi);
+    free(positions);
+    free(digits);
+    free(computed_digits);
 
-    return i;
-}
\ No newline at end of file
+    return decimals;
+}
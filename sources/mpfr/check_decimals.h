@@ -1,7 +1,8 @@
 #ifndef CHECK_DECIMALS_MPFR
 #define CHECK_DECIMALS_MPFR
 
-int check_decimals_mpfr(mpfr_t pi);
+long check_decimals_mpfr(mpfr_t pi);
+long spot_check_decimals_mpfr(MPI_Comm comm, mpfr_t pi, long precision, int num_procs, int proc_id);
 
 #endif
 
@@ -0,0 +1,54 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <gmp.h>
+#include <mpfr.h>
+#include "../common/checkpoint.h"
+
+
+/*
+ * Saves partial_pi as the state of the thread that continues at next_iteration.
+ * The state is the exponent and the size of the mantissa of partial_pi followed by its limbs.
+ */
+void save_checkpoint_mpfr(struct checkpoint *checkpoint, long next_iteration, mpfr_t partial_pi){
+    size_t num_limbs, state_size;
+    long *state;
+    mpfr_exp_t exponent;
+    mpz_t mantissa;
+
+    mpz_init(mantissa);
+    exponent = mpfr_get_z_2exp(mantissa, partial_pi);
+    num_limbs = mpz_size(mantissa);
+    state_size = 2 * sizeof(long) + num_limbs * sizeof(mp_limb_t);
+    state = malloc(state_size);
+    state[0] = exponent;
+    state[1] = mpz_sgn(mantissa) * (long) num_limbs;
+    memcpy(state + 2, mpz_limbs_read(mantissa), num_limbs * sizeof(mp_limb_t));
+
+    save_checkpoint(checkpoint, next_iteration, state, state_size);
+    free(state);
+    mpz_clear(mantissa);
+}
+
+/*
+ * Restores partial_pi and next_iteration from the checkpoint of the thread.
+ * It returns false (and does not change them) if there is no checkpoint.
+ */
+bool load_checkpoint_mpfr(struct checkpoint *checkpoint, long *next_iteration, mpfr_t partial_pi){
+    size_t state_size;
+    long *state;
+    mpz_t mantissa;
+
+    state = load_checkpoint(checkpoint, next_iteration, &state_size);
+    if (state == NULL) return false;
+
+    mpz_init(mantissa);
+    mpz_import(mantissa, labs(state[1]), -1, sizeof(mp_limb_t), 0, 0, state + 2);
+    if (state[1] < 0) mpz_neg(mantissa, mantissa);
+    mpfr_set_z_2exp(partial_pi, mantissa, state[0], MPFR_RNDN);
+    mpz_clear(mantissa);
+    free(state);
+
+    return true;
+}
+
@@ -0,0 +1,8 @@
+#ifndef CHECKPOINT_MPFR
+#define CHECKPOINT_MPFR
+
+void save_checkpoint_mpfr(struct checkpoint *, long, mpfr_t);
+bool load_checkpoint_mpfr(struct checkpoint *, long *, mpfr_t);
+
+#endif
+
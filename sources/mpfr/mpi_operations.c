@@ -3,66 +3,186 @@
 #include <math.h>
 #include <mpfr.h>
 #include "mpi.h"
+#include "../common/options.h"
+#include "../common/node_reduction.h"
+#include "../common/phase_timer.h"
+#include "../common/large_buffer.h"
+#include "../gmp/mpi_operations.h"
+
+#define SEGMENT_DIGIT_BITS 32
+
+
+/*
+ * Header of the contiguous buffer used to move an mpfr_t through MPI.
+ * The significand is stored right after the header, so the buffer
+ * is sent as it is, without packing the limbs.
+ * The number is stored with the MPFR custom interface: kind holds the sign and
+ * the kind of number (zero, regular, inf, nan) and exp is only valid for regular numbers.
+ */
+struct transport_header_mpfr {
+    mpfr_prec_t prec;
+    int kind;
+    mpfr_exp_t exp;
+};
+
+
+/*
+ * Inits data with precision_bits and value 0 inside a transport buffer,
+ * so it can be reduced without copying its limbs.
+ * IMPORTANT: data should be cleared with clear_transport_mpfr
+ */
+void init_transport_mpfr(mpfr_t data, long precision_bits){
+    char *buffer;
+    void *significand;
+
+    buffer = allocate_large_buffer(sizeof(struct transport_header_mpfr) + mpfr_custom_get_size(precision_bits));
+    significand = buffer + sizeof(struct transport_header_mpfr);
+    mpfr_custom_init(significand, precision_bits);
+    mpfr_custom_init_set(data, MPFR_ZERO_KIND, 0, precision_bits, significand);
+}
 
 /*
- * Pack mpf_t type
- * IMPORTANT: mpf_t data should have been previously initialized
+ * Frees the transport buffer of data
  */
-int pack_mpfr(void * buffer, mpfr_t data){
-    int position, packet_size, d_elements;
-    d_elements = (int) ceil((float) data -> _mpfr_prec / (float) GMP_NUMB_BITS);
-    packet_size = 8 + sizeof(mpfr_exp_t) + (d_elements * sizeof(mp_limb_t));
-    position = 0;
-    MPI_Pack(&data -> _mpfr_prec, 1, MPI_INT, buffer, packet_size, &position, MPI_COMM_WORLD);
-    MPI_Pack(&data -> _mpfr_sign, 1, MPI_INT, buffer, packet_size, &position, MPI_COMM_WORLD);
-    MPI_Pack(&data -> _mpfr_exp, sizeof(mpfr_exp_t), MPI_BYTE, buffer, packet_size, &position, MPI_COMM_WORLD);
-    MPI_Pack( data -> _mpfr_d, d_elements * sizeof(mp_limb_t), MPI_BYTE, buffer, packet_size, &position, MPI_COMM_WORLD);
-    return position;
+void clear_transport_mpfr(mpfr_t data){
+    free_large_buffer((char *) mpfr_custom_get_significand(data) - sizeof(struct transport_header_mpfr));
 }
 
 /*
- * Unpack mpf_t type
- * IMPORTANT: mpf_t data should have been previously initialized
+ * Size in bytes of the transport buffer of data
  */
-void unpack_mpfr(void * buffer, mpfr_t data){
-    int position, packet_size, d_elements;
-    d_elements = (int) ceil((float) data -> _mpfr_prec / (float) GMP_NUMB_BITS);
-    packet_size = 8 + sizeof(mpfr_exp_t) + (d_elements * sizeof(mp_limb_t));
-    position = 0;
-    MPI_Unpack(buffer, packet_size, &position, &data -> _mpfr_prec, 1, MPI_INT, MPI_COMM_WORLD);
-    MPI_Unpack(buffer, packet_size, &position, &data -> _mpfr_sign, 1, MPI_INT, MPI_COMM_WORLD);
-    MPI_Unpack(buffer, packet_size, &position, &data -> _mpfr_exp, sizeof(mpfr_exp_t), MPI_BYTE, MPI_COMM_WORLD);
-    MPI_Unpack(buffer, packet_size, &position,  data -> _mpfr_d, d_elements * sizeof(mp_limb_t) , MPI_BYTE, MPI_COMM_WORLD);
+size_t transport_size_mpfr(mpfr_t data){
+    return sizeof(struct transport_header_mpfr) + mpfr_custom_get_size(mpfr_get_prec(data));
 }
 
+/*
+ * Writes the header of the transport buffer of data and returns the buffer
+ */
+void * transport_buffer_mpfr(mpfr_t data){
+    struct transport_header_mpfr * header;
+    header = (struct transport_header_mpfr *) ((char *) mpfr_custom_get_significand(data) - sizeof(struct transport_header_mpfr));
+    header -> prec = mpfr_get_prec(data);
+    header -> kind = mpfr_custom_get_kind(data);
+    header -> exp = (abs(header -> kind) == MPFR_REGULAR_KIND) ? mpfr_custom_get_exp(data) : 0;
+    return header;
+}
+
+/*
+ * Makes view an mpfr_t whose significand is the one stored in a transport buffer
+ * IMPORTANT: view should not be initialized nor cleared
+ */
+void view_transport_mpfr(mpfr_t view, void * buffer){
+    struct transport_header_mpfr * header = (struct transport_header_mpfr *) buffer;
+    mpfr_custom_init_set(view, header -> kind, header -> exp, header -> prec, (char *) buffer + sizeof(struct transport_header_mpfr));
+}
 
 /*
  * Operation defined for MPI
- * Adds mpf_t types
+ * Adds mpfr_t types stored in transport buffers, working on the limbs in place
  */
 void add_mpfr(void * invec, void * inoutvec, int *len, MPI_Datatype *dtype){
+    int i;
+    MPI_Count element_size;
     mpfr_t a, b;
-    mpfr_inits(a, b, NULL);
-    unpack_mpfr(invec, a);
-    unpack_mpfr(inoutvec, b);
-    mpfr_add(b, b, a, MPFR_RNDN);
-    pack_mpfr(inoutvec, b);
-    mpfr_clears(a, b, NULL);
+    MPI_Type_size_x(*dtype, &element_size);
+    for (i = 0; i < *len; i++) {
+        view_transport_mpfr(a, (char *) invec + (size_t) i * element_size);
+        view_transport_mpfr(b, (char *) inoutvec + (size_t) i * element_size);
+        mpfr_add(b, b, a, MPFR_RNDN);
+        transport_buffer_mpfr(b);
+    }
 }
 
 /*
  * Operation defined for MPI
- * Multiply mpf_t types
+ * Multiply mpfr_t types stored in transport buffers, working on the limbs in place
  */
 void mul_mpfr(void * invec, void * inoutvec, int *len, MPI_Datatype *dtype){
+    int i;
+    MPI_Count element_size;
     mpfr_t a, b;
-    mpfr_inits(a, b, NULL);    
-    unpack_mpfr(invec, a);
-    unpack_mpfr(inoutvec, b);
-    mpfr_mul(b, b, a, MPFR_RNDN);
-    pack_mpfr(inoutvec, b);
-    mpfr_clears(a, b, NULL);
+    MPI_Type_size_x(*dtype, &element_size);
+    for (i = 0; i < *len; i++) {
+        view_transport_mpfr(a, (char *) invec + (size_t) i * element_size);
+        view_transport_mpfr(b, (char *) inoutvec + (size_t) i * element_size);
+        mpfr_mul(b, b, a, MPFR_RNDN);
+        transport_buffer_mpfr(b);
+    }
 }
 
+/*
+ * Segmented version of reduce_add_mpfr.
+ * local_proc_pi is converted to a fixed point number with its precision plus one guard digit
+ * after the point and one digit for the integer part and one digit for the sign.
+ * The fixed point numbers are reduced with segmented_reduce_add_z_gmp.
+ */
+void segmented_reduce_add_mpfr(MPI_Comm comm, mpfr_t pi, mpfr_t local_proc_pi, int proc_id, int num_segments){
+    long fraction_bits, num_digits, shift;
+    mpz_t local, sum;
+
+    fraction_bits = (long) mpfr_get_prec(local_proc_pi) + SEGMENT_DIGIT_BITS;
+    num_digits = (fraction_bits + SEGMENT_DIGIT_BITS - 1) / SEGMENT_DIGIT_BITS + 2;
+
+    mpz_inits(local, sum, NULL);
+    if (!mpfr_zero_p(local_proc_pi)) {
+        shift = mpfr_get_z_2exp(local, local_proc_pi) + fraction_bits;
+        if (shift >= 0) mpz_mul_2exp(local, local, shift);
+        else mpz_tdiv_q_2exp(local, local, -shift);
+    }
+
+    segmented_reduce_add_z_gmp(comm, sum, local, num_digits, num_segments, proc_id);
 
+    if (proc_id == 0){
+        mpfr_set_z_2exp(pi, sum, -fraction_bits, MPFR_RNDN);
+    }
+
+    mpz_clears(local, sum, NULL);
+}
+
+/*
+ * Adds the local_proc_pi of every process and stores the result in pi (process 0).
+ * local_proc_pi should have been initialized with init_transport_mpfr: its buffer
+ * is sent as one contiguous MPI datatype and the reduction works on it in place.
+ * If the -segments option is given the segmented reduction is used instead, and if the
+ * -node_reduce option is given the processes of every node are added in shared memory first.
+ */
+void reduce_add_mpfr(MPI_Comm comm, mpfr_t pi, mpfr_t local_proc_pi, int proc_id){
+    size_t packet_size;
+    void *recbuffer = NULL;
+    mpfr_t result;
+    MPI_Datatype transport_type;
+    MPI_Op add_op;
+
+    mark_phase(THREAD_REDUCE_PHASE);
+    if (options.reduce_segments > 0){
+        segmented_reduce_add_mpfr(comm, pi, local_proc_pi, proc_id, options.reduce_segments);
+        mark_phase(PROC_REDUCE_PHASE);
+        return;
+    }
+
+    //Create user defined datatype and operation
+    packet_size = transport_size_mpfr(local_proc_pi);
+    create_bytes_type(packet_size, &transport_type);
+    MPI_Op_create((MPI_User_function *)add_mpfr, 0, &add_op);
+
+    if (proc_id == 0) recbuffer = allocate_large_buffer(packet_size);
+
+    //Reduce local_proc_pi
+    if (options.node_reduce) {
+        node_reduce(comm, transport_buffer_mpfr(local_proc_pi), recbuffer, transport_type, add_op, (MPI_User_function *)add_mpfr);
+    } else {
+        MPI_Reduce(transport_buffer_mpfr(local_proc_pi), recbuffer, 1, transport_type, add_op, 0, comm);
+    }
+
+    //Copy the result in global Pi
+    if (proc_id == 0){
+        view_transport_mpfr(result, recbuffer);
+        mpfr_set(pi, result, MPFR_RNDN);
+        free_large_buffer(recbuffer);
+    }
+
+    MPI_Op_free(&add_op);
+    MPI_Type_free(&transport_type);
+    mark_phase(PROC_REDUCE_PHASE);
+}
 
@@ -3,7 +3,12 @@
 
 void add_mpfr(void *, void *, int *, MPI_Datatype *);
 void mul_mpfr(void *, void *, int *, MPI_Datatype *);
-int pack_mpfr(void *, mpfr_t);
-void unpack_mpfr(void *, mpfr_t);
+void init_transport_mpfr(mpfr_t, long);
+void clear_transport_mpfr(mpfr_t);
+size_t transport_size_mpfr(mpfr_t);
+void * transport_buffer_mpfr(mpfr_t);
+void view_transport_mpfr(mpfr_t, void *);
+void segmented_reduce_add_mpfr(MPI_Comm, mpfr_t, mpfr_t, int, int);
+void reduce_add_mpfr(MPI_Comm, mpfr_t, mpfr_t, int);
 
 #endif
@@ -0,0 +1,6 @@
+#ifndef OMP_OPERATIONS_MPFR
+#define OMP_OPERATIONS_MPFR
+
+void reduce_threads_mpfr(mpfr_t, mpfr_t);
+
+#endif
@@ -0,0 +1,154 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <gmp.h>
+#include <mpfr.h>
+#include <omp.h>
+#include "../gmp/parallel_arithmetic.h"
+#include "parallel_arithmetic.h"
+
+#define PARALLEL_MUL_BITS 262144        // Minimum precision (in bits) of each factor to split the product
+
+
+/*
+ * result = u * v using num_threads threads.
+ * The mantissas are multiplied as integers with parallel_mpz_mul_gmp.
+ */
+void parallel_mul_mpfr(mpfr_t result, mpfr_t u, mpfr_t v, int num_threads){
+    mpfr_exp_t exponent_u, exponent_v;
+    mpz_t mantissa_u, mantissa_v;
+
+    if (num_threads < 2 || !mpfr_regular_p(u) || !mpfr_regular_p(v) 
+            || mpfr_get_prec(u) < PARALLEL_MUL_BITS || mpfr_get_prec(v) < PARALLEL_MUL_BITS) {
+        mpfr_mul(result, u, v, MPFR_RNDN);
+        return;
+    }
+
+    mpz_inits(mantissa_u, mantissa_v, NULL);
+    exponent_u = mpfr_get_z_2exp(mantissa_u, u);
+    exponent_v = mpfr_get_z_2exp(mantissa_v, v);
+    parallel_mpz_mul_gmp(mantissa_u, mantissa_u, mantissa_v, num_threads);
+    mpfr_set_z_2exp(result, mantissa_u, exponent_u + exponent_v, MPFR_RNDN);
+    mpz_clears(mantissa_u, mantissa_v, NULL);
+}
+
+/*
+ * result = sqrt(x) using num_threads threads in the products.
+ * The inverse square root y = 1/sqrt(x) is refined with the Newton iteration
+ *
+ *      y = y + y (1 - x y^2) / 2
+ *
+ * doubling its precision in every step, and then sqrt(x) = x y.
+ */
+void parallel_sqrt_mpfr(mpfr_t result, mpfr_t x, int num_threads){
+    int num_steps, step;
+    mpfr_prec_t precision, step_precision[64];
+    mpfr_t y, aux, error;
+
+    precision = mpfr_get_prec(result);
+    if (num_threads < 2 || mpfr_sgn(x) <= 0 || precision < 2 * PARALLEL_MUL_BITS) {
+        mpfr_sqrt(result, x, MPFR_RNDN);
+        return;
+    }
+
+    //Precisions of the steps, from the last one to the first one
+    num_steps = 0;
+    while (precision > 128) {
+        step_precision[num_steps++] = precision;
+        precision = precision / 2 + 64;
+    }
+
+    mpfr_inits2(precision, y, aux, error, NULL);
+    mpfr_rec_sqrt(y, x, MPFR_RNDN);
+
+    for (step = num_steps - 1; step >= 0; step--) {
+        mpfr_prec_round(y, step_precision[step], MPFR_RNDN);
+        mpfr_set_prec(aux, step_precision[step]);
+        mpfr_set_prec(error, step_precision[step]);
+        parallel_mul_mpfr(aux, y, y, num_threads);
+        parallel_mul_mpfr(aux, aux, x, num_threads);
+        mpfr_ui_sub(error, 1, aux, MPFR_RNDN);
+        parallel_mul_mpfr(aux, y, error, num_threads);
+        mpfr_div_2ui(aux, aux, 1, MPFR_RNDN);
+        mpfr_add(y, y, aux, MPFR_RNDN);
+    }
+    parallel_mul_mpfr(result, x, y, num_threads);
+
+    mpfr_clears(y, aux, error, NULL);
+}
+
+/*
+ * result = u / v using num_threads threads in the products.
+ * The inverse y = 1/v is refined with the Newton iteration
+ *
+ *      y = y + y (1 - v y)
+ *
+ * doubling its precision in every step, and then u / v = u y.
+ * result may be the same variable as u or v.
+ */
+void parallel_div_mpfr(mpfr_t result, mpfr_t u, mpfr_t v, int num_threads){
+    int num_steps, step;
+    mpfr_prec_t precision, step_precision[64];
+    mpfr_t y, aux, error;
+
+    precision = mpfr_get_prec(result);
+    if (num_threads < 2 || !mpfr_regular_p(u) || !mpfr_regular_p(v) || precision < 2 * PARALLEL_MUL_BITS) {
+        mpfr_div(result, u, v, MPFR_RNDN);
+        return;
+    }
+
+    //Precisions of the steps, from the last one to the first one
+    num_steps = 0;
+    while (precision > 128) {
+        step_precision[num_steps++] = precision;
+        precision = precision / 2 + 64;
+    }
+
+    mpfr_inits2(precision, y, aux, error, NULL);
+    mpfr_ui_div(y, 1, v, MPFR_RNDN);
+
+    for (step = num_steps - 1; step >= 0; step--) {
+        mpfr_prec_round(y, step_precision[step], MPFR_RNDN);
+        mpfr_set_prec(aux, step_precision[step]);
+        mpfr_set_prec(error, step_precision[step]);
+        parallel_mul_mpfr(aux, v, y, num_threads);
+        mpfr_ui_sub(error, 1, aux, MPFR_RNDN);
+        parallel_mul_mpfr(aux, y, error, num_threads);
+        mpfr_add(y, y, aux, MPFR_RNDN);
+    }
+    parallel_mul_mpfr(result, u, y, num_threads);
+
+    mpfr_clears(y, aux, error, NULL);
+}
+
+static void * sqrt_constant_thread_mpfr(void *argument){
+    struct sqrt_constant_mpfr *constant = argument;
+
+    mpfr_sqrt_ui(constant -> value, constant -> radicand, MPFR_RNDN);
+    mpfr_mul_ui(constant -> value, constant -> value, constant -> factor, MPFR_RNDN);
+    mpfr_free_cache();
+    return NULL;
+}
+
+/*
+ * Starts computing factor sqrt(radicand) with precision bits in a new thread,
+ * so it is ready when the series has been summed
+ */
+void start_sqrt_constant_mpfr(struct sqrt_constant_mpfr *constant, unsigned long factor, unsigned long radicand, mpfr_prec_t precision){
+    constant -> factor = factor;
+    constant -> radicand = radicand;
+    mpfr_init2(constant -> value, precision);
+    if (pthread_create(&constant -> thread, NULL, sqrt_constant_thread_mpfr, constant) != 0) {
+        sqrt_constant_thread_mpfr(constant);
+        constant -> thread = pthread_self();
+    }
+}
+
+/*
+ * Waits for the constant started with start_sqrt_constant_mpfr and sets result to it
+ */
+void wait_sqrt_constant_mpfr(mpfr_t result, struct sqrt_constant_mpfr *constant){
+    if (!pthread_equal(constant -> thread, pthread_self())) pthread_join(constant -> thread, NULL);
+    mpfr_set(result, constant -> value, MPFR_RNDN);
+    mpfr_clear(constant -> value);
+}
+
@@ -0,0 +1,20 @@
+#ifndef PARALLEL_ARITHMETIC_MPFR
+#define PARALLEL_ARITHMETIC_MPFR
+
+#include <pthread.h>
+
+struct sqrt_constant_mpfr {
+    pthread_t thread;
+    mpfr_t value;
+    unsigned long factor;
+    unsigned long radicand;
+};
+
+void parallel_mul_mpfr(mpfr_t, mpfr_t, mpfr_t, int);
+void parallel_sqrt_mpfr(mpfr_t, mpfr_t, int);
+void parallel_div_mpfr(mpfr_t, mpfr_t, mpfr_t, int);
+void start_sqrt_constant_mpfr(struct sqrt_constant_mpfr *, unsigned long, unsigned long, mpfr_prec_t);
+void wait_sqrt_constant_mpfr(mpfr_t, struct sqrt_constant_mpfr *);
+
+#endif
+
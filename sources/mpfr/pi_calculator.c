@@ -6,18 +6,48 @@
 #include "mpi.h"
 #include "algorithms/bbp_blocks_and_blocks.h"
 #include "algorithms/bellard_blocks_and_cyclic.h"
+#include "algorithms/bellard_slow_blocks_and_cyclic.h"
 #include "algorithms/chudnovsky_blocks_and_blocks.h"
+#include "algorithms/chudnovsky_binary_splitting.h"
+#include "algorithms/bbp_fixed_point.h"
+#include "algorithms/bellard_fixed_point.h"
+#include "algorithms/gauss_legendre.h"
+#include "algorithms/machin.h"
 #include "check_decimals.h"
+#include "../gmp/radix_conversion.h"
+#include "radix_conversion.h"
 #include "../common/printer.h"
+#include "../common/planner.h"
+#include "../common/options.h"
+#include "../common/phase_timer.h"
+#include "../common/progress.h"
+#include "../common/checkpoint.h"
+#include "../common/sweep.h"
+#include "../common/chudnovsky_schedules.h"
+#include "../common/dynamic_schedules.h"
+#include "backend.h"
+#include "result_dump.h"
 
 
 double gettimeofday();
 
 
-void calculate_pi_mpfr(int num_procs, int proc_id, int algorithm, int precision, int num_threads, bool print_in_csv_format){
+/*
+ * Sets the mpfr float precision (in bits) and inits pi in process 0
+ */
+void init_pi_mpfr(mpfr_t pi, long precision_bits, int proc_id){
+    mpfr_set_default_prec(precision_bits);
+    if (proc_id == 0){
+        mpfr_init_set_ui(pi, 0, MPFR_RNDN);
+    }
+}
+
+
+void calculate_pi_mpfr(MPI_Comm comm, int num_procs, int proc_id, int algorithm, long precision, int num_threads, bool print_in_csv_format, struct run_result *result){
     double execution_time;
     struct timeval t1, t2;
-    int num_iterations, decimals_computed, precision_bits; 
+    long num_iterations, decimals_computed = 0, precision_bits; 
+    struct plan plan;
     mpfr_t pi;    
     char *algorithm_tag;
 
@@ -25,38 +55,206 @@ void calculate_pi_mpfr(int num_procs, int proc_id, int algorithm, int precision,
     if(proc_id == 0){
         gettimeofday(&t1, NULL);
     }
-
-    //Set gmp float precision (in bits) and init pi
-    precision_bits = precision * 8;
-    mpfr_set_default_prec(precision_bits); 
-    if (proc_id == 0){
-        mpfr_init_set_ui(pi, 0, MPFR_RNDN);
-    }
+    init_phase_times(comm, num_threads);
 
     switch (algorithm)
     {
     case 0:
-        num_iterations = precision * 0.84;
-        check_errors(num_procs, precision, num_iterations, num_threads, proc_id);
+        plan = plan_pi(precision, BBP_SERIES);
+        num_iterations = plan.num_iterations;
+        precision_bits = plan.precision_bits;
+        check_errors(comm, num_procs, precision, num_iterations, num_threads, proc_id);
+        start_progress(comm, num_iterations, num_threads, proc_id);
         algorithm_tag = "MPFR-BBP-BLC-BLC";
-        bbp_blocks_and_blocks_algorithm_mpfr(num_procs, proc_id, pi, num_iterations, num_threads, precision_bits);
+        init_pi_mpfr(pi, precision_bits, proc_id);
+        if (!load_cached_pi_mpfr(comm, pi, proc_id)) bbp_blocks_and_blocks_algorithm_mpfr(comm, num_procs, proc_id, pi, num_iterations, num_threads, precision_bits);
         break;
 
     case 1:
-        num_iterations = precision / 3;
-        check_errors(num_procs, precision, num_iterations, num_threads, proc_id);
+        plan = plan_pi(precision, BELLARD_SERIES);
+        num_iterations = plan.num_iterations;
+        precision_bits = plan.precision_bits;
+        check_errors(comm, num_procs, precision, num_iterations, num_threads, proc_id);
+        start_progress(comm, num_iterations, num_threads, proc_id);
         algorithm_tag = "MPFR-BEL-BLC-CYC";
-        bellard_blocks_and_cyclic_algorithm_mpfr(num_procs, proc_id, pi, num_iterations, num_threads, precision_bits);
+        init_pi_mpfr(pi, precision_bits, proc_id);
+        if (!load_cached_pi_mpfr(comm, pi, proc_id)) bellard_blocks_and_cyclic_algorithm_mpfr(comm, num_procs, proc_id, pi, num_iterations, num_threads, precision_bits);
         break;
 
     case 2:
-        num_iterations = (precision + 14 - 1) / 14;  //Division por exceso
-        check_errors(num_procs, precision, num_iterations, num_threads, proc_id);
+        plan = plan_pi(precision, CHUDNOVSKY_SERIES);
+        num_iterations = plan.num_iterations;
+        precision_bits = plan.precision_bits;
+        check_errors(comm, num_procs, precision, num_iterations, num_threads, proc_id);
+        start_progress(comm, num_iterations, num_threads, proc_id);
         algorithm_tag = "MPFR-CHD-SME-BLC-BLC";
-        chudnovsky_blocks_and_blocks_algorithm_mpfr(num_procs, proc_id, pi, num_iterations, num_threads, precision_bits);
+        init_pi_mpfr(pi, precision_bits, proc_id);
+        if (!load_cached_pi_mpfr(comm, pi, proc_id)) chudnovsky_blocks_and_blocks_algorithm_mpfr(comm, num_procs, proc_id, pi, num_iterations, num_threads, precision_bits);
+        break;
+
+    case 3:
+        plan = plan_pi(precision, CHUDNOVSKY_SERIES);
+        num_iterations = plan.num_iterations;
+        precision_bits = plan.precision_bits;
+        check_errors(comm, num_procs, precision, num_iterations, num_threads, proc_id);
+        check_option(comm, options.checkpoint_dir == NULL, "-checkpoint", proc_id);
+        start_progress(comm, num_iterations, num_threads, proc_id);
+        algorithm_tag = "MPFR-CHD-BSP-BLC-BLC";
+        init_pi_mpfr(pi, precision_bits, proc_id);
+        if (!load_cached_pi_mpfr(comm, pi, proc_id)) chudnovsky_binary_splitting_algorithm_mpfr(comm, num_procs, proc_id, pi, num_iterations, num_threads, precision_bits);
+        break;
+
+    case 4:
+        plan = plan_pi(precision, BBP_SERIES);
+        num_iterations = plan.num_iterations;
+        precision_bits = plan.precision_bits;
+        check_errors(comm, num_procs, precision, num_iterations, num_threads, proc_id);
+        check_option(comm, options.checkpoint_dir == NULL, "-checkpoint", proc_id);
+        check_option(comm, !options.decreasing_precision, "-decreasing_precision", proc_id);
+        start_progress(comm, num_iterations, num_threads, proc_id);
+        algorithm_tag = "MPFR-BBP-FXP-CYC-CYC";
+        init_pi_mpfr(pi, precision_bits, proc_id);
+        if (!load_cached_pi_mpfr(comm, pi, proc_id)) bbp_fixed_point_algorithm_mpfr(comm, num_procs, proc_id, pi, num_iterations, num_threads, precision_bits);
+        break;
+
+    case 5:
+        plan = plan_pi(precision, BELLARD_SERIES);
+        num_iterations = plan.num_iterations;
+        precision_bits = plan.precision_bits;
+        check_errors(comm, num_procs, precision, num_iterations, num_threads, proc_id);
+        check_option(comm, options.checkpoint_dir == NULL, "-checkpoint", proc_id);
+        check_option(comm, !options.decreasing_precision, "-decreasing_precision", proc_id);
+        start_progress(comm, num_iterations, num_threads, proc_id);
+        algorithm_tag = "MPFR-BEL-FXP-CYC-CYC";
+        init_pi_mpfr(pi, precision_bits, proc_id);
+        if (!load_cached_pi_mpfr(comm, pi, proc_id)) bellard_fixed_point_algorithm_mpfr(comm, num_procs, proc_id, pi, num_iterations, num_threads, precision_bits);
+        break;
+
+    case 6:
+        plan = plan_pi(precision, GAUSS_LEGENDRE_AGM);
+        num_iterations = plan.num_iterations;
+        precision_bits = plan.precision_bits;
+        check_errors(comm, 1, precision, num_iterations, 1, proc_id);       // only process 0 iterates
+        check_option(comm, options.checkpoint_dir == NULL, "-checkpoint", proc_id);
+        start_progress(comm, num_iterations, num_threads, proc_id);
+        algorithm_tag = "MPFR-GLE-ONE-PML";
+        init_pi_mpfr(pi, precision_bits, proc_id);
+        if (!load_cached_pi_mpfr(comm, pi, proc_id)) gauss_legendre_algorithm_mpfr(comm, num_procs, proc_id, pi, num_iterations, num_threads, precision_bits);
+        break;
+
+    case 7:
+        plan = plan_pi(precision, TAKANO_SERIES);
+        num_iterations = plan.num_iterations;
+        precision_bits = plan.precision_bits;
+        check_errors(comm, num_procs, precision, num_iterations, num_threads, proc_id);
+        check_option(comm, options.checkpoint_dir == NULL, "-checkpoint", proc_id);
+        start_progress(comm, num_iterations, num_threads, proc_id);
+        algorithm_tag = "MPFR-MCH-TAK-GRP-BLC";
+        init_pi_mpfr(pi, precision_bits, proc_id);
+        if (!load_cached_pi_mpfr(comm, pi, proc_id)) machin_algorithm_mpfr(comm, num_procs, proc_id, pi, &takano_formula, num_threads, precision_bits);
+        break;
+
+    case 8:
+        plan = plan_pi(precision, STORMER_SERIES);
+        num_iterations = plan.num_iterations;
+        precision_bits = plan.precision_bits;
+        check_errors(comm, num_procs, precision, num_iterations, num_threads, proc_id);
+        check_option(comm, options.checkpoint_dir == NULL, "-checkpoint", proc_id);
+        start_progress(comm, num_iterations, num_threads, proc_id);
+        algorithm_tag = "MPFR-MCH-STO-GRP-BLC";
+        init_pi_mpfr(pi, precision_bits, proc_id);
+        if (!load_cached_pi_mpfr(comm, pi, proc_id)) machin_algorithm_mpfr(comm, num_procs, proc_id, pi, &stormer_formula, num_threads, precision_bits);
+        break;
+
+    case 9:
+        plan = plan_pi(precision, CHUDNOVSKY_SERIES);
+        num_iterations = plan.num_iterations;
+        precision_bits = plan.precision_bits;
+        check_errors(comm, num_procs, precision, num_iterations, num_threads, proc_id);
+        check_option(comm, options.checkpoint_dir == NULL, "-checkpoint", proc_id);
+        start_progress(comm, num_iterations, num_threads, proc_id);
+        algorithm_tag = "MPFR-CHD-SME-SNK-BLC";
+        init_pi_mpfr(pi, precision_bits, proc_id);
+        if (!load_cached_pi_mpfr(comm, pi, proc_id)) chudnovsky_snake_like_and_blocks_algorithm(&backend_mpfr, comm, num_procs, proc_id, pi, num_iterations, num_threads, precision_bits);
+        break;
+
+    case 10:
+        plan = plan_pi(precision, CHUDNOVSKY_SERIES);
+        num_iterations = plan.num_iterations;
+        precision_bits = plan.precision_bits;
+        check_errors(comm, num_procs, precision, num_iterations, num_threads, proc_id);
+        check_option(comm, options.checkpoint_dir == NULL, "-checkpoint", proc_id);
+        start_progress(comm, num_iterations, num_threads, proc_id);
+        algorithm_tag = "MPFR-CHD-SME-CHT-BLC";
+        init_pi_mpfr(pi, precision_bits, proc_id);
+        if (!load_cached_pi_mpfr(comm, pi, proc_id)) chudnovsky_non_uniform_and_blocks_algorithm(&backend_mpfr, comm, num_procs, proc_id, pi, num_iterations, num_threads, precision_bits);
+        break;
+
+    case 11:
+        plan = plan_pi(precision, CHUDNOVSKY_SERIES);
+        num_iterations = plan.num_iterations;
+        precision_bits = plan.precision_bits;
+        check_errors(comm, num_procs, precision, num_iterations, num_threads, proc_id);
+        check_option(comm, options.checkpoint_dir == NULL, "-checkpoint", proc_id);
+        start_progress(comm, num_iterations, num_threads, proc_id);
+        algorithm_tag = "MPFR-CHD-SME-BLC-CYC";
+        init_pi_mpfr(pi, precision_bits, proc_id);
+        if (!load_cached_pi_mpfr(comm, pi, proc_id)) chudnovsky_blocks_and_cyclic_algorithm(&backend_mpfr, comm, num_procs, proc_id, pi, num_iterations, num_threads, precision_bits);
+        break;
+
+    case 12:
+        plan = plan_pi(precision, BELLARD_SERIES);
+        num_iterations = plan.num_iterations;
+        precision_bits = plan.precision_bits;
+        check_errors(comm, num_procs, precision, num_iterations, num_threads, proc_id);
+        check_option(comm, options.checkpoint_dir == NULL, "-checkpoint", proc_id);
+        start_progress(comm, num_iterations, num_threads, proc_id);
+        algorithm_tag = "MPFR-BEL-SLW-BLC-CYC";
+        init_pi_mpfr(pi, precision_bits, proc_id);
+        if (!load_cached_pi_mpfr(comm, pi, proc_id)) bellard_slow_blocks_and_cyclic_algorithm_mpfr(comm, num_procs, proc_id, pi, num_iterations, num_threads, precision_bits);
+        break;
+
+    case 13:
+        plan = plan_pi(precision, BBP_SERIES);
+        num_iterations = plan.num_iterations;
+        precision_bits = plan.precision_bits;
+        check_errors(comm, num_procs, precision, num_iterations, num_threads, proc_id);
+        check_option(comm, options.checkpoint_dir == NULL, "-checkpoint", proc_id);
+        start_progress(comm, num_iterations, num_threads, proc_id);
+        algorithm_tag = "MPFR-BBP-DYN-STL";
+        init_pi_mpfr(pi, precision_bits, proc_id);
+        if (!load_cached_pi_mpfr(comm, pi, proc_id)) dynamic_and_stealing_algorithm(&backend_mpfr, BBP_SERIES, comm, num_procs, proc_id, pi, num_iterations, num_threads, precision_bits, plan.target_bits);
+        break;
+
+    case 14:
+        plan = plan_pi(precision, BELLARD_SERIES);
+        num_iterations = plan.num_iterations;
+        precision_bits = plan.precision_bits;
+        check_errors(comm, num_procs, precision, num_iterations, num_threads, proc_id);
+        check_option(comm, options.checkpoint_dir == NULL, "-checkpoint", proc_id);
+        start_progress(comm, num_iterations, num_threads, proc_id);
+        algorithm_tag = "MPFR-BEL-DYN-STL";
+        init_pi_mpfr(pi, precision_bits, proc_id);
+        if (!load_cached_pi_mpfr(comm, pi, proc_id)) dynamic_and_stealing_algorithm(&backend_mpfr, BELLARD_SERIES, comm, num_procs, proc_id, pi, num_iterations, num_threads, precision_bits, plan.target_bits);
+        break;
+
+    case 15:
+        plan = plan_pi(precision, CHUDNOVSKY_SERIES);
+        num_iterations = plan.num_iterations;
+        precision_bits = plan.precision_bits;
+        check_errors(comm, num_procs, precision, num_iterations, num_threads, proc_id);
+        check_option(comm, options.checkpoint_dir == NULL, "-checkpoint", proc_id);
+        start_progress(comm, num_iterations, num_threads, proc_id);
+        algorithm_tag = "MPFR-CHD-SME-DYN-STL";
+        init_pi_mpfr(pi, precision_bits, proc_id);
+        if (!load_cached_pi_mpfr(comm, pi, proc_id)) dynamic_and_stealing_algorithm(&backend_mpfr, CHUDNOVSKY_SERIES, comm, num_procs, proc_id, pi, num_iterations, num_threads, precision_bits, plan.target_bits);
         break;
 
     default:
+        if (result != NULL) {
+            result -> available = false;
+            return;
+        }
         if (proc_id == 0){
             printf("  Algorithm number selected not availabe, try with another number. \n");
             printf("\n");
@@ -67,14 +265,30 @@ void calculate_pi_mpfr(int num_procs, int proc_id, int algorithm, int precision,
     }
 
     //Get time, check decimals, free pi and print the results
+    if (proc_id == 0) gettimeofday(&t2, NULL);
+    stop_progress();
+    mark_phase(FINAL_PHASE);
+    gather_phase_times(comm, num_procs, proc_id);
+    if (result != NULL) result -> available = true;
+    if (options.spot_checks > 0) decimals_computed = spot_check_decimals_mpfr(comm, pi, precision, num_procs, proc_id);
     if (proc_id == 0) {  
-        gettimeofday(&t2, NULL);
         execution_time = ((t2.tv_sec - t1.tv_sec) * 1000000u +  t2.tv_usec - t1.tv_usec)/1.e6; 
-        decimals_computed = check_decimals_mpfr(pi);
-        if (print_in_csv_format) { print_results_csv("MPFR", algorithm_tag, precision, num_iterations, num_procs, num_threads, decimals_computed, execution_time); } 
+        if (options.spot_checks == 0) decimals_computed = check_decimals_mpfr(pi);
+        if (result != NULL) { 
+            result -> algorithm_tag = algorithm_tag;
+            result -> num_iterations = num_iterations;
+            result -> decimals_computed = decimals_computed;
+            result -> execution_time = execution_time;
+        }
+        else if (print_in_csv_format) { print_results_csv("MPFR", algorithm_tag, precision, num_iterations, num_procs, num_threads, decimals_computed, execution_time); } 
         else { print_results("MPFR", algorithm_tag, precision, num_iterations, num_procs, num_threads, decimals_computed, execution_time); }
+        if (options.output_file != NULL) write_decimals_file_mpfr(pi, precision, options.output_file);
+        if (options.dump_file != NULL) dump_pi_mpfr(pi, options.dump_file);
+        if (options.cache_dir != NULL && decimals_computed >= precision) cache_pi_mpfr(pi);
+        if (options.phase_report != NULL) write_phase_times_json(options.phase_report, "MPFR", algorithm_tag, precision, execution_time);
         mpfr_clear(pi);
     }
+    remove_checkpoints();        // pi is reduced and checked, the checkpoints of the run are not needed
 
 }
 
@@ -1,7 +1,9 @@
 #ifndef PI_CALCULATOR_MPFR
 #define PI_CALCULATOR_MPFR
 
-void calculate_pi_mpfr(int, int, int, int, int, bool);
+#include "../common/sweep.h"
+
+void calculate_pi_mpfr(MPI_Comm, int, int, int, long, int, bool, struct run_result *);
 
 #endif
 
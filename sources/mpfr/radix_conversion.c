@@ -0,0 +1,47 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <gmp.h>
+#include <mpfr.h>
+#include "../gmp/radix_conversion.h"
+
+
+/*
+ * Writes x (x >= 0) with num_decimals decimals (truncated) using the conversion of GMP.
+ * It returns the number of chars written.
+ */
+long write_decimals_mpfr(mpfr_t x, long num_decimals, struct digit_writer *writer){
+    long length;
+    mpfr_exp_t exponent;
+    mpz_t integer_part, decimals, power;
+
+    mpz_inits(integer_part, decimals, power, NULL);
+
+    // decimals = floor(mantissa 2^exponent 10^num_decimals) mod 10^num_decimals
+    exponent = mpfr_get_z_2exp(decimals, x);
+    mpz_ui_pow_ui(power, 10, num_decimals);
+    mpz_mul(decimals, decimals, power);
+    if (exponent < 0) {
+        mpz_tdiv_q_2exp(decimals, decimals, -exponent);
+    } else {
+        mpz_mul_2exp(decimals, decimals, exponent);
+    }
+    mpz_tdiv_qr(integer_part, decimals, decimals, power);
+
+    length = write_decimals_z_gmp(integer_part, decimals, num_decimals, writer);
+
+    mpz_clears(integer_part, decimals, power, NULL);
+
+    return length;
+}
+
+/*
+ * Writes x with num_decimals decimals in the file path
+ */
+void write_decimals_file_mpfr(mpfr_t x, long num_decimals, char *path){
+    struct digit_writer writer;
+
+    open_digit_file(&writer, path);
+    write_decimals_mpfr(x, num_decimals, &writer);
+    close_digit_file(&writer);
+}
+
@@ -0,0 +1,8 @@
+#ifndef RADIX_CONVERSION_MPFR
+#define RADIX_CONVERSION_MPFR
+
+long write_decimals_mpfr(mpfr_t, long, struct digit_writer *);
+void write_decimals_file_mpfr(mpfr_t, long, char *);
+
+#endif
+
@@ -0,0 +1,59 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <sys/stat.h>
+#include <mpfr.h>
+#include "mpi.h"
+#include "../common/options.h"
+#include "../common/result_dump.h"
+#include "result_dump.h"
+
+
+/*
+ * Writes the binary dump of pi in path (see common/result_dump.c).
+ * pi should be a regular number (not zero, inf or nan).
+ */
+void dump_pi_mpfr(mpfr_t pi, char *path){
+    write_result_dump(path, "MPFR", mpfr_get_prec(pi), mpfr_get_exp(pi), mpfr_sgn(pi), mpfr_custom_get_significand(pi),
+                        mpfr_custom_get_size(mpfr_get_prec(pi)) / sizeof(mp_limb_t));
+}
+
+/*
+ * Sets pi (process 0) from the smallest result of the cache with the same or more
+ * precision, rounded to the precision of pi. Every process should call it.
+ * It returns false if the cache is not used or it has no result for this precision.
+ */
+bool load_cached_pi_mpfr(MPI_Comm comm, mpfr_t pi, int proc_id){
+    int found = 0;
+    char path[4096];
+    mpfr_t cached;
+    struct mapped_result_dump dump;
+
+    if (options.cache_dir == NULL) return false;
+    if (proc_id == 0 && find_cached_result(options.cache_dir, "MPFR", mpfr_get_prec(pi), path, sizeof(path))
+            && map_result_dump(&dump, path, "MPFR", mpfr_custom_get_size(mpfr_get_prec(pi)) / sizeof(mp_limb_t) + 1)) {
+        //Read only view of the checked limbs: the most significant limbs, one more than pi keeps
+        mpfr_custom_init_set(cached, (dump.header.sign < 0) ? -MPFR_REGULAR_KIND : MPFR_REGULAR_KIND, dump.header.exponent,
+                                (dump.used_limbs < dump.header.num_limbs) ? dump.used_limbs * GMP_NUMB_BITS : dump.header.precision_bits,
+                                (mp_limb_t *) dump.limbs + (dump.header.num_limbs - dump.used_limbs));
+        mpfr_set(pi, cached, MPFR_RNDN);
+        unmap_result_dump(&dump);
+        found = 1;
+    }
+    MPI_Bcast(&found, 1, MPI_INT, 0, comm);
+    return found;
+}
+
+/*
+ * Stores pi (process 0) in the cache unless it has a result with the same or more precision
+ */
+void cache_pi_mpfr(mpfr_t pi){
+    char path[4096];
+
+    if (!mpfr_regular_p(pi)) return;
+    if (find_cached_result(options.cache_dir, "MPFR", mpfr_get_prec(pi), path, sizeof(path))) return;
+    mkdir(options.cache_dir, 0755);
+    cache_result_path(options.cache_dir, "MPFR", mpfr_get_prec(pi), path, sizeof(path));
+    dump_pi_mpfr(pi, path);
+}
+
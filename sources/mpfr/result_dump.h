@@ -0,0 +1,11 @@
+#ifndef RESULT_DUMP_MPFR
+#define RESULT_DUMP_MPFR
+
+#include <stdbool.h>
+
+void dump_pi_mpfr(mpfr_t, char *);
+bool load_cached_pi_mpfr(MPI_Comm, mpfr_t, int);
+void cache_pi_mpfr(mpfr_t);
+
+#endif
+
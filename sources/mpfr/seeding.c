@@ -0,0 +1,60 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <gmp.h>
+#include <mpfr.h>
+
+#define A 13591409
+#define B 545140134
+#define C_ODD 10005                     // 640320 = 2^6 * 10005
+
+
+/************************************************************************************
+ * Seeding of the dependencies of the series at an arbitrary iteration n            *
+ * (see gmp/seeding.c for the closed forms).                                        *
+ *                                                                                  *
+ ************************************************************************************/
+
+
+/*
+ * dep_m = (1/16)^n
+ */
+void seed_bbp_mpfr(mpfr_t dep_m, long n){
+    mpfr_set_ui_2exp(dep_m, 1, -4 * (long) n, MPFR_RNDN);
+}
+
+/*
+ * dep_m = (-1)^n / 1024^n
+ */
+void seed_bellard_mpfr(mpfr_t dep_m, long n){
+    mpfr_set_si_2exp(dep_m, (n % 2 != 0) ? -1 : 1, -10 * (long) n, MPFR_RNDN);
+}
+
+/*
+ * dep_a, dep_b and dep_c of the Chudnovsky iteration n
+ */
+void seed_chudnovsky_mpfr(mpfr_t dep_a, mpfr_t dep_b, mpfr_t dep_c, long n){
+    mpz_t binomial, product;
+
+    mpz_inits(binomial, product, NULL);
+
+    //dep_a = binom(6n, 3n) * binom(3n, n) * binom(2n, n)
+    mpz_bin_uiui(product, 6 * (unsigned long) n, 3 * (unsigned long) n);
+    mpz_bin_uiui(binomial, 3 * (unsigned long) n, n);
+    mpz_mul(product, product, binomial);
+    mpz_bin_uiui(binomial, 2 * (unsigned long) n, n);
+    mpz_mul(product, product, binomial);
+    mpfr_set_z(dep_a, product, MPFR_RNDN);
+
+    //dep_b = (-1)^n 10005^3n 2^18n
+    mpz_ui_pow_ui(product, C_ODD, 3 * (unsigned long) n);
+    if (n % 2 != 0) mpz_neg(product, product);
+    mpfr_set_z_2exp(dep_b, product, 18 * (long) n, MPFR_RNDN);
+
+    //dep_c = B n + A
+    mpfr_set_ui(dep_c, B, MPFR_RNDN);
+    mpfr_mul_ui(dep_c, dep_c, n, MPFR_RNDN);
+    mpfr_add_ui(dep_c, dep_c, A, MPFR_RNDN);
+
+    mpz_clears(binomial, product, NULL);
+}
+
@@ -0,0 +1,9 @@
+#ifndef SEEDING_MPFR
+#define SEEDING_MPFR
+
+void seed_bbp_mpfr(mpfr_t, long);
+void seed_bellard_mpfr(mpfr_t, long);
+void seed_chudnovsky_mpfr(mpfr_t, mpfr_t, mpfr_t, long);
+
+#endif
+
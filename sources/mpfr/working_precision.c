@@ -0,0 +1,54 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <mpfr.h>
+#include "../common/options.h"
+
+#define GUARD_BITS 64
+
+
+/*
+ * Precision in bits needed to compute the term n of a series whose terms are
+ * bits_per_term bits smaller each iteration. The error of the term is then below
+ * the error of the full precision sum.
+ * If the -decreasing_precision option is not used it is always the full precision.
+ */
+mpfr_prec_t working_precision_mpfr(mpfr_prec_t precision, double bits_per_term, long n){
+    double bits;
+
+    if (!options.decreasing_precision) return precision;
+    bits = (double) precision + GUARD_BITS - bits_per_term * n;
+    if (bits >= precision) return precision;
+    if (bits < 2 * GUARD_BITS) return 2 * GUARD_BITS;
+    return (mpfr_prec_t) bits;
+}
+
+/*
+ * Sets the precision of a NULL-terminated list of mpfr_t whose values are not needed.
+ * It is used for the auxiliary variables of the terms, which are set in every iteration.
+ */
+void set_working_precision_mpfr(mpfr_prec_t precision, mpfr_ptr x, ...){
+    va_list variables;
+
+    va_start(variables, x);
+    while (x != NULL) {
+        if (mpfr_get_prec(x) != precision) mpfr_set_prec(x, precision);
+        x = va_arg(variables, mpfr_ptr);
+    }
+    va_end(variables);
+}
+
+/*
+ * Rounds a NULL-terminated list of mpfr_t to precision keeping their values.
+ * It is used for the dependencies that are carried from one iteration to the next one.
+ */
+void round_working_precision_mpfr(mpfr_prec_t precision, mpfr_ptr x, ...){
+    va_list variables;
+
+    va_start(variables, x);
+    while (x != NULL) {
+        if (mpfr_get_prec(x) != precision) mpfr_prec_round(x, precision, MPFR_RNDN);
+        x = va_arg(variables, mpfr_ptr);
+    }
+    va_end(variables);
+}
@@ -0,0 +1,8 @@
+#ifndef WORKING_PRECISION_MPFR
+#define WORKING_PRECISION_MPFR
+
+mpfr_prec_t working_precision_mpfr(mpfr_prec_t, double, long);
+void set_working_precision_mpfr(mpfr_prec_t, mpfr_ptr, ...);
+void round_working_precision_mpfr(mpfr_prec_t, mpfr_ptr, ...);
+
+#endif